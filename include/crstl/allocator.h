@@ -31,5 +31,26 @@ crstl_module_export namespace crstl
 		{
 			::operator delete(p);
 		}
+
+		// Alignment must be a power of 2. We allocate enough to round the pointer up and store the original pointer
+		// right before the one we return. Memory from allocate_aligned must be freed with deallocate_aligned
+		crstl_nodiscard void* allocate_aligned(size_type size_bytes, size_type alignment) const crstl_noexcept
+		{
+			crstl_assert((alignment & (alignment - 1)) == 0);
+			alignment = alignment < sizeof(void*) ? sizeof(void*) : alignment;
+
+			void* p = ::operator new(size_bytes + alignment + sizeof(void*));
+			void* aligned_p = (void*)(((uintptr_t)p + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+			((void**)aligned_p)[-1] = p;
+			return aligned_p;
+		}
+
+		void deallocate_aligned(void* p, size_type /*size_bytes*/, size_type /*alignment*/) const crstl_noexcept
+		{
+			if (p)
+			{
+				::operator delete(((void**)p)[-1]);
+			}
+		}
 	};
 };
\ No newline at end of file
@@ -151,6 +151,63 @@ crstl_module_export namespace crstl
 		return (int64_t)crstl_atomic_xor64(target, value);
 	}
 
+	// atomic_load: return the value of the variable pointed by target
+
+	inline int8_t atomic_load(int8_t volatile* target) crstl_noexcept
+	{
+		return (int8_t)crstl_atomic_load8(target);
+	}
+
+	inline int16_t atomic_load(int16_t volatile* target) crstl_noexcept
+	{
+		return (int16_t)crstl_atomic_load16(target);
+	}
+
+	inline int32_t atomic_load(int32_t volatile* target) crstl_noexcept
+	{
+		return (int32_t)crstl_atomic_load32(target);
+	}
+
+	inline int64_t atomic_load(int64_t volatile* target) crstl_noexcept
+	{
+		return (int64_t)crstl_atomic_load64(target);
+	}
+
+	// atomic_compare_exchange: store exchange to variable pointed by target if it is equal to comparand, and return its previous value
+
+	inline int8_t atomic_compare_exchange(int8_t volatile* target, int8_t exchange, int8_t comparand) crstl_noexcept
+	{
+		return (int8_t)crstl_atomic_cmpxchg8(target, exchange, comparand);
+	}
+
+	inline int16_t atomic_compare_exchange(int16_t volatile* target, int16_t exchange, int16_t comparand) crstl_noexcept
+	{
+		return (int16_t)crstl_atomic_cmpxchg16(target, exchange, comparand);
+	}
+
+	inline int32_t atomic_compare_exchange(int32_t volatile* target, int32_t exchange, int32_t comparand) crstl_noexcept
+	{
+		return (int32_t)crstl_atomic_cmpxchg32(target, exchange, comparand);
+	}
+
+	inline int64_t atomic_compare_exchange(int64_t volatile* target, int64_t exchange, int64_t comparand) crstl_noexcept
+	{
+		return (int64_t)crstl_atomic_cmpxchg64(target, exchange, comparand);
+	}
+
+	// atomic_add_relaxed, atomic_load_relaxed: like atomic_add and atomic_load, without ordering any other memory access
+	// around them. Meant for counters that nothing else depends on
+
+	inline int64_t atomic_add_relaxed(int64_t volatile* target, int64_t value) crstl_noexcept
+	{
+		return (int64_t)crstl_atomic_add64_relaxed(target, value);
+	}
+
+	inline int64_t atomic_load_relaxed(int64_t volatile* target) crstl_noexcept
+	{
+		return (int64_t)crstl_atomic_load64_relaxed(target);
+	}
+
 	template<size_t N> struct atomic_type {};
 
 	template<> struct atomic_type<1> { typedef int8_t type; };
@@ -228,6 +285,31 @@ crstl_module_export namespace crstl
 			return m_value;
 		}
 
+		value_type load() const
+		{
+			return (value_type)atomic_load((operation_type*)&m_value);
+		}
+
+		void store(const value_type& value)
+		{
+			atomic_store((operation_type*)&m_value, (operation_type)value);
+		}
+
+		// Store the value and return the previous one
+		value_type exchange(const value_type& value)
+		{
+			return (value_type)atomic_store((operation_type*)&m_value, (operation_type)value);
+		}
+
+		// Store desired if the value is equal to expected. Otherwise load the current value into expected
+		bool compare_exchange(value_type& expected, const value_type& desired)
+		{
+			value_type previous = (value_type)atomic_compare_exchange((operation_type*)&m_value, (operation_type)desired, (operation_type)expected);
+			bool exchanged = previous == expected;
+			expected = previous;
+			return exchanged;
+		}
+
 	private:
 
 		value_type m_value;
@@ -0,0 +1,298 @@
+#pragma once
+
+#include "crstl/atomic.h"
+
+#include "crstl/open_hashmap.h"
+
+#include "crstl/thread.h"
+
+#include "crstl/forward_declarations.h"
+
+// crstl::concurrent_open_hashmap
+//
+// Hashmap that can be shared between threads. Keys are distributed across ShardCount open_hashmaps by the high bits of
+// their hash, and every shard has its own reader-writer spinlock. Threads only contend when they access the same shard,
+// and readers of a shard don't block each other
+//
+// - Iterators and references are never handed out, as they would outlive the lock. Lookups take a visitor that runs
+//   while the shard is locked instead. A visitor must not call back into the same hashmap
+// - The hash is computed once per operation and reused by the shard
+// - size() and empty() lock every shard in turn, so they are only a snapshot if other threads are modifying the hashmap
+//
+
+crstl_module_export namespace crstl
+{
+	// Reader-writer spinlock. A writer first claims the writer bit, which stops new readers from entering, then waits
+	// for the readers inside to leave
+	class concurrent_hashmap_lock
+	{
+	public:
+
+		void lock_shared()
+		{
+			for (uint32_t spin_count = 0; ; ++spin_count)
+			{
+				int32_t state = m_state.load();
+
+				if ((state & kWriterBit) == 0 && m_state.compare_exchange(state, state + 1))
+				{
+					return;
+				}
+
+				backoff(spin_count);
+			}
+		}
+
+		void unlock_shared()
+		{
+			--m_state;
+		}
+
+		void lock()
+		{
+			for (uint32_t spin_count = 0; ; ++spin_count)
+			{
+				int32_t state = m_state.load();
+
+				if ((state & kWriterBit) == 0 && m_state.compare_exchange(state, state | kWriterBit))
+				{
+					break;
+				}
+
+				backoff(spin_count);
+			}
+
+			for (uint32_t spin_count = 0; m_state.load() != kWriterBit; ++spin_count)
+			{
+				backoff(spin_count);
+			}
+		}
+
+		void unlock()
+		{
+			m_state.store(0);
+		}
+
+	private:
+
+		static const int32_t kWriterBit = 1 << 30;
+
+		// Critical sections are a handful of probes, so spin for a while before giving up the timeslice
+		static void backoff(uint32_t spin_count)
+		{
+			if (spin_count >= 64)
+			{
+				crstl::this_thread::yield();
+			}
+		}
+
+		atomic<int32_t> m_state;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator, size_t ShardCount>
+	class concurrent_open_hashmap
+	{
+	public:
+
+		typedef open_hashmap<Key, T, Hasher, Allocator> shard_type;
+		typedef concurrent_open_hashmap                 this_type;
+
+		typedef typename shard_type::key_type       key_type;
+		typedef typename shard_type::value_type     value_type;
+		typedef typename shard_type::key_value_type key_value_type;
+		typedef typename shard_type::size_type      size_type;
+
+		static_assert(ShardCount > 0 && crstl_is_pow2(ShardCount), "Shard count must be a power of 2");
+
+		concurrent_open_hashmap() {}
+
+		crstl_nodiscard
+		static crstl_constexpr size_t shard_count() { return ShardCount; }
+
+		void clear()
+		{
+			for (size_t i = 0; i < ShardCount; ++i)
+			{
+				m_shards[i].lock.lock();
+				m_shards[i].table.clear();
+				m_shards[i].lock.unlock();
+			}
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard size_t count(const KeyType& key) const
+		{
+			const size_t hash_value = shard_type::hash_of(key);
+			const shard& key_shard = get_shard(hash_value);
+
+			key_shard.lock.lock_shared();
+			size_t count = key_shard.table.count_hashed(key, hash_value);
+			key_shard.lock.unlock_shared();
+
+			return count;
+		}
+
+		crstl_nodiscard bool empty() const
+		{
+			return size() == 0;
+		}
+
+		template<typename KeyType>
+		size_t erase(const KeyType& key)
+		{
+			const size_t hash_value = shard_type::hash_of(key);
+			shard& key_shard = get_shard(hash_value);
+
+			key_shard.lock.lock();
+			size_t erased_count = key_shard.table.erase_hashed(key, hash_value);
+			key_shard.lock.unlock();
+
+			return erased_count;
+		}
+
+		// Call visitor(const key_value_type&) with the shard locked for reading if the key exists. Returns whether it did
+		template<typename KeyType, typename Visitor>
+		bool find_and_visit(const KeyType& key, Visitor visitor) const
+		{
+			const size_t hash_value = shard_type::hash_of(key);
+			const shard& key_shard = get_shard(hash_value);
+
+			key_shard.lock.lock_shared();
+
+			typename shard_type::const_iterator iter = key_shard.table.find_hashed(key, hash_value);
+			bool found = iter != key_shard.table.end();
+
+			if (found)
+			{
+				visitor(*iter);
+			}
+
+			key_shard.lock.unlock_shared();
+
+			return found;
+		}
+
+		// Call visitor(const shard_type&) for every shard, with that shard locked for reading
+		template<typename Visitor>
+		void for_each_shard(Visitor visitor) const
+		{
+			for (size_t i = 0; i < ShardCount; ++i)
+			{
+				m_shards[i].lock.lock_shared();
+				visitor(static_cast<const shard_type&>(m_shards[i].table));
+				m_shards[i].lock.unlock_shared();
+			}
+		}
+
+		// Call visitor(shard_type&) for every shard, with that shard locked for writing
+		template<typename Visitor>
+		void for_each_shard(Visitor visitor)
+		{
+			for (size_t i = 0; i < ShardCount; ++i)
+			{
+				m_shards[i].lock.lock();
+				visitor(m_shards[i].table);
+				m_shards[i].lock.unlock();
+			}
+		}
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		// Insert the value if the key doesn't exist. Returns whether it was inserted
+		template<typename ValueType>
+		bool insert(const key_type& key, ValueType&& value)
+		{
+			const size_t hash_value = shard_type::hash_of(key);
+			shard& key_shard = get_shard(hash_value);
+
+			key_shard.lock.lock();
+			bool inserted = key_shard.table.emplace_hashed(key, hash_value, crstl_forward(ValueType, value)).second;
+			key_shard.lock.unlock();
+
+			return inserted;
+		}
+
+		// Insert the value, or assign it if the key exists. Returns whether it was inserted
+		template<typename ValueType>
+		bool insert_or_assign(const key_type& key, ValueType&& value)
+		{
+			const size_t hash_value = shard_type::hash_of(key);
+			shard& key_shard = get_shard(hash_value);
+
+			key_shard.lock.lock();
+
+			// Look up first so that the value is forwarded once, to either the assignment or the insertion
+			typename shard_type::iterator iter = key_shard.table.find_hashed(key, hash_value);
+			const bool inserted = iter == key_shard.table.end();
+
+			if (inserted)
+			{
+				key_shard.table.emplace_hashed(key, hash_value, crstl_forward(ValueType, value));
+			}
+			else
+			{
+				iter->second = crstl_forward(ValueType, value);
+			}
+
+			key_shard.lock.unlock();
+
+			return inserted;
+		}
+
+#endif
+
+		crstl_nodiscard size_t size() const
+		{
+			size_t size = 0;
+
+			for (size_t i = 0; i < ShardCount; ++i)
+			{
+				m_shards[i].lock.lock_shared();
+				size += m_shards[i].table.size();
+				m_shards[i].lock.unlock_shared();
+			}
+
+			return size;
+		}
+
+	private:
+
+		// Keep every shard on its own cache line so that locking one doesn't slow down threads working on its neighbors
+		struct crstl_alignas(64) shard
+		{
+			mutable concurrent_hashmap_lock lock;
+
+			shard_type table;
+		};
+
+		// The shard takes the top bits of the hash mixed with a different constant than the one the buckets use. Taking
+		// the same bits as the buckets would mean every key in a shard shares the top bits of its bucket index
+		static size_t compute_shard(size_t hash_value)
+		{
+			const int shard_bits = crstl::countr_zero(ShardCount);
+
+			crstl_constexpr_if(ShardCount == 1)
+			{
+				return 0;
+			}
+			else crstl_constexpr_if(sizeof(size_t) == 8)
+			{
+				return (size_t)(((uint64_t)hash_value * 0xbf58476d1ce4e5b9ull) >> (64 - shard_bits));
+			}
+			else
+			{
+				return (size_t)(((uint32_t)hash_value * 0x85ebca6bu) >> (32 - shard_bits));
+			}
+		}
+
+		shard& get_shard(size_t hash_value) { return m_shards[compute_shard(hash_value)]; }
+
+		const shard& get_shard(size_t hash_value) const { return m_shards[compute_shard(hash_value)]; }
+
+		concurrent_open_hashmap(const concurrent_open_hashmap& other) crstl_constructor_delete;
+
+		concurrent_open_hashmap& operator = (const concurrent_open_hashmap& other) crstl_constructor_delete;
+
+		shard m_shards[ShardCount];
+	};
+};
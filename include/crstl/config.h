@@ -367,4 +367,27 @@
 	#define crstl_has_builtin(x) __has_builtin(x)
 #else
 	#define crstl_has_builtin(x) 0
+#endif
+
+// Hint that the cache line containing address is going to be read soon. It never faults, so it's safe to pass any address
+#if defined(CRSTL_COMPILER_CLANG) || defined(CRSTL_COMPILER_GCC)
+
+	#define crstl_prefetch(address) __builtin_prefetch((const void*)(address))
+
+#elif defined(CRSTL_COMPILER_MSVC) && defined(CRSTL_ARCH_X86)
+
+	extern "C" void _mm_prefetch(char const* address, int hint);
+
+	#define crstl_prefetch(address) _mm_prefetch((const char*)(address), 1 /* _MM_HINT_T0 */)
+
+#elif defined(CRSTL_COMPILER_MSVC) && defined(CRSTL_ARCH_ARM)
+
+	extern "C" void __prefetch(const void* address);
+
+	#define crstl_prefetch(address) __prefetch((const void*)(address))
+
+#else
+
+	#define crstl_prefetch(address) (void)(address)
+
 #endif
\ No newline at end of file
@@ -0,0 +1,323 @@
+#pragma once
+
+#include "crstl/open_hashtable_base.h"
+
+#include "crstl/forward_declarations.h"
+
+#if defined(CRSTL_MODULE_DECLARATION)
+import <initializer_list>;
+#elif defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+#include <initializer_list>
+#endif
+
+// crstl::constexpr_hashmap
+//
+// Read-only hashmap for key sets known up front, such as keyword or opcode tables. The constructor builds a perfect hash
+// with hash and displace, so from C++14 a constexpr table is built entirely at compile time. In C++11 it is built when
+// the table is constructed
+//
+// - Keys are split into buckets by their hash. Buckets are placed largest first, and each one tries displacements until
+//   all its keys land in free nodes. Buckets with a single key store the index of their node instead
+// - A lookup hashes the key once, reads the displacement of its bucket and compares the one node it points to. There is
+//   no probing
+// - The table is minimal when NodeCount is the number of keys. Repeated keys keep the first value, like insert would
+// - The Hasher and the key comparison must be usable in constant expressions to build the table at compile time
+// - Building needs a few arrays of NodeCount on the stack, which suits tables of up to a few thousand keys
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Key, typename T>
+	struct constexpr_hashmap_node
+	{
+		crstl_constexpr constexpr_hashmap_node() : key_value(), valid(false) {}
+
+		crstl_constexpr const Key& get_key() const { return key_value.first; }
+
+		crstl_constexpr bool is_valid() const { return valid; }
+
+		crstl::pair<Key, T> key_value;
+
+		bool valid;
+	};
+
+	template<typename Key, typename T, size_t NodeCount, typename Hasher>
+	class constexpr_hashmap
+	{
+	public:
+
+		static_assert(NodeCount >= 1, "Must have at least one node");
+		static_assert(NodeCount < 0x80000000u, "Node indices must fit in a displacement");
+
+		typedef Key                                                   key_type;
+		typedef T                                                     value_type;
+		typedef size_t                                                size_type;
+		typedef Hasher                                                hasher;
+		typedef constexpr_hashmap_node<key_type, value_type>          node_type;
+		typedef decltype(node_type::key_value)                        key_value_type;
+		typedef open_iterator<key_type, value_type, true, node_type>  const_iterator;
+		typedef const_iterator                                        iterator;
+
+		crstl_constexpr14 constexpr_hashmap(const key_value_type* key_values, size_t key_value_count) crstl_noexcept
+			: m_data(), m_displacements(), m_length(0)
+		{
+			build(key_values, key_value_count);
+		}
+
+#if defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+
+		crstl_constexpr14 constexpr_hashmap(std::initializer_list<key_value_type> ilist) crstl_noexcept
+			: m_data(), m_displacements(), m_length(0)
+		{
+			build(ilist.begin(), ilist.size());
+		}
+
+#endif
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator begin() const crstl_noexcept
+		{
+			const node_type* node = m_data;
+
+			while (node != m_data + NodeCount && !node->is_valid())
+			{
+				++node;
+			}
+
+			return const_iterator(m_data, m_data + NodeCount, (node_type*)node);
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cbegin() const crstl_noexcept { return begin(); }
+
+		template<typename KeyType>
+		crstl_nodiscard crstl_constexpr14 size_t count(const KeyType& key) const crstl_noexcept
+		{
+			return find_impl(key, hash_of(key)) != NodeCount ? 1 : 0;
+		}
+
+		crstl_constexpr bool empty() const { return m_length == 0; }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator end() const { return const_iterator(m_data, m_data + NodeCount, (node_type*)(m_data + NodeCount)); }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator cend() const { return end(); }
+
+		template<typename KeyType>
+		crstl_nodiscard crstl_constexpr14 const_iterator find(const KeyType& key) const crstl_noexcept
+		{
+			return find_hashed(key, hash_of(key));
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard crstl_constexpr14 const_iterator find_hashed(const KeyType& key, size_t hash_value) const crstl_noexcept
+		{
+			const size_t node_index = find_impl(key, hash_value);
+			return node_index != NodeCount ? const_iterator(m_data, m_data + NodeCount, (node_type*)(m_data + node_index)) : end();
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard
+		static crstl_constexpr14 size_t hash_of(const KeyType& key)
+		{
+			return hashmap_hash_selector<hasher, key_type>::hash(key);
+		}
+
+		crstl_nodiscard
+		crstl_constexpr size_t max_size() const { return NodeCount; }
+
+		crstl_nodiscard
+		crstl_constexpr size_t size() const { return m_length; }
+
+	private:
+
+		enum : size_t
+		{
+			// Two keys per bucket on average keeps the displacement search short and the table small
+			kBucketCount = NodeCount / 2 + 1
+		};
+
+		enum : uint32_t
+		{
+			kDirectBit = 0x80000000u,
+			kMaxDisplacement = 1u << 20
+		};
+
+		// Full avalanche of the hash, as integer hashes are often the identity and both the bucket and the node are taken
+		// from the top bits
+		static crstl_constexpr14 uint64_t mix(uint64_t value)
+		{
+			value = (value ^ (value >> 32)) * 0xd6e8feb86659fd93ull;
+			value = (value ^ (value >> 32)) * 0xd6e8feb86659fd93ull;
+			return value ^ (value >> 32);
+		}
+
+		// Maps the top 32 bits of the value to [0, range) with a multiply instead of a modulo
+		static crstl_constexpr size_t reduce(uint64_t value, size_t range)
+		{
+			return (size_t)(((value >> 32) * (uint64_t)range) >> 32);
+		}
+
+		static crstl_constexpr size_t compute_bucket(uint64_t mixed_hash)
+		{
+			return reduce(mixed_hash, kBucketCount);
+		}
+
+		static crstl_constexpr14 size_t compute_node(uint64_t mixed_hash, uint32_t displacement)
+		{
+			return reduce(mix(mixed_hash + displacement * 0x9e3779b97f4a7c15ull), NodeCount);
+		}
+
+		// Returns the index of the node with the key, or NodeCount if there isn't one
+		template<typename KeyType>
+		crstl_constexpr14 size_t find_impl(const KeyType& key, size_t hash_value) const
+		{
+			const uint64_t mixed_hash = mix(hash_value);
+			const uint32_t displacement = m_displacements[compute_bucket(mixed_hash)];
+
+			const size_t node_index = (displacement & kDirectBit) ?
+				(size_t)(displacement & ~kDirectBit) :
+				compute_node(mixed_hash, displacement);
+
+			return m_data[node_index].is_valid() && m_data[node_index].get_key() == key ? node_index : NodeCount;
+		}
+
+		crstl_constexpr14 void build(const key_value_type* key_values, size_t key_value_count)
+		{
+			crstl_assert_msg(key_value_count <= NodeCount, "Too many keys for the node count");
+			key_value_count = key_value_count < NodeCount ? key_value_count : NodeCount;
+
+			uint64_t mixed_hashes[NodeCount] = {};
+			size_t bucket_starts[kBucketCount + 1] = {};
+			size_t bucket_sizes[kBucketCount] = {};
+			size_t bucket_keys[NodeCount] = {};
+			size_t bucket_nodes[NodeCount] = {};
+
+			// Sort the keys by bucket, leaving out repeated keys
+			for (size_t i = 0; i < key_value_count; ++i)
+			{
+				mixed_hashes[i] = mix(hash_of(key_values[i].first));
+				++bucket_starts[compute_bucket(mixed_hashes[i]) + 1];
+			}
+
+			for (size_t b = 0; b < kBucketCount; ++b)
+			{
+				bucket_starts[b + 1] += bucket_starts[b];
+			}
+
+			size_t max_bucket_size = 0;
+
+			for (size_t i = 0; i < key_value_count; ++i)
+			{
+				const size_t b = compute_bucket(mixed_hashes[i]);
+				const size_t first_key = bucket_starts[b];
+
+				bool is_repeated = false;
+
+				for (size_t k = 0; k < bucket_sizes[b] && !is_repeated; ++k)
+				{
+					is_repeated = mixed_hashes[bucket_keys[first_key + k]] == mixed_hashes[i] && key_values[bucket_keys[first_key + k]].first == key_values[i].first;
+				}
+
+				if (!is_repeated)
+				{
+					bucket_keys[bucket_starts[b] + bucket_sizes[b]] = i;
+					++bucket_sizes[b];
+					max_bucket_size = bucket_sizes[b] > max_bucket_size ? bucket_sizes[b] : max_bucket_size;
+				}
+			}
+
+			// Place the largest buckets first, while most nodes are still free. A node is taken as soon as a key lands on
+			// it so that keys of the same bucket can't land on the same node either, and is released if the bucket fails
+			for (size_t bucket_size = max_bucket_size; bucket_size >= 2; --bucket_size)
+			{
+				for (size_t b = 0; b < kBucketCount; ++b)
+				{
+					if (bucket_sizes[b] != bucket_size)
+					{
+						continue;
+					}
+
+					const size_t first_key = bucket_starts[b];
+
+					bool is_placed = false;
+
+					for (uint32_t displacement = 0; displacement < kMaxDisplacement && !is_placed; ++displacement)
+					{
+						size_t placed_count = 0;
+
+						for (; placed_count < bucket_size; ++placed_count)
+						{
+							const size_t node_index = compute_node(mixed_hashes[bucket_keys[first_key + placed_count]], displacement);
+
+							if (m_data[node_index].valid)
+							{
+								break;
+							}
+
+							m_data[node_index].valid = true;
+							bucket_nodes[placed_count] = node_index;
+						}
+
+						is_placed = placed_count == bucket_size;
+
+						if (is_placed)
+						{
+							m_displacements[b] = displacement;
+						}
+						else
+						{
+							for (size_t k = 0; k < placed_count; ++k)
+							{
+								m_data[bucket_nodes[k]].valid = false;
+							}
+						}
+					}
+
+					// Only keys with the same full hash can't be told apart by any displacement
+					crstl_assert_msg(is_placed, "Keys have the same hash");
+
+					if (is_placed)
+					{
+						for (size_t k = 0; k < bucket_size; ++k)
+						{
+							m_data[bucket_nodes[k]].key_value.first = key_values[bucket_keys[first_key + k]].first;
+							m_data[bucket_nodes[k]].key_value.second = key_values[bucket_keys[first_key + k]].second;
+						}
+
+						m_length += bucket_size;
+					}
+				}
+			}
+
+			// Single keys go straight into the remaining nodes
+			size_t free_node = 0;
+
+			for (size_t b = 0; b < kBucketCount; ++b)
+			{
+				if (bucket_sizes[b] == 1)
+				{
+					while (m_data[free_node].valid)
+					{
+						++free_node;
+					}
+
+					const size_t key_index = bucket_keys[bucket_starts[b]];
+
+					m_data[free_node].key_value.first = key_values[key_index].first;
+					m_data[free_node].key_value.second = key_values[key_index].second;
+					m_data[free_node].valid = true;
+					m_displacements[b] = (uint32_t)free_node | kDirectBit;
+					++m_length;
+				}
+			}
+		}
+
+		node_type m_data[NodeCount];
+
+		uint32_t m_displacements[kBucketCount];
+
+		size_t m_length;
+	};
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include "crstl/open_group_hashtable_base.h"
+
+#include "crstl/forward_declarations.h"
+#include "crstl/utility/memory_ops.h"
+
+#if defined(CRSTL_MODULE_DECLARATION)
+import <initializer_list>;
+#elif defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+#include <initializer_list>
+#endif
+
+// crstl::fixed_open_group_hashmap
+//
+// Fixed version of open_group_hashmap. The node count is rounded up to a multiple of the group width (16)
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Key, typename T, size_t NodeCount, typename Hasher>
+	class fixed_open_group_hashtable_storage
+	{
+	public:
+
+		typedef Key                                                        key_type;
+		typedef T                                                          value_type;
+		typedef size_t                                                     size_type;
+		typedef Hasher                                                     hasher;
+		typedef open_group_iterator<key_type, value_type, false>           iterator;
+		typedef open_group_iterator<key_type, value_type, true>            const_iterator;
+		typedef open_group_node<key_type, value_type>                      node_type;
+		typedef decltype(open_group_node<key_type, value_type>::key_value) key_value_type;
+
+		static const size_t kGroupCount = (NodeCount + hashmap_group::kWidth - 1) / hashmap_group::kWidth;
+		static const size_t kNodeCount  = kGroupCount * hashmap_group::kWidth;
+
+		fixed_open_group_hashtable_storage() : m_length(0), m_growth_left(kNodeCount) {}
+
+		~fixed_open_group_hashtable_storage() {}
+
+		template<typename HashmapType>
+		crstl_constexpr14 void reallocate_rehash_if_no_growth_left(HashmapType)
+		{
+			crstl_assert(m_length < kNodeCount);
+		}
+
+		template<typename HashmapType>
+		crstl_constexpr14 void reallocate_rehash_if_length_above_capacity(size_t capacity, HashmapType)
+		{
+			crstl_unused(capacity);
+			crstl_assert(capacity <= kNodeCount);
+		}
+
+		crstl_constexpr14 size_t compute_group(size_t h1) const
+		{
+			return crstl::compute_bucket<kGroupCount>(h1);
+		}
+
+		crstl_constexpr14 size_t get_bucket_count() const { return kNodeCount; }
+
+		crstl_constexpr14 size_t get_group_count() const { return kGroupCount; }
+
+		// We can fill every slot of a fixed hashmap, probing is bounded by the group count
+		crstl_constexpr14 void reset_growth_left() { m_growth_left = kNodeCount; }
+
+	protected:
+
+		crstl_alignas(16) int8_t m_ctrl[kNodeCount];
+
+		crstl_warning_anonymous_struct_union_begin
+		union
+		{
+			struct { node_type m_data[kNodeCount]; };
+		};
+		crstl_warning_anonymous_struct_union_end
+
+		size_t m_length;
+
+		size_t m_growth_left;
+	};
+
+	template<typename Key, typename T, size_t NodeCount, typename Hasher, bool IsMultipleValue>
+	class fixed_open_group_hashtable : public open_group_hashtable_base<fixed_open_group_hashtable_storage<Key, T, NodeCount, Hasher>, IsMultipleValue>
+	{
+	public:
+
+		static_assert(NodeCount >= 1, "Must have at least one node");
+
+		typedef open_group_hashtable_base<fixed_open_group_hashtable_storage<Key, T, NodeCount, Hasher>, IsMultipleValue> base_type;
+
+		typedef typename base_type::key_type       key_type;
+		typedef typename base_type::value_type     value_type;
+		typedef typename base_type::key_value_type key_value_type;
+		typedef typename base_type::size_type      size_type;
+		typedef typename base_type::iterator       iterator;
+		typedef typename base_type::const_iterator const_iterator;
+		typedef typename base_type::node_type      node_type;
+
+		using base_type::clear;
+
+		crstl_constexpr14 fixed_open_group_hashtable() crstl_noexcept : base_type()
+		{
+			memory_set(m_ctrl, hashmap_ctrl::empty, sizeof(m_ctrl));
+		}
+
+		crstl_constexpr14 fixed_open_group_hashtable(const fixed_open_group_hashtable& other) crstl_noexcept : fixed_open_group_hashtable()
+		{
+			for (const key_value_type& iter : other)
+			{
+				insert_empty_impl(iter);
+			}
+		}
+
+#if defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+
+		crstl_constexpr14 fixed_open_group_hashtable(std::initializer_list<key_value_type> ilist) crstl_noexcept : fixed_open_group_hashtable()
+		{
+			crstl_assert(ilist.size() <= base_type::kNodeCount);
+
+			for (const key_value_type& iter : ilist)
+			{
+				insert_empty_impl(iter);
+			}
+		}
+
+#endif
+
+		~fixed_open_group_hashtable() crstl_noexcept
+		{
+			// Only destroy the value, no need to destroy buckets or nodes
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				for (const key_value_type& iter : *this)
+				{
+					iter.~key_value_type();
+				}
+			}
+		}
+
+		crstl_constexpr14 fixed_open_group_hashtable& operator = (const fixed_open_group_hashtable& other)
+		{
+			clear();
+
+			for (const key_value_type& iter : other)
+			{
+				insert_empty_impl(iter);
+			}
+
+			return *this;
+		}
+
+	private:
+
+		using base_type::insert_empty_impl;
+
+		using base_type::m_ctrl;
+		using base_type::m_data;
+		using base_type::m_length;
+	};
+
+	template<typename Key, typename T, size_t NodeCount, typename Hasher>
+	class fixed_open_group_hashmap : public fixed_open_group_hashtable<Key, T, NodeCount, Hasher, false>
+	{
+		using fixed_open_group_hashtable<Key, T, NodeCount, Hasher, false>::fixed_open_group_hashtable;
+	};
+
+	template<typename Key, size_t NodeCount, typename Hasher>
+	class fixed_open_group_hashset : public fixed_open_group_hashtable<Key, void, NodeCount, Hasher, false>
+	{
+		using fixed_open_group_hashtable<Key, void, NodeCount, Hasher, false>::fixed_open_group_hashtable;
+
+	private:
+
+		using fixed_open_group_hashtable<Key, void, NodeCount, Hasher, false>::for_each;
+	};
+
+	template<typename Key, typename T, size_t NodeCount, typename Hasher>
+	class fixed_open_group_multi_hashmap : public fixed_open_group_hashtable<Key, T, NodeCount, Hasher, true>
+	{
+		using fixed_open_group_hashtable<Key, T, NodeCount, Hasher, true>::fixed_open_group_hashtable;
+	};
+
+	template<typename Key, size_t NodeCount, typename Hasher>
+	class fixed_open_group_multi_hashset : public fixed_open_group_hashtable<Key, void, NodeCount, Hasher, true>
+	{
+		using fixed_open_group_hashtable<Key, void, NodeCount, Hasher, true>::fixed_open_group_hashtable;
+
+	private:
+
+		using fixed_open_group_hashtable<Key, void, NodeCount, Hasher, true>::for_each;
+	};
+};
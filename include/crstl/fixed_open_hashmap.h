@@ -2,6 +2,8 @@
 
 #include "crstl/open_hashtable_base.h"
 
+#include "crstl/utility/memory_ops.h"
+
 #include "crstl/forward_declarations.h"
 
 #if defined(CRSTL_MODULE_DECLARATION)
@@ -12,6 +14,41 @@ import <initializer_list>;
 
 crstl_module_export namespace crstl
 {
+	// Header of a saved fixed open hashtable. The table object follows it byte for byte, so a table can be used
+	// straight from memory, e.g. a mapped file, without rebuilding it. The layout is
+	//
+	// [fixed_open_hashtable_header, 64 bytes][node_type m_data[NodeCount]][size_t m_length][padding to sizeof(table)]
+	//
+	// - Fields use the byte order of the machine that saved the table, and a table saved on a machine with a different
+	//   byte order fails the magic check
+	// - The version changes whenever the node layout, the hash functions or the bucket mapping change, as any of those
+	//   moves keys to a different bucket
+	// - The hasher is not recorded. Saving and viewing need the same Hasher, and it must not depend on the process
+	// - Padding and empty nodes are saved as zeros. Keys and values are copied as they are, including any padding of
+	//   their own
+	struct fixed_open_hashtable_header
+	{
+		enum : uint32_t
+		{
+			kMagic = 0x54485243, // "CRHT"
+			kVersion = 1
+		};
+
+		uint32_t magic;
+		uint32_t version;
+		uint32_t header_size;
+		uint32_t size_t_size;
+		uint64_t table_size;
+		uint64_t node_size;
+		uint64_t node_count;
+		uint64_t length;
+		uint32_t key_size;
+		uint32_t key_value_size;
+		uint32_t reserved[2];
+	};
+
+	static_assert(sizeof(fixed_open_hashtable_header) == 64, "Header must keep the table aligned to a cache line");
+
 	template<typename Key, typename T, size_t NodeCount, typename Hasher>
 	class fixed_open_hashtable_storage
 	{
@@ -136,8 +173,202 @@ crstl_module_export namespace crstl
 			return *this;
 		}
 
+		// Write the header and the table as described in fixed_open_hashtable_header. FileType is crstl::file or anything
+		// else with a size_t write(const void*, size_t) function. Returns whether everything was written
+		template<typename FileType>
+		bool save(FileType& file) const
+		{
+			static_assert(is_serializable, "Keys and values must be trivially copyable to be saved");
+
+			fixed_open_hashtable_header header = make_header();
+			header.length = m_length;
+
+			if (file.write(&header, sizeof(header)) != sizeof(header))
+			{
+				return false;
+			}
+
+			// Copy the fields one by one rather than the object, so that padding and empty nodes are saved as zeros
+			// instead of whatever the memory held. The same table always saves to the same bytes
+			table_image_writer<FileType> writer(file);
+
+			for (size_t i = 0; i < NodeCount; ++i)
+			{
+				const node_type& node = m_data[i];
+				writer.write(offset_in_table(&node.meta), &node.meta, sizeof(node.meta));
+
+				if (node.is_valid())
+				{
+					writer.write(offset_in_table(&node.get_key()), &node.get_key(), sizeof(key_type));
+					save_value(writer, node);
+				}
+			}
+
+			writer.write(offset_in_table(&m_length), &m_length, sizeof(m_length));
+
+			return writer.finish(sizeof(fixed_open_hashtable));
+		}
+
+		// Number of bytes save() writes
+		crstl_nodiscard
+		static crstl_constexpr size_t saved_size()
+		{
+			return sizeof(fixed_open_hashtable_header) + sizeof(fixed_open_hashtable);
+		}
+
+		// Use a table written by save() in place. Nothing is copied, so the memory must outlive the returned table, which
+		// is read only. Returns nullptr if the memory is not aligned for the table or the header doesn't match this type
+		crstl_nodiscard
+		static const fixed_open_hashtable* view_from_memory(const void* memory, size_t memory_size)
+		{
+			static_assert(is_serializable, "Keys and values must be trivially copyable to be viewed");
+			static_assert(crstl_alignof(fixed_open_hashtable) <= sizeof(fixed_open_hashtable_header), "Table would be misaligned");
+
+			if (memory == nullptr || memory_size < saved_size() || ((uintptr_t)memory % crstl_alignof(fixed_open_hashtable)) != 0)
+			{
+				return nullptr;
+			}
+
+			const fixed_open_hashtable_header& header = *static_cast<const fixed_open_hashtable_header*>(memory);
+			const fixed_open_hashtable_header expected = make_header();
+
+			if (header.magic != expected.magic || header.version != expected.version ||
+				header.header_size != expected.header_size || header.size_t_size != expected.size_t_size ||
+				header.table_size != expected.table_size || header.node_size != expected.node_size ||
+				header.node_count != expected.node_count || header.key_size != expected.key_size ||
+				header.key_value_size != expected.key_value_size || header.length > NodeCount)
+			{
+				return nullptr;
+			}
+
+			const fixed_open_hashtable* table = reinterpret_cast<const fixed_open_hashtable*>(static_cast<const char*>(memory) + sizeof(header));
+
+			if (table->m_length != header.length)
+			{
+				return nullptr;
+			}
+
+			return table;
+		}
+
 	private:
 
+		// Writes the table through a buffer, filling the bytes that aren't written explicitly with zeros. Offsets must
+		// increase with every write
+		template<typename FileType>
+		struct table_image_writer
+		{
+			table_image_writer(FileType& file) : file(file), offset(0), buffered(0), success(true) {}
+
+			void write(size_t target_offset, const void* source, size_t size)
+			{
+				crstl_assert(target_offset >= offset);
+				fill_zero(target_offset - offset);
+
+				const char* source_bytes = static_cast<const char*>(source);
+
+				while (size > 0)
+				{
+					size_t copied = size < kBufferSize - buffered ? size : kBufferSize - buffered;
+					memory_copy(buffer + buffered, source_bytes, copied);
+					advance(copied);
+					source_bytes += copied;
+					size -= copied;
+				}
+			}
+
+			bool finish(size_t total_size)
+			{
+				crstl_assert(total_size >= offset);
+				fill_zero(total_size - offset);
+				flush();
+				return success;
+			}
+
+		private:
+
+			enum : size_t
+			{
+				kBufferSize = 4096
+			};
+
+			void fill_zero(size_t size)
+			{
+				while (size > 0)
+				{
+					size_t zeroed = size < kBufferSize - buffered ? size : kBufferSize - buffered;
+					memory_set(buffer + buffered, 0, zeroed);
+					advance(zeroed);
+					size -= zeroed;
+				}
+			}
+
+			void advance(size_t size)
+			{
+				offset += size;
+				buffered += size;
+
+				if (buffered == kBufferSize)
+				{
+					flush();
+				}
+			}
+
+			void flush()
+			{
+				success = success && file.write(buffer, buffered) == buffered;
+				buffered = 0;
+			}
+
+			FileType& file;
+
+			size_t offset;
+
+			size_t buffered;
+
+			bool success;
+
+			char buffer[kBufferSize];
+		};
+
+		size_t offset_in_table(const void* field) const
+		{
+			return (size_t)(static_cast<const char*>(field) - reinterpret_cast<const char*>(this));
+		}
+
+		template<typename Writer, typename KeyType, typename ValueType>
+		void save_value(Writer& writer, const open_node<KeyType, ValueType>& node) const
+		{
+			writer.write(offset_in_table(&node.key_value.second), &node.key_value.second, sizeof(ValueType));
+		}
+
+		// Sets have no value
+		template<typename Writer, typename KeyType>
+		void save_value(Writer&, const open_node<KeyType, void>&) const {}
+
+		// Sets store no value, so check the key in its place
+		typedef typename crstl::conditional<crstl::is_void<value_type>::value, key_type, value_type>::type serialized_value_type;
+
+		static const bool is_serializable = crstl_is_trivially_copyable(key_type) && crstl_is_trivially_copyable(serialized_value_type);
+
+		static fixed_open_hashtable_header make_header()
+		{
+			fixed_open_hashtable_header header;
+			header.magic          = fixed_open_hashtable_header::kMagic;
+			header.version        = fixed_open_hashtable_header::kVersion;
+			header.header_size    = sizeof(fixed_open_hashtable_header);
+			header.size_t_size    = sizeof(size_t);
+			header.table_size     = sizeof(fixed_open_hashtable);
+			header.node_size      = sizeof(node_type);
+			header.node_count     = NodeCount;
+			header.length         = 0;
+			header.key_size       = sizeof(key_type);
+			header.key_value_size = sizeof(key_value_type);
+			header.reserved[0]    = 0;
+			header.reserved[1]    = 0;
+			return header;
+		}
+
 		using base_type::insert_empty_impl;
 
 		using base_type::m_data;
@@ -920,6 +920,16 @@ crstl_module_export namespace crstl
 		crstl_constexpr bool operator >  (const basic_fixed_string& string) const crstl_noexcept { return compare(string) >  0; }
 		crstl_constexpr bool operator >= (const basic_fixed_string& string) const crstl_noexcept { return compare(string) >= 0; }
 
+		// Comparisons against other string types without converting them, used by heterogeneous hashmap lookups
+		crstl_constexpr bool operator == (const basic_string_view<CharT>& string) const crstl_noexcept { return compare(string.data(), string.length()) == 0; }
+		crstl_constexpr bool operator != (const basic_string_view<CharT>& string) const crstl_noexcept { return compare(string.data(), string.length()) != 0; }
+
+		template<typename Allocator>
+		crstl_constexpr bool operator == (const basic_string<CharT, Allocator>& string) const crstl_noexcept { return compare(string.data(), string.length()) == 0; }
+
+		template<typename Allocator>
+		crstl_constexpr bool operator != (const basic_string<CharT, Allocator>& string) const crstl_noexcept { return compare(string.data(), string.length()) != 0; }
+
 		CharT m_data[NumElements];
 
 		length_type m_length;
@@ -973,11 +983,5 @@ crstl_module_export namespace crstl
 	template<typename T> struct hash;
 
 	template <typename T, int N>
-	struct hash<basic_fixed_string<T, N>>
-	{
-		size_t operator()(const basic_fixed_string<T, N>& string) const
-		{
-			return string_hash(string.c_str(), string.length());
-		}
-	};
+	struct hash<basic_fixed_string<T, N>> : transparent_string_hash<T> {};
 }
\ No newline at end of file
@@ -23,6 +23,12 @@ namespace crstl
 	// bitset.h
 	template<size_t N, typename WordType = size_t> class bitset;
 
+	// concurrent_open_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator, size_t ShardCount = 64> class concurrent_open_hashmap;
+
+	// constexpr_hashmap.h
+	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class constexpr_hashmap;
+
 	// deque.h
 	template<typename T, typename Allocator = crstl::allocator, size_t ChunkSize = 16> class deque;
 
@@ -41,6 +47,18 @@ namespace crstl
 	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_multi_hashmap;
 	template<typename Key, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_multi_hashset;
 
+	// fixed_open_group_hashmap.h
+	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_group_hashmap;
+	template<typename Key, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_group_hashset;
+	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_group_multi_hashmap;
+	template<typename Key, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_group_multi_hashset;
+
+	// fixed_open_robin_hashmap.h
+	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_robin_hashmap;
+	template<typename Key, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_robin_hashset;
+	template<typename Key, typename T, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_robin_multi_hashmap;
+	template<typename Key, size_t NodeCount, typename Hasher = crstl::hash<Key>> class fixed_open_robin_multi_hashset;
+
 	// fixed_string.h
 	template<typename T, int N> class basic_fixed_string;
 
@@ -70,18 +88,45 @@ namespace crstl
 	// intrusive_ptr.h
 	template<typename T> class intrusive_ptr;
 
+	// lru_cache.h
+	template<typename Key, typename T, size_t Capacity, typename Hasher = crstl::hash<Key>> class fixed_lru_cache;
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class lru_cache;
+
 	// open_hashmap.h
 	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_hashmap;
 	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_hashset;
 	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_multi_hashmap;
 	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_multi_hashset;
 
+	// open_dense_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_dense_hashmap;
+
+	// open_group_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_group_hashmap;
+	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_group_hashset;
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_group_multi_hashmap;
+	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_group_multi_hashset;
+
+	// open_incremental_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_incremental_hashmap;
+	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_incremental_hashset;
+
+	// open_robin_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_robin_hashmap;
+	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_robin_hashset;
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_robin_multi_hashmap;
+	template<typename Key, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator> class open_robin_multi_hashset;
+
 	// pair.h
 	template<typename T1, typename T2> class pair;
 
 	// process.h
 	class process;
 
+	// snapshot_hashmap.h
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator, size_t MaxReaders = 64> class snapshot_hashmap;
+	template<typename Key, typename T, typename Hasher = crstl::hash<Key>, typename Allocator = crstl::allocator, size_t MaxReaders = 64> class snapshot_hashmap_reader;
+
 	// span.h
 	static const size_t dynamic_extent = size_t(-1);
 	template<typename T, size_t Size = dynamic_extent> class span;
@@ -127,6 +172,8 @@ namespace crstl
 
 using crstl::array;
 using crstl::bitset;
+using crstl::concurrent_open_hashmap;
+using crstl::constexpr_hashmap;
 using crstl::deque;
 using crstl::file;
 using crstl::fixed_deque;
@@ -135,6 +182,14 @@ using crstl::fixed_open_hashmap;
 using crstl::fixed_open_hashset;
 using crstl::fixed_open_multi_hashmap;
 using crstl::fixed_open_multi_hashset;
+using crstl::fixed_open_group_hashmap;
+using crstl::fixed_open_group_hashset;
+using crstl::fixed_open_group_multi_hashmap;
+using crstl::fixed_open_group_multi_hashset;
+using crstl::fixed_open_robin_hashmap;
+using crstl::fixed_open_robin_hashset;
+using crstl::fixed_open_robin_multi_hashmap;
+using crstl::fixed_open_robin_multi_hashset;
 
 using crstl::fixed_string8;
 using crstl::fixed_string16;
@@ -158,16 +213,35 @@ using crstl::fixed_wstring2048;
 
 using crstl::fixed_vector;
 using crstl::intrusive_ptr;
+using crstl::fixed_lru_cache;
+using crstl::lru_cache;
 
 using crstl::open_hashmap;
 using crstl::open_hashset;
 using crstl::open_multi_hashmap;
 using crstl::open_multi_hashset;
 
+using crstl::open_dense_hashmap;
+using crstl::open_group_hashmap;
+using crstl::open_group_hashset;
+using crstl::open_group_multi_hashmap;
+using crstl::open_group_multi_hashset;
+
+using crstl::open_incremental_hashmap;
+using crstl::open_incremental_hashset;
+
+using crstl::open_robin_hashmap;
+using crstl::open_robin_hashset;
+using crstl::open_robin_multi_hashmap;
+using crstl::open_robin_multi_hashset;
+
 using crstl::pair;
 
 using crstl::process;
 
+using crstl::snapshot_hashmap;
+using crstl::snapshot_hashmap_reader;
+
 using crstl::span;
 
 using crstl::stack_vector;
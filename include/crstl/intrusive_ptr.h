@@ -162,16 +162,16 @@ crstl_module_export namespace crstl
 	{
 	public:
 
+		// Return the result of the atomic operation itself. Reading the counter again afterwards could see another thread's
+		// change, and two threads releasing at the same time could both see 0
 		int32_t add_ref()
 		{
-			m_refcount++;
-			return m_refcount;
+			return ++m_refcount;
 		}
 
 		int32_t release_ref()
 		{
-			m_refcount--;
-			return m_refcount;
+			return --m_refcount;
 		}
 
 		int32_t get_ref() const
@@ -0,0 +1,426 @@
+#pragma once
+
+#include "crstl/fixed_function.h"
+
+#include "crstl/fixed_open_hashmap.h"
+
+#include "crstl/open_hashmap.h"
+
+#include "crstl/forward_declarations.h"
+
+// crstl::lru_cache
+//
+// Cache that holds up to a given number of key-values. Once full, putting a new key evicts the least recently used one
+//
+// - Key-values live in an array of entries, linked by index into a list ordered by use. An open hashmap maps keys to
+//   the index of their entry. Nodes of the hashmap move when other nodes are erased or rehashed, so the list can't be
+//   threaded through them
+// - get() and put() move the entry to the front of the list, peek() leaves it where it is. All of them are O(1)
+// - fixed_lru_cache keeps the entries and the hashmap inline. lru_cache allocates them on construction, sized for its
+//   capacity, and doesn't allocate again
+// - The evict function is called with the key-value before it is destroyed, either to make room or through evict(). The
+//   key is no longer in the cache by then, so both the key and the value can be moved out. It is not called by erase()
+//   or clear(), and must not call back into the cache
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Key, typename T>
+	struct lru_cache_entry
+	{
+		crstl::pair<Key, T> key_value;
+
+		uint32_t previous;
+
+		uint32_t next;
+	};
+
+	template<typename Key, typename T, size_t Capacity, typename Hasher>
+	class fixed_lru_cache_storage
+	{
+	public:
+
+		typedef Key                                       key_type;
+		typedef T                                         value_type;
+		typedef lru_cache_entry<Key, T>                   entry_type;
+
+		// Keep the load factor of the hashmap around 2/3 when the cache is full
+		typedef fixed_open_hashmap<Key, uint32_t, Capacity + Capacity / 2 + 1, Hasher> hashmap_type;
+
+		static_assert(Capacity >= 1, "Must have at least one entry");
+		static_assert(Capacity < 0xffffffffu, "Entry indices must fit in 32 bits");
+
+		fixed_lru_cache_storage() {}
+
+		~fixed_lru_cache_storage() {}
+
+		crstl_constexpr size_t get_capacity() const { return Capacity; }
+
+	protected:
+
+		crstl_warning_anonymous_struct_union_begin
+		union
+		{
+			struct { entry_type m_entries[Capacity]; };
+		};
+		crstl_warning_anonymous_struct_union_end
+
+		hashmap_type m_hashmap;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class lru_cache_storage
+	{
+	public:
+
+		typedef Key                                            key_type;
+		typedef T                                              value_type;
+		typedef lru_cache_entry<Key, T>                        entry_type;
+		typedef open_hashmap<Key, uint32_t, Hasher, Allocator> hashmap_type;
+
+		explicit lru_cache_storage(size_t capacity) : m_capacity(capacity)
+		{
+			crstl_assert(capacity >= 1 && capacity < 0xffffffffu);
+			m_entries = (entry_type*)m_allocator.allocate(capacity * sizeof(entry_type));
+
+			// Make room for every key up front so that the hashmap never rehashes
+			m_hashmap.rehash((size_t)((float)capacity / m_hashmap.max_load_factor()) + 1);
+		}
+
+		~lru_cache_storage()
+		{
+			m_allocator.deallocate(m_entries, m_capacity * sizeof(entry_type));
+		}
+
+		size_t get_capacity() const { return m_capacity; }
+
+	protected:
+
+		entry_type* m_entries;
+
+		size_t m_capacity;
+
+		hashmap_type m_hashmap;
+
+		Allocator m_allocator;
+	};
+
+	template<typename Storage>
+	class lru_cache_base : public Storage
+	{
+	public:
+
+		typedef Storage                                  storage_type;
+		typedef typename Storage::key_type               key_type;
+		typedef typename Storage::value_type             value_type;
+		typedef typename Storage::entry_type             entry_type;
+		typedef typename Storage::hashmap_type           hashmap_type;
+		typedef decltype(entry_type::key_value)          key_value_type;
+		typedef fixed_function<32, void(key_value_type&)> evict_function;
+
+		using storage_type::get_capacity;
+
+		~lru_cache_base()
+		{
+			clear();
+		}
+
+		crstl_nodiscard
+		size_t capacity() const { return get_capacity(); }
+
+		void clear()
+		{
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				for (uint32_t index = m_head; index != kInvalidIndex; index = m_entries[index].next)
+				{
+					m_entries[index].key_value.~key_value_type();
+				}
+			}
+
+			m_hashmap.clear();
+			m_head = kInvalidIndex;
+			m_tail = kInvalidIndex;
+			m_free = kInvalidIndex;
+			m_used_count = 0;
+			m_length = 0;
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard size_t count(const KeyType& key) const
+		{
+			return m_hashmap.count(key);
+		}
+
+		crstl_nodiscard
+		bool empty() const { return m_length == 0; }
+
+		template<typename KeyType>
+		size_t erase(const KeyType& key)
+		{
+			typename hashmap_type::iterator iter = m_hashmap.find(key);
+
+			if (iter == m_hashmap.end())
+			{
+				return 0;
+			}
+
+			const uint32_t index = iter->second;
+			m_hashmap.erase(iter);
+			unlink(index);
+
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				m_entries[index].key_value.~key_value_type();
+			}
+
+			m_length--;
+			release_entry(index);
+			return 1;
+		}
+
+		// Evict the least recently used key-value. Returns whether there was one
+		bool evict()
+		{
+			if (m_tail == kInvalidIndex)
+			{
+				return false;
+			}
+
+			release_entry(evict_tail());
+			return true;
+		}
+
+		// Call function(const key_value_type&) for every key-value, from the most to the least recently used
+		template<typename Function>
+		void for_each(Function function) const
+		{
+			for (uint32_t index = m_head; index != kInvalidIndex; index = m_entries[index].next)
+			{
+				function((const key_value_type&)m_entries[index].key_value);
+			}
+		}
+
+		// Returns the value and marks it as the most recently used, or nullptr if the key isn't cached
+		template<typename KeyType>
+		crstl_nodiscard value_type* get(const KeyType& key)
+		{
+			typename hashmap_type::iterator iter = m_hashmap.find(key);
+
+			if (iter == m_hashmap.end())
+			{
+				return nullptr;
+			}
+
+			const uint32_t index = iter->second;
+
+			if (index != m_head)
+			{
+				unlink(index);
+				link_front(index);
+			}
+
+			return &m_entries[index].key_value.second;
+		}
+
+		// Returns the value without changing the order of use, or nullptr if the key isn't cached
+		template<typename KeyType>
+		crstl_nodiscard const value_type* peek(const KeyType& key) const
+		{
+			typename hashmap_type::const_iterator iter = m_hashmap.find(key);
+			return iter != m_hashmap.cend() ? &m_entries[iter->second].key_value.second : nullptr;
+		}
+
+		// Insert the value, or assign it if the key is cached, and mark it as the most recently used. Evicts the least
+		// recently used key-value if the cache is full
+		template<typename ValueType>
+		value_type& put(const key_type& key, ValueType&& value)
+		{
+			const size_t hash_value = hashmap_type::hash_of(key);
+			typename hashmap_type::iterator iter = m_hashmap.find_hashed(key, hash_value);
+
+			if (iter != m_hashmap.end())
+			{
+				const uint32_t index = iter->second;
+				m_entries[index].key_value.second = crstl_forward(ValueType, value);
+
+				if (index != m_head)
+				{
+					unlink(index);
+					link_front(index);
+				}
+
+				return m_entries[index].key_value.second;
+			}
+
+			// Evicting erases from the hashmap, so it has to happen before we insert
+			const uint32_t index = acquire_entry();
+			crstl_placement_new((void*)&m_entries[index].key_value) key_value_type(key, crstl_forward(ValueType, value));
+			m_hashmap.emplace_hashed(key, hash_value, index);
+			link_front(index);
+			m_length++;
+
+			return m_entries[index].key_value.second;
+		}
+
+		void set_evict_function(const evict_function& function)
+		{
+			m_evict_function = function;
+		}
+
+		crstl_nodiscard
+		size_t size() const { return m_length; }
+
+	protected:
+
+		template<typename... Args>
+		lru_cache_base(Args&&... args)
+			: Storage(crstl_forward(Args, args)...)
+			, m_head(kInvalidIndex)
+			, m_tail(kInvalidIndex)
+			, m_free(kInvalidIndex)
+			, m_used_count(0)
+			, m_length(0)
+		{
+		}
+
+	private:
+
+		enum : uint32_t
+		{
+			kInvalidIndex = 0xffffffffu
+		};
+
+		using storage_type::m_entries;
+		using storage_type::m_hashmap;
+
+		// Take a free entry, then one that was never used, and evict the least recently used one when there are none
+		uint32_t acquire_entry()
+		{
+			if (m_free != kInvalidIndex)
+			{
+				const uint32_t index = m_free;
+				m_free = m_entries[index].next;
+				return index;
+			}
+			else if (m_used_count < get_capacity())
+			{
+				return m_used_count++;
+			}
+			else
+			{
+				return evict_tail();
+			}
+		}
+
+		// Destroys the key-value and returns the index of the entry, which is left unlinked
+		uint32_t evict_tail()
+		{
+			const uint32_t index = m_tail;
+			key_value_type& key_value = m_entries[index].key_value;
+
+			// Erase first, the evict function is free to move the key out
+			m_hashmap.erase(key_value.first);
+			unlink(index);
+
+			if (m_evict_function)
+			{
+				m_evict_function(key_value);
+			}
+
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				key_value.~key_value_type();
+			}
+
+			m_length--;
+
+			return index;
+		}
+
+		void release_entry(uint32_t index)
+		{
+			m_entries[index].next = m_free;
+			m_free = index;
+		}
+
+		void link_front(uint32_t index)
+		{
+			entry_type& entry = m_entries[index];
+			entry.previous = kInvalidIndex;
+			entry.next = m_head;
+
+			if (m_head != kInvalidIndex)
+			{
+				m_entries[m_head].previous = index;
+			}
+			else
+			{
+				m_tail = index;
+			}
+
+			m_head = index;
+		}
+
+		void unlink(uint32_t index)
+		{
+			entry_type& entry = m_entries[index];
+
+			if (entry.previous != kInvalidIndex)
+			{
+				m_entries[entry.previous].next = entry.next;
+			}
+			else
+			{
+				m_head = entry.next;
+			}
+
+			if (entry.next != kInvalidIndex)
+			{
+				m_entries[entry.next].previous = entry.previous;
+			}
+			else
+			{
+				m_tail = entry.previous;
+			}
+		}
+
+		lru_cache_base(const lru_cache_base& other) crstl_constructor_delete;
+
+		lru_cache_base& operator = (const lru_cache_base& other) crstl_constructor_delete;
+
+		// Most recently used entry
+		uint32_t m_head;
+
+		// Least recently used entry
+		uint32_t m_tail;
+
+		// Entries that were erased, linked through next
+		uint32_t m_free;
+
+		// Entries below this index have been used at some point
+		uint32_t m_used_count;
+
+		size_t m_length;
+
+		evict_function m_evict_function;
+	};
+
+	template<typename Key, typename T, size_t Capacity, typename Hasher>
+	class fixed_lru_cache : public lru_cache_base<fixed_lru_cache_storage<Key, T, Capacity, Hasher>>
+	{
+	public:
+
+		fixed_lru_cache() {}
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class lru_cache : public lru_cache_base<lru_cache_storage<Key, T, Hasher, Allocator>>
+	{
+	public:
+
+		typedef lru_cache_base<lru_cache_storage<Key, T, Hasher, Allocator>> base_type;
+
+		explicit lru_cache(size_t capacity) : base_type(capacity) {}
+	};
+};
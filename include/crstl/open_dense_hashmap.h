@@ -0,0 +1,631 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/allocator.h"
+#include "crstl/bit.h"
+#include "crstl/compressed_pair.h"
+#include "crstl/hash.h"
+#include "crstl/move_forward.h"
+#include "crstl/pair.h"
+#include "crstl/vector.h"
+#include "crstl/utility/hashmap_common.h"
+
+#include "crstl/forward_declarations.h"
+
+#if defined(CRSTL_MODULE_DECLARATION)
+import <initializer_list>;
+#elif defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+#include <initializer_list>
+#endif
+
+// crstl::open_dense_hashmap
+//
+// Hashmap that keeps its key/value pairs packed in a vector. The probe table only holds 32 bits of the hash and the index
+// of the pair, so probing touches 8 bytes per bucket however large the pairs are, and iterating walks the vector instead
+// of every bucket
+//
+// - Buckets are computed from the stored hash bits, so growing the probe table never touches or hashes the keys
+// - Erasing moves the last pair into the hole, like vector::erase_fast. Erasing through an iterator returns the same
+//   position, which now holds the pair that was last, so erase loops visit every pair
+// - Inserting can reallocate the vector, which invalidates iterators and references to any pair
+// - Holds up to 2^32 - 1 pairs
+//
+
+crstl_module_export namespace crstl
+{
+	struct open_dense_slot
+	{
+		static const uint32_t kEmptyIndex = 0xffffffffu;
+
+		bool is_empty() const { return index == kEmptyIndex; }
+
+		uint32_t hash;
+
+		uint32_t index;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_dense_hashmap
+	{
+	public:
+
+		typedef open_dense_hashmap                          this_type;
+		typedef Key                                         key_type;
+		typedef T                                           value_type;
+		typedef size_t                                      size_type;
+		typedef Hasher                                      hasher;
+		typedef crstl::pair<key_type, value_type>           key_value_type;
+		typedef crstl::vector<key_value_type, Allocator>    vector_type;
+		typedef typename vector_type::iterator              iterator;
+		typedef typename vector_type::const_iterator        const_iterator;
+		typedef open_dense_slot                             slot_type;
+
+		crstl_constexpr14 open_dense_hashmap() crstl_noexcept
+			: m_slots(&m_dummy)
+			, m_length_threshold(0)
+			, m_bucket_count(1) // Need this to work with m_dummy
+			, m_bucket_bits(0)
+			, m_max_load_factor(0.75f)
+			, m_capacity_allocator()
+		{
+			m_dummy.hash = 0;
+			m_dummy.index = slot_type::kEmptyIndex;
+		}
+
+		crstl_constexpr14 open_dense_hashmap(size_t initial_length) crstl_noexcept : open_dense_hashmap()
+		{
+			reserve(initial_length);
+		}
+
+		crstl_constexpr14 open_dense_hashmap(const open_dense_hashmap& other) crstl_noexcept : open_dense_hashmap()
+		{
+			copy_from(other);
+		}
+
+		crstl_constexpr14 open_dense_hashmap(open_dense_hashmap&& other) crstl_noexcept : open_dense_hashmap()
+		{
+			move_from(other);
+		}
+
+#if defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+
+		crstl_constexpr14 open_dense_hashmap(std::initializer_list<key_value_type> ilist) crstl_noexcept : open_dense_hashmap((size_t)ilist.size())
+		{
+			for (const key_value_type& iter : ilist)
+			{
+				insert(iter.first, iter.second);
+			}
+		}
+
+#endif
+
+		~open_dense_hashmap() crstl_noexcept
+		{
+			deallocate_internal();
+		}
+
+		crstl_constexpr14 open_dense_hashmap& operator = (const open_dense_hashmap& other)
+		{
+			crstl_assert(this != &other);
+			copy_from(other);
+			return *this;
+		}
+
+		crstl_constexpr14 open_dense_hashmap& operator = (open_dense_hashmap&& other)
+		{
+			crstl_assert(this != &other);
+			move_from(other);
+			return *this;
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator begin() crstl_noexcept { return m_values.begin(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator begin() const crstl_noexcept { return m_values.begin(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cbegin() const crstl_noexcept { return m_values.begin(); }
+
+		crstl_nodiscard
+		size_t bucket_count() const { return m_capacity_allocator.m_first; }
+
+		// Keeps the probe table, so refilling up to the same size doesn't allocate
+		crstl_constexpr14 void clear()
+		{
+			m_values.clear();
+
+			for (size_t i = 0; i < m_capacity_allocator.m_first; ++i)
+			{
+				m_slots[i].index = slot_type::kEmptyIndex;
+			}
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard size_t count(const KeyType& key) const
+		{
+			return find_slot(key, hash_of(key)) != kInvalidSlot ? 1 : 0;
+		}
+
+		// The pairs are contiguous, in insertion order as long as nothing was erased
+		crstl_nodiscard
+		crstl_constexpr14 key_value_type* data() { return m_values.data(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const key_value_type* data() const { return m_values.data(); }
+
+		crstl_constexpr bool empty() const { return m_values.empty(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator end() { return m_values.end(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator end() const { return m_values.end(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cend() const { return m_values.end(); }
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		//--------
+		// emplace
+		//--------
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(const key_type& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::find>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(key_type&& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::find>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(const key_type& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::assign>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(key_type&& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+#endif
+
+		//------
+		// erase
+		//------
+
+		// Returns the same position, which holds what was the last pair, or end() if pos was the last pair
+		crstl_constexpr14 iterator erase(iterator pos)
+		{
+			crstl_assert(pos >= begin() && pos < end());
+
+			const size_t value_index = (size_t)(pos - begin());
+			erase_impl(find_slot_of_index(value_index));
+
+			return begin() + value_index;
+		}
+
+		crstl_constexpr14 const_iterator erase(const_iterator pos)
+		{
+			return erase(begin() + (pos - cbegin()));
+		}
+
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase(const KeyType& key)
+		{
+			const size_t slot_index = find_slot(key, hash_of(key));
+
+			if (slot_index != kInvalidSlot)
+			{
+				erase_impl(slot_index);
+				return 1;
+			}
+
+			return 0;
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard iterator find(const KeyType& key) crstl_noexcept
+		{
+			const size_t slot_index = find_slot(key, hash_of(key));
+			return slot_index != kInvalidSlot ? begin() + m_slots[slot_index].index : end();
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard const_iterator find(const KeyType& key) const crstl_noexcept
+		{
+			const size_t slot_index = find_slot(key, hash_of(key));
+			return slot_index != kInvalidSlot ? begin() + m_slots[slot_index].index : end();
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard
+		static size_t hash_of(const KeyType& key)
+		{
+			return hashmap_hash_selector<hasher, key_type>::hash(key);
+		}
+
+		//-------
+		// insert
+		//-------
+
+		template<typename ValueType>
+		pair<iterator, bool> insert(const key_type& key, ValueType&& value)
+		{
+			return insert_impl<exists_behavior::find>(key, crstl_forward(ValueType, value));
+		}
+
+		template<typename ValueType>
+		pair<iterator, bool> insert(key_type&& key, ValueType&& value)
+		{
+			return insert_impl<exists_behavior::find>(crstl_forward(key_type, key), crstl_forward(ValueType, value));
+		}
+
+		template<typename ValueType>
+		pair<iterator, bool> insert_or_assign(const key_type& key, ValueType&& value)
+		{
+			return insert_impl<exists_behavior::assign>(key, crstl_forward(ValueType, value));
+		}
+
+		template<typename ValueType>
+		pair<iterator, bool> insert_or_assign(key_type&& key, ValueType&& value)
+		{
+			return insert_impl<exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(ValueType, value));
+		}
+
+		crstl_nodiscard
+		float load_factor() const { return m_capacity_allocator.m_first == 0 ? 0.0f : (float)m_values.size() / (float)m_capacity_allocator.m_first; }
+
+		crstl_nodiscard
+		float max_load_factor() const { return m_max_load_factor; }
+
+		// Lower values trade memory for shorter probe sequences. The new value takes effect the next time we insert or
+		// rehash. It must be below 1 as linear probing needs empty slots to terminate
+		void max_load_factor(float load_factor)
+		{
+			crstl_assert(load_factor > 0.0f && load_factor < 1.0f);
+			m_max_load_factor = load_factor;
+			m_length_threshold = compute_length_threshold(m_capacity_allocator.m_first);
+		}
+
+		// Make room for capacity pairs without reallocating the vector or rehashing
+		void reserve(size_t capacity)
+		{
+			m_values.reserve(capacity);
+
+			if (capacity > m_length_threshold)
+			{
+				rehash(compute_capacity_for_length(capacity));
+			}
+		}
+
+		crstl_nodiscard
+		size_t size() const { return m_values.size(); }
+
+	private:
+
+		static const size_t kInvalidSlot = (size_t)-1;
+
+		// Fold the hash into the 32 bits we store. Every bit of the hash affects them
+		static uint32_t compute_slot_hash(size_t hash_value)
+		{
+			crstl_constexpr_if(sizeof(size_t) == 8)
+			{
+				return (uint32_t)(hash_value ^ ((hash_value >> 16) >> 16));
+			}
+			else
+			{
+				return (uint32_t)hash_value;
+			}
+		}
+
+		// Fibonacci hashing of the stored bits, taking the top log2(m_bucket_count) bits of the product
+		size_t compute_bucket(uint32_t slot_hash) const
+		{
+			return (size_t)(((uint64_t)(uint32_t)(slot_hash * 0x9e3779b9u) << m_bucket_bits) >> 32);
+		}
+
+		crstl_constexpr14 size_t compute_capacity_for_length(size_t length) const
+		{
+			return (size_t)((float)length / m_max_load_factor) + 1;
+		}
+
+		// Number of pairs we can hold before rehashing. We always keep one empty slot so that probing terminates
+		crstl_constexpr14 size_t compute_length_threshold(size_t capacity) const
+		{
+			if (capacity == 0)
+			{
+				return 0;
+			}
+
+			size_t length_threshold = (size_t)((float)capacity * m_max_load_factor);
+			return length_threshold < capacity ? length_threshold : capacity - 1;
+		}
+
+		template<typename KeyType>
+		size_t find_slot(const KeyType& key, size_t hash_value) const
+		{
+			const uint32_t slot_hash = compute_slot_hash(hash_value);
+			const size_t bucket_mask = m_bucket_count - 1;
+
+			for (size_t slot_index = compute_bucket(slot_hash); ; slot_index = (slot_index + 1) & bucket_mask)
+			{
+				const slot_type& slot = m_slots[slot_index];
+
+				if (slot.is_empty())
+				{
+					return kInvalidSlot;
+				}
+				else if (slot.hash == slot_hash && m_values[slot.index].first == key)
+				{
+					return slot_index;
+				}
+			}
+		}
+
+		// Find the slot pointing at a pair we know is in the table
+		size_t find_slot_of_index(size_t value_index) const
+		{
+			const uint32_t slot_hash = compute_slot_hash(hash_of(m_values[value_index].first));
+			const size_t bucket_mask = m_bucket_count - 1;
+
+			size_t slot_index = compute_bucket(slot_hash);
+
+			while (m_slots[slot_index].index != (uint32_t)value_index)
+			{
+				crstl_assert(!m_slots[slot_index].is_empty());
+				slot_index = (slot_index + 1) & bucket_mask;
+			}
+
+			return slot_index;
+		}
+
+		// Returns the slot with the key, or the empty slot where it goes
+		template<typename KeyType>
+		size_t find_or_empty_slot(const KeyType& key, uint32_t slot_hash) const
+		{
+			const size_t bucket_mask = m_bucket_count - 1;
+
+			for (size_t slot_index = compute_bucket(slot_hash); ; slot_index = (slot_index + 1) & bucket_mask)
+			{
+				const slot_type& slot = m_slots[slot_index];
+
+				if (slot.is_empty() || (slot.hash == slot_hash && m_values[slot.index].first == key))
+				{
+					return slot_index;
+				}
+			}
+		}
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		template<exists_behavior::t Behavior, typename KeyType, typename... Args>
+		pair<iterator, bool> emplace_impl(KeyType&& key, Args&&... args)
+		{
+			rehash_if_length_above_load_factor();
+
+			const uint32_t slot_hash = compute_slot_hash(hash_of(key));
+			const size_t slot_index = find_or_empty_slot(key, slot_hash);
+			slot_type& slot = m_slots[slot_index];
+
+			if (slot.is_empty())
+			{
+				slot.hash = slot_hash;
+				slot.index = (uint32_t)m_values.size();
+				m_values.emplace_back(crstl_forward(KeyType, key), value_type(crstl_forward(Args, args)...));
+				return { begin() + slot.index, true };
+			}
+
+			crstl_constexpr_if(Behavior == exists_behavior::assign)
+			{
+				m_values[slot.index].second = value_type(crstl_forward(Args, args)...);
+			}
+
+			return { begin() + slot.index, Behavior == exists_behavior::assign };
+		}
+
+#endif
+
+		template<exists_behavior::t Behavior, typename KeyType, typename ValueType>
+		pair<iterator, bool> insert_impl(KeyType&& key, ValueType&& value)
+		{
+			rehash_if_length_above_load_factor();
+
+			const uint32_t slot_hash = compute_slot_hash(hash_of(key));
+			const size_t slot_index = find_or_empty_slot(key, slot_hash);
+			slot_type& slot = m_slots[slot_index];
+
+			if (slot.is_empty())
+			{
+				slot.hash = slot_hash;
+				slot.index = (uint32_t)m_values.size();
+				m_values.emplace_back(crstl_forward(KeyType, key), crstl_forward(ValueType, value));
+				return { begin() + slot.index, true };
+			}
+
+			crstl_constexpr_if(Behavior == exists_behavior::assign)
+			{
+				m_values[slot.index].second = crstl_forward(ValueType, value);
+			}
+
+			return { begin() + slot.index, Behavior == exists_behavior::assign };
+		}
+
+		void erase_impl(size_t slot_index)
+		{
+			const size_t bucket_mask = m_bucket_count - 1;
+			const size_t value_index = m_slots[slot_index].index;
+			const size_t last_index = m_values.size() - 1;
+
+			// Shift back the slots after the hole that can move closer to their bucket, so that no probe sequence
+			// is cut short by the empty slot
+			size_t hole_index = slot_index;
+
+			for (size_t next_index = (hole_index + 1) & bucket_mask; !m_slots[next_index].is_empty(); next_index = (next_index + 1) & bucket_mask)
+			{
+				const size_t next_bucket = compute_bucket(m_slots[next_index].hash);
+
+				if (((next_index - next_bucket) & bucket_mask) >= ((next_index - hole_index) & bucket_mask))
+				{
+					m_slots[hole_index] = m_slots[next_index];
+					hole_index = next_index;
+				}
+			}
+
+			m_slots[hole_index].index = slot_type::kEmptyIndex;
+
+			// Move the last pair into the one we erase and point its slot at the new position
+			if (value_index != last_index)
+			{
+				m_slots[find_slot_of_index(last_index)].index = (uint32_t)value_index;
+				m_values[value_index] = crstl_move(m_values[last_index]);
+			}
+
+			m_values.pop_back();
+		}
+
+		void rehash_if_length_above_load_factor()
+		{
+			if (m_values.size() >= m_length_threshold)
+			{
+				const size_t new_capacity = 2 * m_capacity_allocator.m_first < 16 ? 16 : 2 * m_capacity_allocator.m_first;
+				const size_t min_capacity = compute_capacity_for_length(m_values.size() + 1);
+				rehash(new_capacity < min_capacity ? min_capacity : new_capacity);
+			}
+		}
+
+		// Only the slots move, the stored hash bits are enough to find their new bucket
+		void rehash(size_t capacity)
+		{
+			slot_type* current_slots = m_slots;
+			const size_t current_capacity = m_capacity_allocator.m_first;
+
+			allocate_internal(capacity);
+
+			const size_t bucket_mask = m_bucket_count - 1;
+
+			for (size_t i = 0; i < current_capacity; ++i)
+			{
+				if (!current_slots[i].is_empty())
+				{
+					size_t slot_index = compute_bucket(current_slots[i].hash);
+
+					while (!m_slots[slot_index].is_empty())
+					{
+						slot_index = (slot_index + 1) & bucket_mask;
+					}
+
+					m_slots[slot_index] = current_slots[i];
+				}
+			}
+
+			deallocate(current_slots, current_capacity);
+		}
+
+		void allocate_internal(size_t capacity)
+		{
+			// Round to the nearest power of 2 as we rely on this for the bucket calculation
+			const size_t rounded_capacity = crstl::bit_ceil(capacity);
+			crstl_assert(rounded_capacity <= ((size_t)1 << 31));
+
+			m_slots = (slot_type*)hashmap_bucket_allocator<Allocator>::allocate(m_capacity_allocator.second(), rounded_capacity * sizeof(slot_type));
+			m_capacity_allocator.m_first = rounded_capacity;
+			m_bucket_count = rounded_capacity;
+			m_bucket_bits = (uint32_t)crstl::countr_zero(rounded_capacity);
+			m_length_threshold = compute_length_threshold(rounded_capacity);
+
+			for (size_t i = 0; i < rounded_capacity; ++i)
+			{
+				m_slots[i].index = slot_type::kEmptyIndex;
+			}
+		}
+
+		void deallocate(slot_type* slots, size_t capacity)
+		{
+			if (slots != &m_dummy)
+			{
+				hashmap_bucket_allocator<Allocator>::deallocate(m_capacity_allocator.second(), slots, capacity * sizeof(slot_type));
+			}
+		}
+
+		void deallocate_internal()
+		{
+			deallocate(m_slots, m_capacity_allocator.m_first);
+			m_slots = &m_dummy;
+			m_capacity_allocator.m_first = 0;
+			m_bucket_count = 1;
+			m_bucket_bits = 0;
+			m_length_threshold = 0;
+		}
+
+		void copy_from(const open_dense_hashmap& other)
+		{
+			m_max_load_factor = other.m_max_load_factor;
+
+			if (m_capacity_allocator.m_first != other.m_capacity_allocator.m_first)
+			{
+				deallocate_internal();
+
+				if (other.m_capacity_allocator.m_first != 0)
+				{
+					allocate_internal(other.m_capacity_allocator.m_first);
+				}
+			}
+
+			// Same capacity means the same buckets, so the slots can be copied as they are
+			for (size_t i = 0; i < m_capacity_allocator.m_first; ++i)
+			{
+				m_slots[i] = other.m_slots[i];
+			}
+
+			m_length_threshold = other.m_length_threshold;
+			m_values = other.m_values;
+		}
+
+		void move_from(open_dense_hashmap& other)
+		{
+			deallocate_internal();
+
+			m_slots = other.m_slots == &other.m_dummy ? &m_dummy : other.m_slots;
+			m_length_threshold = other.m_length_threshold;
+			m_bucket_count = other.m_bucket_count;
+			m_bucket_bits = other.m_bucket_bits;
+			m_max_load_factor = other.m_max_load_factor;
+			m_capacity_allocator = other.m_capacity_allocator;
+			m_values = crstl_move(other.m_values);
+
+			other.m_slots = &other.m_dummy;
+			other.m_length_threshold = 0;
+			other.m_bucket_count = 1;
+			other.m_bucket_bits = 0;
+			other.m_capacity_allocator.m_first = 0;
+		}
+
+		vector_type m_values;
+
+		slot_type* m_slots;
+
+		// Use this dummy slot to avoid having to check for m_slots == nullptr during find and erase. It is always empty
+		slot_type m_dummy;
+
+		// Length at which the next insertion rehashes. Derived from the capacity and the maximum load factor
+		size_t m_length_threshold;
+
+		size_t m_bucket_count;
+
+		// log2(m_bucket_count)
+		uint32_t m_bucket_bits;
+
+		float m_max_load_factor;
+
+		compressed_pair<size_t, Allocator> m_capacity_allocator;
+	};
+};
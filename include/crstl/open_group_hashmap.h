@@ -0,0 +1,370 @@
+#pragma once
+
+#include "crstl/open_group_hashtable_base.h"
+
+#include "crstl/allocator.h"
+#include "crstl/compressed_pair.h"
+#include "crstl/bit.h"
+#include "crstl/forward_declarations.h"
+#include "crstl/utility/memory_ops.h"
+
+#if defined(CRSTL_MODULE_DECLARATION)
+import <initializer_list>;
+#elif defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+#include <initializer_list>
+#endif
+
+// crstl::open_group_hashmap
+//
+// Open addressing hashmap with a separate array of control bytes that is probed 16 slots at a time. Keys are only
+// compared when the 7-bit hash tag matches, which makes misses on long probe sequences cheap. Prefer it over
+// open_hashmap for large tables where lookups dominate, and for keys that are expensive to compare
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_group_hashmap_storage
+	{
+	protected:
+
+		typedef Key                                                        key_type;
+		typedef T                                                          value_type;
+		typedef size_t                                                     size_type;
+		typedef Hasher                                                     hasher;
+		typedef open_group_iterator<key_type, value_type, false>           iterator;
+		typedef open_group_iterator<key_type, value_type, true>            const_iterator;
+		typedef open_group_node<key_type, value_type>                      node_type;
+		typedef decltype(open_group_node<key_type, value_type>::key_value) key_value_type;
+
+		static const size_t kNodeSize = sizeof(node_type);
+
+		crstl_constexpr14 open_group_hashmap_storage() crstl_noexcept
+			: m_ctrl(m_dummy_ctrl)
+			, m_data(nullptr)
+			, m_length(0)
+			, m_growth_left(0)
+			, m_group_count(1) // Need this to work with m_dummy_ctrl
+			, m_capacity_allocator()
+		{
+			memory_set(m_dummy_ctrl, hashmap_ctrl::empty, sizeof(m_dummy_ctrl));
+		}
+
+		~open_group_hashmap_storage() {}
+
+		// Assume our groups are power of 2. h1 is already mixed so we can mask it directly
+		size_t compute_group(size_t h1) const
+		{
+			crstl_assert(crstl::is_pow2(m_group_count));
+			return h1 & (m_group_count - 1);
+		}
+
+		size_t get_bucket_count() const
+		{
+			return m_capacity_allocator.m_first;
+		}
+
+		size_t get_group_count() const
+		{
+			return m_group_count;
+		}
+
+		void reset_growth_left()
+		{
+			m_growth_left = compute_max_length(get_bucket_count());
+		}
+
+		template<typename RehashFunction>
+		crstl_forceinline crstl_constexpr14 void reallocate_rehash_if_length_above_capacity(size_t length, RehashFunction rehash_function)
+		{
+			if (length > compute_max_length(get_bucket_count()))
+			{
+				reallocate_rehash(length + length / 7, rehash_function);
+			}
+		}
+
+		// Growth is tracked by the number of empty slots we can still fill. Tombstones don't give any growth back,
+		// so if most of the used slots are tombstones rehashing to the same capacity is enough to reclaim them
+		template<typename RehashFunction>
+		crstl_forceinline crstl_constexpr14 void reallocate_rehash_if_no_growth_left(RehashFunction rehash_function)
+		{
+			if (m_growth_left == 0)
+			{
+				size_t current_capacity = get_bucket_count();
+				size_t new_capacity = (m_length * 2 <= compute_max_length(current_capacity)) ? current_capacity : compute_new_capacity(current_capacity);
+				reallocate_rehash(new_capacity, rehash_function);
+			}
+		}
+
+		template<typename RehashFunction>
+		crstl_forceinline crstl_constexpr14 void reallocate_rehash(size_t new_capacity, RehashFunction rehash_function)
+		{
+			int8_t* current_ctrl = m_ctrl;
+			node_type* current_data = m_data;
+			size_t current_capacity = get_bucket_count();
+
+			allocate_internal(new_capacity);
+
+			m_length = 0;
+			rehash_function(current_ctrl, current_data, current_data + current_capacity);
+
+			deallocate(current_ctrl, current_capacity);
+		}
+
+		// We allow filling up to 7/8 of the slots before growing
+		static crstl_constexpr size_t compute_max_length(size_t capacity)
+		{
+			return capacity - capacity / 8;
+		}
+
+		// Size of the control bytes, padded so the nodes that come after start on a cache line too
+		static crstl_constexpr size_t compute_ctrl_size(size_t capacity)
+		{
+			return (capacity + (kHashmapBucketAlignment - 1)) & ~(kHashmapBucketAlignment - 1);
+		}
+
+		// The control bytes and the nodes live in the same allocation
+		void allocate(size_t capacity)
+		{
+			m_ctrl = (int8_t*)hashmap_bucket_allocator<Allocator>::allocate(m_capacity_allocator.second(), compute_ctrl_size(capacity) + capacity * kNodeSize);
+			m_data = (node_type*)(m_ctrl + compute_ctrl_size(capacity));
+		}
+
+		void deallocate(int8_t* ctrl, size_t capacity)
+		{
+			if (ctrl != m_dummy_ctrl)
+			{
+				hashmap_bucket_allocator<Allocator>::deallocate(m_capacity_allocator.second(), ctrl, compute_ctrl_size(capacity) + capacity * kNodeSize);
+			}
+		}
+
+		crstl_constexpr14 size_t allocate_internal(size_t capacity)
+		{
+			// Round to the nearest power of 2 as we rely on this for the group calculation, and always have at least a full group
+			size_t rounded_capacity = crstl::bit_ceil(capacity);
+			rounded_capacity = rounded_capacity < hashmap_group::kWidth ? hashmap_group::kWidth : rounded_capacity;
+
+			allocate(rounded_capacity);
+			memory_set(m_ctrl, hashmap_ctrl::empty, rounded_capacity);
+
+			m_capacity_allocator.m_first = rounded_capacity;
+			m_group_count = rounded_capacity / hashmap_group::kWidth;
+			reset_growth_left();
+			return rounded_capacity;
+		}
+
+		crstl_constexpr14 void deallocate_internal()
+		{
+			deallocate(m_ctrl, m_capacity_allocator.m_first);
+			m_capacity_allocator.m_first = 0;
+			m_ctrl = m_dummy_ctrl;
+			m_data = nullptr;
+			m_growth_left = 0;
+			m_group_count = 1;
+		}
+
+		crstl_constexpr14 size_t compute_new_capacity(size_t old_capacity) const
+		{
+			return 2 * old_capacity < 16 ? 16 : 2 * old_capacity;
+		}
+
+		int8_t* m_ctrl;
+
+		node_type* m_data;
+
+		size_t m_length;
+
+		// Number of empty slots we can fill before we need to rehash
+		size_t m_growth_left;
+
+		size_t m_group_count;
+
+		compressed_pair<size_t, Allocator> m_capacity_allocator;
+
+		// Use this dummy group to avoid having to check for m_ctrl == nullptr during find and erase
+		// We just initialize this to be an always-empty group
+		crstl_alignas(16) int8_t m_dummy_ctrl[hashmap_group::kWidth];
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator, bool IsMultipleValue>
+	class open_group_hashtable : public open_group_hashtable_base<open_group_hashmap_storage<Key, T, Hasher, Allocator>, IsMultipleValue>
+	{
+	public:
+
+		typedef open_group_hashtable_base<open_group_hashmap_storage<Key, T, Hasher, Allocator>, IsMultipleValue> base_type;
+		typedef open_group_hashtable                                                                              this_type;
+
+		typedef typename base_type::key_type       key_type;
+		typedef typename base_type::value_type     value_type;
+		typedef typename base_type::key_value_type key_value_type;
+		typedef typename base_type::size_type      size_type;
+		typedef typename base_type::iterator       iterator;
+		typedef typename base_type::const_iterator const_iterator;
+		typedef typename base_type::node_type      node_type;
+
+		using base_type::clear;
+
+		crstl_constexpr14 open_group_hashtable() crstl_noexcept : base_type() {}
+
+		crstl_constexpr14 open_group_hashtable(size_t initial_length) crstl_noexcept
+		{
+			allocate_internal(initial_length + initial_length / 7);
+		}
+
+		crstl_constexpr14 open_group_hashtable(const open_group_hashtable& other) crstl_noexcept : open_group_hashtable(other.m_length)
+		{
+			for (const key_value_type& iter : other)
+			{
+				insert_empty_impl(iter);
+			}
+		}
+
+#if defined(CRSTL_FEATURE_INITIALIZER_LISTS)
+
+		crstl_constexpr14 open_group_hashtable(std::initializer_list<key_value_type> ilist) crstl_noexcept : open_group_hashtable((size_t)ilist.size())
+		{
+			for (const key_value_type& iter : ilist)
+			{
+				insert_empty_impl(iter);
+			}
+		}
+
+#endif
+
+		~open_group_hashtable() crstl_noexcept
+		{
+			destructor();
+		}
+
+		crstl_constexpr14 open_group_hashtable& operator = (const open_group_hashtable& other)
+		{
+			crstl_assert(this != &other);
+
+			// Reuse existing allocation if the size fits, just need to destroy existing elements and reset
+			if (base_type::compute_max_length(m_capacity_allocator.m_first) >= other.m_length)
+			{
+				clear();
+			}
+			// Otherwise destroy elements, deallocate memory and allocate a new piece of memory for the incoming data
+			else
+			{
+				destructor();
+				allocate_internal(other.m_length + other.m_length / 7);
+			}
+
+			for (const key_value_type& iter : other)
+			{
+				insert_empty_impl(iter);
+			}
+
+			return *this;
+		}
+
+		crstl_constexpr14 open_group_hashtable& operator = (open_group_hashtable&& other)
+		{
+			crstl_assert(this != &other);
+
+			destructor();
+
+			m_ctrl = other.m_ctrl == other.m_dummy_ctrl ? m_dummy_ctrl : other.m_ctrl;
+			m_data = other.m_data;
+			m_length = other.m_length;
+			m_growth_left = other.m_growth_left;
+			m_group_count = other.m_group_count;
+			m_capacity_allocator = other.m_capacity_allocator;
+
+			other.m_ctrl = other.m_dummy_ctrl;
+			other.m_data = nullptr;
+			other.m_length = 0;
+			other.m_growth_left = 0;
+			other.m_group_count = 1;
+			other.m_capacity_allocator.m_first = 0;
+
+			return *this;
+		}
+
+		static void swap(open_group_hashtable& hashmap1, open_group_hashtable& hashmap2)
+		{
+			int8_t* ctrl = hashmap2.m_ctrl == hashmap2.m_dummy_ctrl ? hashmap1.m_dummy_ctrl : hashmap2.m_ctrl;
+			node_type* data = hashmap2.m_data;
+			size_t length = hashmap2.m_length;
+			size_t growth_left = hashmap2.m_growth_left;
+			size_t group_count = hashmap2.m_group_count;
+			compressed_pair<size_t, Allocator> capacity_allocator = hashmap2.m_capacity_allocator;
+
+			hashmap2.m_ctrl = hashmap1.m_ctrl == hashmap1.m_dummy_ctrl ? hashmap2.m_dummy_ctrl : hashmap1.m_ctrl;
+			hashmap2.m_data = hashmap1.m_data;
+			hashmap2.m_length = hashmap1.m_length;
+			hashmap2.m_growth_left = hashmap1.m_growth_left;
+			hashmap2.m_group_count = hashmap1.m_group_count;
+			hashmap2.m_capacity_allocator = hashmap1.m_capacity_allocator;
+
+			hashmap1.m_ctrl = ctrl;
+			hashmap1.m_data = data;
+			hashmap1.m_length = length;
+			hashmap1.m_growth_left = growth_left;
+			hashmap1.m_group_count = group_count;
+			hashmap1.m_capacity_allocator = capacity_allocator;
+		}
+
+	private:
+
+		void destructor()
+		{
+			// Only destroy the value, no need to destroy buckets or nodes
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				for (const key_value_type& iter : *this)
+				{
+					iter.~key_value_type();
+				}
+			}
+
+			deallocate_internal();
+		}
+
+		using base_type::allocate_internal;
+		using base_type::deallocate_internal;
+		using base_type::insert_empty_impl;
+
+		using base_type::m_ctrl;
+		using base_type::m_data;
+		using base_type::m_dummy_ctrl;
+		using base_type::m_length;
+		using base_type::m_growth_left;
+		using base_type::m_group_count;
+		using base_type::m_capacity_allocator;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_group_hashmap : public open_group_hashtable<Key, T, Hasher, Allocator, false>
+	{
+		using open_group_hashtable<Key, T, Hasher, Allocator, false>::open_group_hashtable;
+	};
+
+	template<typename Key, typename Hasher, typename Allocator>
+	class open_group_hashset : public open_group_hashtable<Key, void, Hasher, Allocator, false>
+	{
+		using open_group_hashtable<Key, void, Hasher, Allocator, false>::open_group_hashtable;
+
+	private:
+
+		using open_group_hashtable<Key, void, Hasher, Allocator, false>::for_each;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_group_multi_hashmap : public open_group_hashtable<Key, T, Hasher, Allocator, true>
+	{
+		using open_group_hashtable<Key, T, Hasher, Allocator, true>::open_group_hashtable;
+	};
+
+	template<typename Key, typename Hasher, typename Allocator>
+	class open_group_multi_hashset : public open_group_hashtable<Key, void, Hasher, Allocator, true>
+	{
+		using open_group_hashtable<Key, void, Hasher, Allocator, true>::open_group_hashtable;
+
+	private:
+
+		using open_group_hashtable<Key, void, Hasher, Allocator, true>::for_each;
+	};
+};
@@ -0,0 +1,608 @@
+#pragma once
+
+#include "crstl/config.h"
+#include "crstl/hash.h"
+#include "crstl/move_forward.h"
+#include "crstl/pair.h"
+#include "crstl/type_utils.h"
+#include "crstl/utility/placement_new.h"
+#include "crstl/utility/hashmap_common.h"
+#include "crstl/utility/hashmap_group.h"
+
+#include "crstl/debugging.h"
+
+// open_group_hashtable_base
+//
+// Open addressing hashtable where the metadata lives in a separate array of control bytes instead of inside the nodes.
+// Probing happens a group of 16 control bytes at a time (SSE2, NEON or scalar fallback) and keys are only compared
+// when the 7-bit tag stored in the control byte matches. Erased slots become tombstones unless their group has an empty
+// slot, as nothing can be probing past that group. The storage policy provides the control bytes, the nodes and the
+// growth strategy
+
+namespace crstl
+{
+	template<typename Key, typename Value>
+	struct open_group_node
+	{
+		const Key& get_key() const { return key_value.first; }
+
+		const Value& get_value() const { return key_value.second; }
+
+		crstl::pair<Key, Value> key_value;
+	};
+
+	template<typename Key>
+	struct open_group_node<Key, void>
+	{
+		const Key& get_key() const { return key_value; }
+
+		void get_value() const {}
+
+		Key key_value;
+	};
+
+	template<typename Key, typename Value, bool IsConst>
+	struct open_group_iterator
+	{
+	public:
+
+		typedef open_group_iterator<Key, Value, IsConst> this_type;
+		typedef open_group_node<Key, Value>              node_type;
+		typedef decltype(node_type::key_value)           key_value_type;
+
+		typedef typename hashmap_type_select<IsConst, const key_value_type*, key_value_type*>::type pointer;
+		typedef typename hashmap_type_select<IsConst, const key_value_type&, key_value_type&>::type reference;
+
+		// The control pointer always points at the control byte of the current node
+		open_group_iterator(const int8_t* ctrl, const node_type* end, node_type* node) : m_ctrl(ctrl), m_end(end), m_node(node) {}
+
+		pointer operator -> () const { crstl_assert(m_node != nullptr); return &(m_node->key_value); }
+
+		reference operator * () const { crstl_assert(m_node != nullptr); return m_node->key_value; }
+
+		open_group_iterator& operator ++ () { increment(); return *this; }
+
+		open_group_iterator operator ++ (int) { open_group_iterator temp(*this); increment(); return temp; }
+
+		bool operator == (const this_type& other) const { return m_node == other.m_node; }
+
+		bool operator != (const this_type& other) const { return m_node != other.m_node; }
+
+		node_type* get_node() const { return m_node; }
+
+		void increment()
+		{
+			do
+			{
+				m_node++;
+				m_ctrl++;
+			}
+			// Full control bytes are the only ones with the top bit clear
+			while (m_node < m_end && *m_ctrl < 0);
+		}
+
+	private:
+
+		const int8_t* m_ctrl;
+
+		const node_type* m_end;
+
+		node_type* m_node;
+	};
+
+	template<typename HashmapStorage, bool IsMultipleValue = false>
+	class open_group_hashtable_base : public HashmapStorage
+	{
+	public:
+
+		typedef HashmapStorage            storage_type;
+		typedef open_group_hashtable_base this_type;
+
+		typedef typename HashmapStorage::key_type       key_type;
+		typedef typename HashmapStorage::value_type     value_type;
+		typedef typename HashmapStorage::key_value_type key_value_type;
+		typedef typename HashmapStorage::hasher         hasher;
+		typedef typename HashmapStorage::iterator       iterator;
+		typedef typename HashmapStorage::const_iterator const_iterator;
+		typedef typename HashmapStorage::node_type      node_type;
+
+		using storage_type::m_ctrl;
+		using storage_type::m_data;
+		using storage_type::m_length;
+		using storage_type::m_growth_left;
+
+		using storage_type::compute_group;
+		using storage_type::get_bucket_count;
+		using storage_type::get_group_count;
+		using storage_type::reset_growth_left;
+		using storage_type::reallocate_rehash_if_no_growth_left;
+		using storage_type::reallocate_rehash_if_length_above_capacity;
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator begin() crstl_noexcept
+		{
+			return make_iterator<iterator>(begin_impl());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator begin() const crstl_noexcept
+		{
+			return make_iterator<const_iterator>(begin_impl());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cbegin() const crstl_noexcept
+		{
+			return make_iterator<const_iterator>(begin_impl());
+		}
+
+		crstl_constexpr14 void clear()
+		{
+			if (m_length != 0)
+			{
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					for (const key_value_type& iter : *this)
+					{
+						iter.~key_value_type();
+					}
+				}
+
+				for (size_t i = 0; i < get_bucket_count(); ++i)
+				{
+					m_ctrl[i] = hashmap_ctrl::empty;
+				}
+
+				m_length = 0;
+				reset_growth_left();
+			}
+		}
+
+		crstl_constexpr bool empty() const { return m_length == 0; }
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator end() { return make_iterator<iterator>((node_type*)(m_data + get_bucket_count())); }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator end() const { return make_iterator<const_iterator>((node_type*)(m_data + get_bucket_count())); }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator cend() const { return make_iterator<const_iterator>((node_type*)(m_data + get_bucket_count())); }
+
+		template<typename KeyType>
+		size_t count(const KeyType& key) const
+		{
+			const size_t mixed_hash = hashmap_group_mix(compute_hash_value(key));
+			const int8_t h2 = hashmap_group_h2(mixed_hash);
+			const size_t group_count = get_group_count();
+			size_t group_index = compute_group(hashmap_group_h1(mixed_hash));
+
+			size_t count = 0;
+
+			for (size_t probe = 0; probe < group_count; ++probe)
+			{
+				const size_t group_offset = group_index * hashmap_group::kWidth;
+				const hashmap_group group(m_ctrl + group_offset);
+
+				for (hashmap_group_mask match = group.match(h2); match.any(); match.clear_lowest())
+				{
+					if (m_data[group_offset + match.lowest()].get_key() == key)
+					{
+						++count;
+
+						crstl_constexpr_if(!IsMultipleValue)
+						{
+							return count;
+						}
+					}
+				}
+
+				if (group.match_empty().any())
+				{
+					break;
+				}
+
+				group_index = next_group(group_index, group_count);
+			}
+
+			return count;
+		}
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		//--------
+		// emplace
+		//--------
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(const key_type& key, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::find, insert_emplace::emplace>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(key_type&& key, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::find, insert_emplace::emplace>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(const key_type& key, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::assign, insert_emplace::emplace>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(key_type&& key, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::assign, insert_emplace::emplace>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+#endif
+
+		//------
+		// erase
+		//------
+
+		// Nodes never move on erase, so the next iterator is always valid
+		crstl_constexpr14 iterator erase(iterator pos)
+		{
+			crstl_assert(pos != end());
+			iterator next_iter = pos;
+			++next_iter;
+			erase_node_impl(pos.get_node());
+			return next_iter;
+		}
+
+		crstl_constexpr14 const_iterator erase(const_iterator pos)
+		{
+			crstl_assert(pos != cend());
+			const_iterator next_iter = pos;
+			++next_iter;
+			erase_node_impl(pos.get_node());
+			return next_iter;
+		}
+
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase(KeyType&& key)
+		{
+			node_type* found_node = find_impl(key);
+
+			if (found_node != m_data + get_bucket_count())
+			{
+				erase_node_impl(found_node);
+				return 1;
+			}
+
+			return 0;
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard iterator find(const KeyType& key) crstl_noexcept
+		{
+			return make_iterator<iterator>(find_impl(key));
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard const_iterator find(const KeyType& key) const crstl_noexcept
+		{
+			return make_iterator<const_iterator>(find_impl(key));
+		}
+
+		template<typename KeyType, typename Function>
+		void for_each(KeyType&& key, Function&& function)
+		{
+			const size_t mixed_hash = hashmap_group_mix(compute_hash_value(key));
+			const int8_t h2 = hashmap_group_h2(mixed_hash);
+			const size_t group_count = get_group_count();
+			size_t group_index = compute_group(hashmap_group_h1(mixed_hash));
+
+			for (size_t probe = 0; probe < group_count; ++probe)
+			{
+				const size_t group_offset = group_index * hashmap_group::kWidth;
+				const hashmap_group group(m_ctrl + group_offset);
+
+				for (hashmap_group_mask match = group.match(h2); match.any(); match.clear_lowest())
+				{
+					node_type* current_node = m_data + group_offset + match.lowest();
+
+					if (current_node->get_key() == key)
+					{
+						// Call function on every value we find
+						function(current_node->get_value());
+
+						crstl_constexpr_if(!IsMultipleValue)
+						{
+							return;
+						}
+					}
+				}
+
+				if (group.match_empty().any())
+				{
+					return;
+				}
+
+				group_index = next_group(group_index, group_count);
+			}
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(const key_type& key, ValueType&&... value)
+		{
+			return find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::find, insert_emplace::insert>(key, crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(key_type&& key, ValueType&&... value)
+		{
+			return find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::find, insert_emplace::insert>(crstl_forward(key_type, key), crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(const key_type& key, ValueType&&... value)
+		{
+			return find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::assign, insert_emplace::insert>(key, crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(key_type&& key, ValueType&&... value)
+		{
+			return find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::assign, insert_emplace::insert>(crstl_forward(key_type, key), crstl_forward(ValueType, value)...);
+		}
+
+		void reserve(size_t capacity)
+		{
+			reallocate_rehash_if_length_above_capacity(capacity, [this](const int8_t* crstl_restrict current_ctrl, node_type* crstl_restrict current_node, const node_type* const end_node)
+			{
+				reinsert_all_impl(this, current_ctrl, current_node, end_node);
+			});
+		}
+
+		crstl_nodiscard
+		size_t size() const { return m_length; }
+
+	protected:
+
+		template<typename Iterator>
+		crstl_forceinline Iterator make_iterator(node_type* node) const
+		{
+			return Iterator(m_ctrl + (node - m_data), m_data + get_bucket_count(), node);
+		}
+
+		static crstl_forceinline size_t next_group(size_t group_index, size_t group_count)
+		{
+			group_index++;
+			return group_index == group_count ? 0 : group_index;
+		}
+
+		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_reallocate(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		{
+			reallocate_rehash_if_no_growth_left([this](const int8_t* crstl_restrict current_ctrl, node_type* crstl_restrict current_node, const node_type* const end_node)
+			{
+				reinsert_all_impl(this, current_ctrl, current_node, end_node);
+			});
+
+			return find_create_impl<Behavior, InsertEmplace>(crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+		}
+
+		// Probe the groups looking for the key, remembering the first slot we could have inserted into. We can only
+		// stop looking when a group has an empty slot, as the key may be further along if the group was ever full
+		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_impl(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		{
+			// A hashset uses a value_type of void to indicate we want to only store the key. Therefore, trying to insert a value is an error
+			static_assert(crstl::is_void<value_type>::value ? sizeof...(InsertEmplaceArgs) == 0 : true, "Error: hashset does not store a value");
+
+			// Even when we do have a value, trying to insert many is an error, this is meant for a single value
+			static_assert(InsertEmplace == insert_emplace::insert ? sizeof...(InsertEmplaceArgs) < 2 : true, "Error: too many values provided");
+
+			const size_t mixed_hash = hashmap_group_mix(compute_hash_value(key));
+			const int8_t h2 = hashmap_group_h2(mixed_hash);
+			const size_t group_count = get_group_count();
+			size_t group_index = compute_group(hashmap_group_h1(mixed_hash));
+
+			size_t insert_index = (size_t)-1;
+
+			for (size_t probe = 0; probe < group_count; ++probe)
+			{
+				const size_t group_offset = group_index * hashmap_group::kWidth;
+				const hashmap_group group(m_ctrl + group_offset);
+
+				crstl_constexpr_if(Behavior != exists_behavior::multi)
+				{
+					for (hashmap_group_mask match = group.match(h2); match.any(); match.clear_lowest())
+					{
+						node_type* current_node = m_data + group_offset + match.lowest();
+
+						if (current_node->get_key() == key)
+						{
+							// If our insert behavior is to assign, replace the existing value with the current one
+							crstl_constexpr_if(Behavior == exists_behavior::assign)
+							{
+								crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+								{
+									current_node->key_value.~key_value_type();
+								}
+
+								node_create_selector<key_value_type, value_type, InsertEmplace>::create(current_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+							}
+
+							return { make_iterator<iterator>(current_node), Behavior == exists_behavior::assign };
+						}
+					}
+				}
+
+				if (insert_index == (size_t)-1)
+				{
+					hashmap_group_mask available = group.match_empty_or_deleted();
+
+					if (available.any())
+					{
+						insert_index = group_offset + available.lowest();
+					}
+				}
+
+				if (group.match_empty().any())
+				{
+					break;
+				}
+
+				group_index = next_group(group_index, group_count);
+			}
+
+			if (insert_index == (size_t)-1)
+			{
+				return { iterator(nullptr, m_data + get_bucket_count(), nullptr), false };
+			}
+
+			// Reusing a tombstone doesn't consume any of the growth budget
+			m_growth_left -= (m_ctrl[insert_index] == hashmap_ctrl::empty) ? 1 : 0;
+			m_ctrl[insert_index] = h2;
+
+			node_type* empty_node = m_data + insert_index;
+			node_create_selector<key_value_type, value_type, InsertEmplace>::create(empty_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+			m_length++;
+
+			return { make_iterator<iterator>(empty_node), true };
+		}
+
+		// Optimized version of insert when we know we are batch inserting key-value types into a clean hashmap
+		// We can skip iterator construction and even the comparison with the key. This is useful for constructors
+		// and for rehashing
+		inline crstl_constexpr14 void insert_empty_impl(const key_value_type& key_value)
+		{
+			insert_empty_impl(crstl_forward(const key_value_type, key_value));
+		}
+
+		template<typename KeyValueType>
+		inline crstl_constexpr14 void insert_empty_impl(KeyValueType&& key_value)
+		{
+			const size_t mixed_hash = hashmap_group_mix(compute_hash_value(get_key(key_value)));
+			const size_t group_count = get_group_count();
+			size_t group_index = compute_group(hashmap_group_h1(mixed_hash));
+
+			for (size_t probe = 0; probe < group_count; ++probe)
+			{
+				const size_t group_offset = group_index * hashmap_group::kWidth;
+				hashmap_group_mask available = hashmap_group(m_ctrl + group_offset).match_empty_or_deleted();
+
+				if (available.any())
+				{
+					const size_t insert_index = group_offset + available.lowest();
+					m_growth_left -= (m_ctrl[insert_index] == hashmap_ctrl::empty) ? 1 : 0;
+					m_ctrl[insert_index] = hashmap_group_h2(mixed_hash);
+					crstl_placement_new((void*)&(m_data[insert_index].key_value)) key_value_type(crstl_forward(KeyValueType, key_value));
+					m_length++;
+					return;
+				}
+
+				group_index = next_group(group_index, group_count);
+			}
+		}
+
+		template<typename KeyType>
+		crstl_forceinline node_type* find_impl(const KeyType& key) const
+		{
+			const size_t mixed_hash = hashmap_group_mix(compute_hash_value(key));
+			const int8_t h2 = hashmap_group_h2(mixed_hash);
+			const size_t group_count = get_group_count();
+			size_t group_index = compute_group(hashmap_group_h1(mixed_hash));
+
+			for (size_t probe = 0; probe < group_count; ++probe)
+			{
+				const size_t group_offset = group_index * hashmap_group::kWidth;
+				const hashmap_group group(m_ctrl + group_offset);
+
+				for (hashmap_group_mask match = group.match(h2); match.any(); match.clear_lowest())
+				{
+					node_type* current_node = (node_type*)m_data + group_offset + match.lowest();
+
+					if (current_node->get_key() == key)
+					{
+						return current_node;
+					}
+				}
+
+				if (group.match_empty().any())
+				{
+					break;
+				}
+
+				group_index = next_group(group_index, group_count);
+			}
+
+			return (node_type*)m_data + get_bucket_count();
+		}
+
+		crstl_forceinline crstl_constexpr14 void erase_node_impl(node_type* node_to_erase)
+		{
+			const size_t node_index = (size_t)(node_to_erase - m_data);
+
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				node_to_erase->key_value.~key_value_type();
+			}
+
+			m_length--;
+
+			// If the group already has an empty slot no probe can have continued past it, so we don't need a tombstone
+			const size_t group_offset = node_index & ~(hashmap_group::kWidth - 1);
+
+			if (hashmap_group(m_ctrl + group_offset).match_empty().any())
+			{
+				m_ctrl[node_index] = hashmap_ctrl::empty;
+				m_growth_left++;
+			}
+			else
+			{
+				m_ctrl[node_index] = hashmap_ctrl::deleted;
+			}
+		}
+
+		node_type* begin_impl() const
+		{
+			node_type* const data = (node_type*)m_data;
+
+			if (empty())
+			{
+				return data + get_bucket_count();
+			}
+			else
+			{
+				size_t index = 0;
+
+				while (m_ctrl[index] < 0)
+				{
+					index++;
+				}
+
+				return data + index;
+			}
+		}
+
+		void reinsert_all_impl(this_type* hashmap, const int8_t* crstl_restrict current_ctrl, node_type* crstl_restrict current_node, const node_type* const end_node)
+		{
+			for (; current_node != end_node; ++current_node, ++current_ctrl)
+			{
+				if (*current_ctrl >= 0)
+				{
+					hashmap->insert_empty_impl(crstl_move(current_node->key_value));
+
+					crstl_constexpr_if(!crstl_is_trivially_destructible(node_type))
+					{
+						current_node->~node_type();
+					}
+				}
+			}
+		}
+
+		template<typename KeyType>
+		static crstl_constexpr14 size_t compute_hash_value(const KeyType& key)
+		{
+			size_t hash_value = hashmap_hash_selector<hasher, key_type>::hash(key);
+			return hash_value;
+		}
+	};
+};
@@ -5,6 +5,7 @@
 #include "crstl/allocator.h"
 #include "crstl/compressed_pair.h"
 #include "crstl/bit.h"
+#include "crstl/thread.h"
 #include "crstl/forward_declarations.h"
 
 #if defined(CRSTL_MODULE_DECLARATION)
@@ -34,7 +35,9 @@ crstl_module_export namespace crstl
 		crstl_constexpr14 open_hashmap_storage() crstl_noexcept
 			: m_data(&m_dummy)
 			, m_length(0)
+			, m_length_threshold(0)
 			, m_bucket_count(1) // Need this to work with m_dummy
+			, m_max_load_factor(0.75f)
 			, m_capacity_allocator()
 		{
 			m_dummy.set_empty();
@@ -66,10 +69,7 @@ crstl_module_export namespace crstl
 		template<typename RehashFunction>
 		crstl_forceinline crstl_constexpr14 void reallocate_rehash_if_length_above_load_factor(RehashFunction rehash_function)
 		{
-			// length * 0.75
-			size_t length_threshold = (m_capacity_allocator.m_first >> 1) + (m_capacity_allocator.m_first >> 2);
-
-			if (m_length >= length_threshold)
+			if (m_length >= m_length_threshold)
 			{
 				size_t current_capacity = get_bucket_count();
 				size_t new_capacity = compute_new_capacity(current_capacity);
@@ -77,6 +77,24 @@ crstl_module_export namespace crstl
 			}
 		}
 
+		// Smallest capacity that can hold length nodes without going above the maximum load factor
+		crstl_constexpr14 size_t compute_capacity_for_length(size_t length) const
+		{
+			return (size_t)((float)length / m_max_load_factor) + 1;
+		}
+
+		// Number of nodes we can hold before rehashing. We always keep one empty node so that probing terminates
+		crstl_constexpr14 size_t compute_length_threshold(size_t capacity) const
+		{
+			if (capacity == 0)
+			{
+				return 0;
+			}
+
+			size_t length_threshold = (size_t)((float)capacity * m_max_load_factor);
+			return length_threshold < capacity ? length_threshold : capacity - 1;
+		}
+
 		template<typename RehashFunction>
 		crstl_forceinline crstl_constexpr14 void reallocate_rehash(size_t new_capacity, RehashFunction rehash_function)
 		{
@@ -101,17 +119,16 @@ crstl_module_export namespace crstl
 			return (x + (alignment - 1)) & ~(alignment - 1);
 		}
 
-		// TODO Allocate aligned
 		node_type* allocate(size_t capacity)
 		{
-			return (node_type*)m_capacity_allocator.second().allocate(capacity * kNodeSize);
+			return (node_type*)hashmap_bucket_allocator<Allocator>::allocate(m_capacity_allocator.second(), capacity * kNodeSize);
 		}
 
 		void deallocate(node_type* data, size_t capacity)
 		{
 			if (data != &m_dummy)
 			{
-				m_capacity_allocator.second().deallocate(data, capacity * kNodeSize);
+				hashmap_bucket_allocator<Allocator>::deallocate(m_capacity_allocator.second(), data, capacity * kNodeSize);
 			}
 		}
 
@@ -123,6 +140,7 @@ crstl_module_export namespace crstl
 			m_data = allocate(rounded_capacity);
 			m_capacity_allocator.m_first = rounded_capacity;
 			m_bucket_count = rounded_capacity;
+			m_length_threshold = compute_length_threshold(rounded_capacity);
 			return rounded_capacity;
 		}
 		
@@ -132,11 +150,15 @@ crstl_module_export namespace crstl
 			m_capacity_allocator.m_first = 0;
 			m_data = &m_dummy;
 			m_bucket_count = 1;
+			m_length_threshold = 0;
 		}
 
+		// Double the capacity, unless the load factor was lowered enough that doubling won't bring us under it
 		crstl_constexpr14 size_t compute_new_capacity(size_t old_capacity) const
 		{
-			return 2 * old_capacity < 16 ? 16 : 2 * old_capacity;
+			size_t new_capacity = 2 * old_capacity < 16 ? 16 : 2 * old_capacity;
+			size_t min_capacity = compute_capacity_for_length(m_length + 1);
+			return new_capacity < min_capacity ? min_capacity : new_capacity;
 		}
 
 		node_type* m_data;
@@ -152,8 +174,13 @@ crstl_module_export namespace crstl
 
 		size_t m_length;
 
+		// Length at which the next insertion rehashes. Derived from the capacity and the maximum load factor
+		size_t m_length_threshold;
+
 		size_t m_bucket_count;
 
+		float m_max_load_factor;
+
 		compressed_pair<size_t, Allocator> m_capacity_allocator;
 	};
 
@@ -179,7 +206,7 @@ crstl_module_export namespace crstl
 
 		crstl_constexpr14 open_hashtable(size_t initial_length) crstl_noexcept
 		{
-			size_t allocated_length = allocate_internal(initial_length);
+			size_t allocated_length = allocate_internal(compute_capacity_for_length(initial_length));
 
 			for (size_t i = 0; i < allocated_length; ++i)
 			{
@@ -187,8 +214,17 @@ crstl_module_export namespace crstl
 			}
 		}
 
-		crstl_constexpr14 open_hashtable(const open_hashtable& other) crstl_noexcept : open_hashtable(other.m_length)
+		crstl_constexpr14 open_hashtable(const open_hashtable& other) crstl_noexcept : base_type()
 		{
+			m_max_load_factor = other.m_max_load_factor;
+
+			size_t allocated_length = allocate_internal(compute_capacity_for_length(other.m_length));
+
+			for (size_t i = 0; i < allocated_length; ++i)
+			{
+				m_data[i].set_empty();
+			}
+
 			for (const key_value_type& iter : other)
 			{
 				insert_empty_impl(iter);
@@ -216,17 +252,20 @@ crstl_module_export namespace crstl
 		{
 			crstl_assert(this != &other);
 
+			m_max_load_factor = other.m_max_load_factor;
+
 			// Reuse existing allocation if the size fits, just need to destroy existing elements and reset
-			if (m_bucket_count >= other.m_length)
+			if (other.m_length <= compute_length_threshold(m_capacity_allocator.m_first))
 			{
 				clear();
+				m_length_threshold = compute_length_threshold(m_capacity_allocator.m_first);
 			}
 			// Otherwise destroy elements, deallocate memory and allocate a new piece of memory for the incoming data
 			else
 			{
 				destructor();
 
-				size_t allocated_length = allocate_internal(other.m_length);
+				size_t allocated_length = allocate_internal(compute_capacity_for_length(other.m_length));
 
 				for (size_t i = 0; i < allocated_length; ++i)
 				{
@@ -250,11 +289,14 @@ crstl_module_export namespace crstl
 
 			m_data = other.m_data == &other.m_dummy ? &m_dummy : other.m_data;
 			m_length = other.m_length;
+			m_length_threshold = other.m_length_threshold;
 			m_capacity_allocator = other.m_capacity_allocator;
 			m_bucket_count = other.m_bucket_count;
+			m_max_load_factor = other.m_max_load_factor;
 
 			other.m_data = &other.m_dummy;
 			other.m_length = 0;
+			other.m_length_threshold = 0;
 			other.m_capacity_allocator.m_first = 0;
 			other.m_bucket_count = 1;
 
@@ -265,22 +307,406 @@ crstl_module_export namespace crstl
 		{
 			node_type* data = hashmap2.m_data == &hashmap2.m_dummy ? &hashmap1.m_dummy : hashmap2.m_data;
 			size_t length = hashmap2.m_length;
+			size_t length_threshold = hashmap2.m_length_threshold;
 			compressed_pair<size_t, Allocator> capacity_allocator = hashmap2.m_capacity_allocator;
 			size_t bucket_count = hashmap2.m_bucket_count;
+			float max_load_factor = hashmap2.m_max_load_factor;
 
 			hashmap2.m_data = hashmap1.m_data == &hashmap1.m_dummy ? &hashmap2.m_dummy : hashmap1.m_data;
 			hashmap2.m_length = hashmap1.m_length;
+			hashmap2.m_length_threshold = hashmap1.m_length_threshold;
 			hashmap2.m_capacity_allocator = hashmap1.m_capacity_allocator;
 			hashmap2.m_bucket_count = hashmap1.m_bucket_count;
+			hashmap2.m_max_load_factor = hashmap1.m_max_load_factor;
 
 			hashmap1.m_data = data;
 			hashmap1.m_length = length;
+			hashmap1.m_length_threshold = length_threshold;
 			hashmap1.m_capacity_allocator = capacity_allocator;
 			hashmap1.m_bucket_count = bucket_count;
+			hashmap1.m_max_load_factor = max_load_factor;
+		}
+
+		crstl_nodiscard
+		size_t bucket_count() const { return m_capacity_allocator.m_first; }
+
+		crstl_nodiscard
+		float load_factor() const { return m_capacity_allocator.m_first == 0 ? 0.0f : (float)m_length / (float)m_capacity_allocator.m_first; }
+
+		crstl_nodiscard
+		float max_load_factor() const { return m_max_load_factor; }
+
+		// Lower values trade memory for shorter probe sequences. The new value takes effect the next time we insert or
+		// rehash. It must be below 1 as linear probing needs empty nodes to terminate
+		void max_load_factor(float load_factor)
+		{
+			crstl_assert(load_factor > 0.0f && load_factor < 1.0f);
+			m_max_load_factor = load_factor;
+			m_length_threshold = compute_length_threshold(m_capacity_allocator.m_first);
+		}
+
+		// Rehash into at least bucket_count buckets, and enough of them to hold the current nodes under the maximum
+		// load factor. This can shrink the hashmap as well as grow it
+		void rehash(size_t bucket_count)
+		{
+			size_t min_capacity = compute_capacity_for_length(m_length);
+			size_t new_capacity = crstl::bit_ceil(bucket_count < min_capacity ? min_capacity : bucket_count);
+
+			if (new_capacity != m_capacity_allocator.m_first)
+			{
+				reallocate_rehash(new_capacity, [this](node_type* crstl_restrict current_node, const node_type* const end_node)
+				{
+					reinsert_all_impl(this, current_node, end_node);
+				});
+			}
+		}
+
+		// Insert many key-values using thread_count threads, including the calling one. Keys that already exist are left
+		// untouched, and the first of repeated keys wins, as with insert_batch. The hashmap grows up front to fit all of
+		// them, with rehash_parallel if needed. Every thread fills its own regions of the bucket array without locks.
+		// Small hashmaps fall back to inserting on the calling thread
+		void build_parallel(const key_value_type* key_values, size_t key_value_count, size_t thread_count)
+		{
+			if (key_value_count == 0)
+			{
+				return;
+			}
+
+			const size_t min_capacity = compute_capacity_for_length(m_length + key_value_count);
+
+			if (crstl::bit_ceil(min_capacity) > m_capacity_allocator.m_first)
+			{
+				rehash_parallel(min_capacity, thread_count);
+			}
+
+			if (compute_parallel_thread_count(thread_count) <= 1)
+			{
+				this->insert_batch(key_values, key_value_count);
+			}
+			else
+			{
+				key_value_source source = { key_values };
+				insert_parallel_impl(source, key_value_count, thread_count, false);
+			}
+		}
+
+		// Same as rehash, with the nodes moved into the new buckets by thread_count threads
+		void rehash_parallel(size_t bucket_count, size_t thread_count)
+		{
+			size_t min_capacity = compute_capacity_for_length(m_length);
+			size_t new_capacity = crstl::bit_ceil(bucket_count < min_capacity ? min_capacity : bucket_count);
+
+			if (new_capacity == m_capacity_allocator.m_first)
+			{
+				return;
+			}
+
+			node_type* current_data = m_data;
+			size_t current_capacity = m_capacity_allocator.m_first;
+			size_t current_bucket_count = get_bucket_count();
+
+			if (compute_parallel_thread_count(thread_count, new_capacity) <= 1)
+			{
+				rehash(bucket_count);
+				return;
+			}
+
+			// The new buckets are cleared by the threads that fill them
+			crstl_unused(allocate_internal(new_capacity));
+			m_length = 0;
+
+			node_source source = { current_data };
+			insert_parallel_impl(source, current_bucket_count, thread_count, true);
+
+			this->deallocate(current_data, current_capacity);
+		}
+
+		// Release as much memory as possible. An empty hashmap goes back to not having an allocation at all
+		void shrink_to_fit()
+		{
+			if (m_length == 0)
+			{
+				deallocate_internal();
+			}
+			else
+			{
+				rehash(0);
+			}
 		}
 
 	private:
 
+		template<typename, typename, typename, typename>
+		friend class open_incremental_hashtable;
+
+		enum : size_t
+		{
+			kMaxParallelThreads = 64,
+
+			// Every thread gets several regions, so that an uneven spread of keys doesn't leave threads waiting
+			kParallelRegionsPerThread = 8,
+
+			// Below this many buckets per region, starting threads costs more than it saves
+			kMinParallelRegionSize = 4096
+		};
+
+		// Where insert_parallel_impl takes its key-values from. Sources are indexed from 0 to the count passed in, and
+		// indices that aren't valid are skipped
+
+		struct key_value_source
+		{
+			enum { kCheckExisting = !IsMultipleValue };
+
+			bool is_valid(size_t) const { return true; }
+
+			const key_type& get_key(size_t index) const { return crstl::get_key(key_values[index]); }
+
+			void create(node_type* node, size_t index) const
+			{
+				crstl_placement_new((void*)&(node->key_value)) key_value_type(key_values[index]);
+			}
+
+			void insert(open_hashtable* hashmap, size_t index, size_t hash_value) const
+			{
+				hashmap->insert_key_value_impl(hash_value, key_values[index]);
+			}
+
+			const key_value_type* key_values;
+		};
+
+		// Moves the nodes out of the previous allocation
+		struct node_source
+		{
+			enum { kCheckExisting = false };
+
+			bool is_valid(size_t index) const { return nodes[index].is_valid(); }
+
+			const key_type& get_key(size_t index) const { return nodes[index].get_key(); }
+
+			void create(node_type* node, size_t index) const
+			{
+				crstl_placement_new((void*)&(node->key_value)) key_value_type(crstl_move(nodes[index].key_value));
+				destroy(index);
+			}
+
+			void insert(open_hashtable* hashmap, size_t index, size_t) const
+			{
+				hashmap->insert_empty_impl(crstl_move(nodes[index].key_value));
+				destroy(index);
+			}
+
+			void destroy(size_t index) const
+			{
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					nodes[index].key_value.~key_value_type();
+				}
+			}
+
+			node_type* nodes;
+		};
+
+		crstl_nodiscard
+		size_t compute_parallel_thread_count(size_t thread_count, size_t bucket_count) const
+		{
+			thread_count = thread_count < (size_t)kMaxParallelThreads ? thread_count : (size_t)kMaxParallelThreads;
+
+			while (thread_count > 1 && bucket_count < thread_count * kParallelRegionsPerThread * kMinParallelRegionSize)
+			{
+				thread_count /= 2;
+			}
+
+			return thread_count;
+		}
+
+		crstl_nodiscard
+		size_t compute_parallel_thread_count(size_t thread_count) const
+		{
+			return compute_parallel_thread_count(thread_count, m_capacity_allocator.m_first);
+		}
+
+		// Call function(thread_index) on thread_count threads, the calling thread being the first, and wait for all of them
+		template<typename Function>
+		static void run_parallel(size_t thread_count, Function& function)
+		{
+			crstl::thread_parameters parameters;
+			crstl::thread threads[kMaxParallelThreads];
+
+			for (size_t t = 1; t < thread_count; ++t)
+			{
+				threads[t] = crstl::thread(parameters, function, (size_t)t);
+			}
+
+			function((size_t)0);
+
+			for (size_t t = 1; t < thread_count; ++t)
+			{
+				threads[t].join();
+			}
+		}
+
+		// The bucket array is split into regions by the top bits of the bucket index, which are the top bits of the mixed
+		// hash. Key-values are hashed and sorted by region in parallel, keeping their order within each region, and then
+		// every thread inserts the key-values of its regions. Probing stops at the end of a region instead of spilling into
+		// the next one, so threads never touch the same node. Key-values that reach the end of their region are inserted
+		// afterwards on the calling thread. A key that exists already is either found in its region or stops at its end
+		// as well, so repeated keys are still found
+		template<typename Source>
+		void insert_parallel_impl(const Source& source, size_t source_count, size_t thread_count, bool clear_regions)
+		{
+			thread_count = compute_parallel_thread_count(thread_count);
+
+			const size_t bucket_count = get_bucket_count();
+			const size_t region_count = crstl::bit_ceil(thread_count * kParallelRegionsPerThread);
+			const size_t region_size = bucket_count / region_count;
+			const int region_shift = crstl::countr_zero(region_size);
+
+			Allocator& allocator = m_capacity_allocator.second();
+			size_t* hash_values = (size_t*)allocator.allocate(source_count * sizeof(size_t));
+			size_t* order = (size_t*)allocator.allocate(source_count * sizeof(size_t));
+			size_t* region_offsets = (size_t*)allocator.allocate(thread_count * region_count * sizeof(size_t));
+			size_t* region_starts = (size_t*)allocator.allocate((region_count + 1) * sizeof(size_t));
+			size_t* region_deferred_counts = (size_t*)allocator.allocate(region_count * sizeof(size_t));
+			size_t inserted_counts[kMaxParallelThreads];
+
+			for (size_t i = 0; i < thread_count * region_count; ++i)
+			{
+				region_offsets[i] = 0;
+			}
+
+			auto chunk_begin = [&](size_t t) { return source_count * t / thread_count; };
+
+			// Hash every key-value and count how many of each thread's chunk go to every region
+			auto hash_function = [&](size_t t)
+			{
+				size_t* thread_region_counts = region_offsets + t * region_count;
+
+				for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+				{
+					if (source.is_valid(i))
+					{
+						hash_values[i] = this->compute_hash_value(source.get_key(i));
+						thread_region_counts[this->compute_bucket(hash_values[i]) >> region_shift]++;
+					}
+				}
+			};
+
+			run_parallel(thread_count, hash_function);
+
+			// Turn the counts into where every thread writes its key-values of each region
+			size_t offset = 0;
+
+			for (size_t r = 0; r < region_count; ++r)
+			{
+				region_starts[r] = offset;
+
+				for (size_t t = 0; t < thread_count; ++t)
+				{
+					size_t region_thread_count = region_offsets[t * region_count + r];
+					region_offsets[t * region_count + r] = offset;
+					offset += region_thread_count;
+				}
+			}
+
+			region_starts[region_count] = offset;
+
+			// Sort by region and insert
+			auto sort_function = [&](size_t t)
+			{
+				size_t* thread_region_offsets = region_offsets + t * region_count;
+
+				for (size_t i = chunk_begin(t); i < chunk_begin(t + 1); ++i)
+				{
+					if (source.is_valid(i))
+					{
+						order[thread_region_offsets[this->compute_bucket(hash_values[i]) >> region_shift]++] = i;
+					}
+				}
+			};
+
+			run_parallel(thread_count, sort_function);
+
+			auto insert_function = [&](size_t t)
+			{
+				node_type* const data = m_data;
+				size_t inserted_count = 0;
+
+				for (size_t r = t; r < region_count; r += thread_count)
+				{
+					node_type* const region_end_node = data + (r + 1) * region_size;
+
+					if (clear_regions)
+					{
+						for (node_type* node = data + r * region_size; node != region_end_node; ++node)
+						{
+							node->set_empty();
+						}
+					}
+
+					size_t deferred_count = 0;
+
+					for (size_t k = region_starts[r]; k < region_starts[r + 1]; ++k)
+					{
+						const size_t index = order[k];
+						const size_t hash_value = hash_values[index];
+						const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+						node_type* crstl_restrict current_node = data + this->compute_bucket(hash_value);
+
+						while (current_node != region_end_node && !current_node->is_empty())
+						{
+							crstl_constexpr_if(Source::kCheckExisting)
+							{
+								if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == source.get_key(index))
+								{
+									break;
+								}
+							}
+
+							++current_node;
+						}
+
+						if (current_node == region_end_node)
+						{
+							// Indices we read are behind us, so we can keep the deferred ones in the same place
+							order[region_starts[r] + deferred_count++] = index;
+						}
+						else if (current_node->is_empty())
+						{
+							source.create(current_node, index);
+							current_node->set_valid(fingerprint);
+							inserted_count++;
+						}
+					}
+
+					region_deferred_counts[r] = deferred_count;
+				}
+
+				inserted_counts[t] = inserted_count;
+			};
+
+			run_parallel(thread_count, insert_function);
+
+			for (size_t t = 0; t < thread_count; ++t)
+			{
+				m_length += inserted_counts[t];
+			}
+
+			for (size_t r = 0; r < region_count; ++r)
+			{
+				for (size_t k = region_starts[r]; k < region_starts[r] + region_deferred_counts[r]; ++k)
+				{
+					source.insert(this, order[k], hash_values[order[k]]);
+				}
+			}
+
+			allocator.deallocate(region_deferred_counts, region_count * sizeof(size_t));
+			allocator.deallocate(region_starts, (region_count + 1) * sizeof(size_t));
+			allocator.deallocate(region_offsets, thread_count * region_count * sizeof(size_t));
+			allocator.deallocate(order, source_count * sizeof(size_t));
+			allocator.deallocate(hash_values, source_count * sizeof(size_t));
+		}
+
 		void destructor()
 		{
 			// Only destroy the value, no need to destroy buckets or nodes
@@ -297,13 +723,21 @@ crstl_module_export namespace crstl
 
 		using base_type::allocate_internal;
 		using base_type::deallocate_internal;
+		using base_type::compute_capacity_for_length;
+		using base_type::compute_length_threshold;
+		using base_type::get_bucket_count;
 		using base_type::insert_empty_impl;
+		using base_type::insert_key_value_impl;
+		using base_type::reallocate_rehash;
+		using base_type::reinsert_all_impl;
 
 		using base_type::m_data;
 		using base_type::m_dummy;
 		using base_type::m_length;
+		using base_type::m_length_threshold;
 		using base_type::m_capacity_allocator;
 		using base_type::m_bucket_count;
+		using base_type::m_max_load_factor;
 	};
 
 	template<typename Key, typename T, typename Hasher, typename Allocator>
@@ -7,23 +7,44 @@
 #include "crstl/type_utils.h"
 #include "crstl/utility/placement_new.h"
 #include "crstl/utility/hashmap_common.h"
+#include "crstl/utility/hashmap_stats.h"
 
 #include "crstl/debugging.h"
 
 namespace crstl
 {
+	// The meta byte of a valid node stores a fingerprint of its hash. The lowest bit is always set so that
+	// it can never be confused with an empty node, and the other 7 bits let us reject most nodes that don't
+	// match the key we're looking for without calling the comparison operator
 	struct open_node_base
 	{
 		enum node_meta
 		{
-			empty = 0, // Indicates an empty node
-			valid = 1, // First valid hash
+			empty     = 0, // Indicates an empty node
+			valid     = 1, // Bit that is always set in a valid node
+			tombstone = 2, // Node removed without shifting the ones after it. Only open_incremental_hashmap leaves these
 		};
 
+		static unsigned char compute_fingerprint(size_t hash_value)
+		{
+			// Fold all the bits of the hash into a byte. The bucket only depends on some of the bits
+			// so nodes that share a bucket can still have different fingerprints
+			crstl_constexpr_if(sizeof(size_t) == 8)
+			{
+				hash_value ^= (hash_value >> 16) >> 16;
+			}
+
+			hash_value ^= hash_value >> 16;
+			hash_value ^= hash_value >> 8;
+			return (unsigned char)(hash_value | node_meta::valid);
+		}
+
 		bool is_empty() const { return meta == node_meta::empty; }
-		bool is_valid() const { return meta > node_meta::empty; }
-		void set_valid() { meta = node_meta::valid; }
+		bool is_valid() const { return (meta & node_meta::valid) != 0; }
+		bool is_fingerprint(unsigned char fingerprint) const { return meta == fingerprint; }
+		void set_valid(unsigned char fingerprint) { meta = fingerprint; }
 		void set_empty() { meta = (unsigned char)node_meta::empty; }
+		void set_tombstone() { meta = (unsigned char)node_meta::tombstone; }
 
 		unsigned char meta;
 	};
@@ -48,41 +69,38 @@ namespace crstl
 		Key key_value;
 	};
 
-	template<typename Key, typename Value>
-	static const Key& get_key(const crstl::pair<Key, Value>& key_value) { return key_value.first; }
-
-	template<typename Key>
-	static const Key& get_key(const Key& key) { return key; }
-
-	template<typename Key, typename Value, bool IsConst>
+	// The node type is a parameter so that other open addressing tables with the same layout can share the iterator
+	template<typename Key, typename Value, bool IsConst, typename Node = open_node<Key, Value>>
 	struct open_iterator
 	{
 	public:
 
-		typedef open_iterator<Key, Value, IsConst> this_type;
-		typedef open_node<Key, Value>              node_type;
-		typedef decltype(node_type::key_value)     key_value_type;
+		typedef open_iterator<Key, Value, IsConst, Node> this_type;
+		typedef Node                                     node_type;
+		typedef decltype(node_type::key_value)           key_value_type;
 
 		typedef typename hashmap_type_select<IsConst, const key_value_type*, key_value_type*>::type pointer;
 		typedef typename hashmap_type_select<IsConst, const key_value_type&, key_value_type&>::type reference;
 
-		open_iterator(const node_type* data, const node_type* end, node_type* node) : m_data(data), m_end(end), m_node(node) {}
+		crstl_constexpr open_iterator() : m_data(nullptr), m_end(nullptr), m_node(nullptr) {}
 
-		pointer operator -> () const { crstl_assert(m_node != nullptr); return &(m_node->key_value); }
+		crstl_constexpr open_iterator(const node_type* data, const node_type* end, node_type* node) : m_data(data), m_end(end), m_node(node) {}
 
-		reference operator * () const { crstl_assert(m_node != nullptr); return m_node->key_value; }
+		crstl_constexpr14 pointer operator -> () const { crstl_assert(m_node != nullptr); return &(m_node->key_value); }
 
-		open_iterator& operator ++ () { increment(); return *this; }
+		crstl_constexpr14 reference operator * () const { crstl_assert(m_node != nullptr); return m_node->key_value; }
+
+		crstl_constexpr14 open_iterator& operator ++ () { increment(); return *this; }
 		
 		open_iterator operator ++ (int) { open_iterator temp(*this); increment(); return temp; }
 
-		bool operator == (const this_type& other) const { return m_node == other.m_node; }
+		crstl_constexpr bool operator == (const this_type& other) const { return m_node == other.m_node; }
 
-		bool operator != (const this_type& other) const { return m_node != other.m_node; }
+		crstl_constexpr bool operator != (const this_type& other) const { return m_node != other.m_node; }
 
 		node_type* get_node() const { return m_node; }
 
-		void increment()
+		crstl_constexpr14 void increment()
 		{
 			do
 			{
@@ -180,31 +198,34 @@ namespace crstl
 		template<typename KeyType>
 		size_t count(const KeyType& key) const
 		{
-			const size_t bucket_count = get_bucket_count();
-			const size_t hash_value   = compute_hash_value(key);
-			const size_t bucket_index = compute_bucket(hash_value);
+			return count_impl(key, compute_hash_value(key));
+		}
 
-			node_type* const data = m_data;
-			node_type* const start_node = data + bucket_index;
-			node_type* const end_node = data + bucket_count;
-			node_type* crstl_restrict current_node = start_node;
+		// The _hashed versions take a hash computed by the caller with hash_of, which lets the same hash be reused
+		// across several hashmaps with the same hasher, or travel with the key. Passing any other value is an error
+		template<typename KeyType>
+		size_t count_hashed(const KeyType& key, size_t hash_value) const
+		{
+			return count_impl(key, hash_value);
+		}
 
+		// Returns how many nodes match any of the keys. See find_batch
+		template<typename KeyType>
+		size_t count_batch(const KeyType* keys, size_t key_count) const
+		{
+			size_t hash_values[kBatchSize];
 			size_t count = 0;
 
-			do
+			for (size_t batch_start = 0; batch_start < key_count; batch_start += kBatchSize)
 			{
-				if (current_node->is_empty())
-				{
-					break;
-				}
-				else if (current_node->get_key() == key)
+				const size_t batch_count = key_count - batch_start < kBatchSize ? key_count - batch_start : kBatchSize;
+				prefetch_batch_impl(keys + batch_start, batch_count, hash_values);
+
+				for (size_t i = 0; i < batch_count; ++i)
 				{
-					++count;
+					count += count_impl(keys[batch_start + i], hash_values[i]);
 				}
-
-				current_node++;
-				current_node = (current_node == end_node) ? data : current_node;
-			} while (current_node != start_node);
+			}
 
 			return count;
 		}
@@ -239,6 +260,18 @@ namespace crstl
 			return emplace_impl<exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
 		}
 
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_hashed(const key_type& key, size_t hash_value, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::find, insert_emplace::emplace>(hash_value, key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_hashed(key_type&& key, size_t hash_value, Args&&... args)
+		{
+			return find_create_reallocate<exists_behavior::find, insert_emplace::emplace>(hash_value, crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
 #endif
 
 		//------
@@ -264,34 +297,28 @@ namespace crstl
 		template<typename KeyType>
 		crstl_constexpr14 size_t erase(KeyType&& key)
 		{
-			const size_t bucket_count = get_bucket_count();
-			const size_t hash_value   = compute_hash_value(key);
-			const size_t bucket_index = compute_bucket(hash_value);
-
-			node_type* const data = m_data;
-			node_type* const start_node = data + bucket_index;
-			node_type* const end_node = data + bucket_count;
-			node_type* crstl_restrict current_node = start_node;
+			return erase_impl(key, compute_hash_value(key));
+		}
 
-			do
-			{
-				// If this is the last node, we've finished our search
-				if (current_node->is_empty())
-				{
-					return 0;
-				}
-				else if (current_node->get_key() == key)
-				{
-					erase_iter_impl(current_node);
-					return 1;
-				}
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase_hashed(const KeyType& key, size_t hash_value)
+		{
+			return erase_impl(key, hash_value);
+		}
 
-				// Otherwise, look for the next node
-				current_node++;
-				current_node = (current_node == end_node) ? data : current_node;
-			} while (current_node != start_node);
+		// Erase every node for which predicate(const key_value_type&) returns true, and return how many were erased. The
+		// remaining nodes are moved back into the gaps in the same pass, which is much cheaper than erasing nodes one by one
+		template<typename Predicate>
+		size_t erase_if(Predicate predicate)
+		{
+			return erase_if_impl<true>(predicate);
+		}
 
-			return 0;
+		// Erase every node for which predicate(const key_value_type&) returns false, and return how many were erased
+		template<typename Predicate>
+		size_t retain(Predicate predicate)
+		{
+			return erase_if_impl<false>(predicate);
 		}
 
 		template<typename KeyType>
@@ -308,11 +335,41 @@ namespace crstl
 			return const_iterator(m_data, m_data + get_bucket_count(), found_node);
 		}
 
+		template<typename KeyType>
+		crstl_nodiscard iterator find_hashed(const KeyType& key, size_t hash_value) crstl_noexcept
+		{
+			node_type* found_node = find_impl(key, hash_value);
+			return iterator(m_data, m_data + get_bucket_count(), found_node);
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard const_iterator find_hashed(const KeyType& key, size_t hash_value) const crstl_noexcept
+		{
+			node_type* found_node = find_impl(key, hash_value);
+			return const_iterator(m_data, m_data + get_bucket_count(), found_node);
+		}
+
+		// Look up many independent keys, e.g. the probe side of a join. We hash a group of keys and prefetch their home
+		// buckets before probing any of them, so that the cache misses overlap instead of being serviced one by one.
+		// Writes key_count iterators to results, which are end() for keys that aren't found
+		template<typename KeyType>
+		void find_batch(const KeyType* keys, size_t key_count, iterator* results) crstl_noexcept
+		{
+			find_batch_impl(keys, key_count, results);
+		}
+
+		template<typename KeyType>
+		void find_batch(const KeyType* keys, size_t key_count, const_iterator* results) const crstl_noexcept
+		{
+			find_batch_impl(keys, key_count, results);
+		}
+
 		template<typename KeyType, typename Function>
 		void for_each(KeyType&& key, Function&& function)
 		{
 			const size_t hash_value = compute_hash_value(key);
 			const size_t bucket_index = compute_bucket(hash_value);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
 			crstl_assert(bucket_index <= get_bucket_count());
 
 			node_type* const data = m_data;
@@ -326,7 +383,7 @@ namespace crstl
 				{
 					return;
 				}
-				else if (current_node->get_key() == key)
+				else if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == key)
 				{
 					// Call function on every value we find
 					function(current_node->get_value());
@@ -368,6 +425,23 @@ namespace crstl
 			return insert_impl<IsMultipleValue ? exists_behavior::multi : exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(ValueType, value)...);
 		}
 
+		// Insert many key-values, with the same prefetching as find_batch. Keys that already exist are left untouched
+		void insert_batch(const key_value_type* key_values, size_t key_value_count)
+		{
+			size_t hash_values[kBatchSize];
+
+			for (size_t batch_start = 0; batch_start < key_value_count; batch_start += kBatchSize)
+			{
+				const size_t batch_count = key_value_count - batch_start < kBatchSize ? key_value_count - batch_start : kBatchSize;
+				prefetch_batch_impl(key_values + batch_start, batch_count, hash_values);
+
+				for (size_t i = 0; i < batch_count; ++i)
+				{
+					insert_key_value_impl(hash_values[i], key_values[batch_start + i]);
+				}
+			}
+		}
+
 		void reserve(size_t capacity)
 		{
 			reallocate_rehash_if_length_above_capacity(capacity, [this](node_type* crstl_restrict current_node, const node_type* const end_node)
@@ -376,32 +450,210 @@ namespace crstl
 			});
 		}
 
+		// The hash the hashmap uses for a key, to pass to the _hashed functions
+		template<typename KeyType>
+		crstl_nodiscard
+		static size_t hash_of(const KeyType& key)
+		{
+			return compute_hash_value(key);
+		}
+
 		crstl_nodiscard
 		size_t size() const { return m_length; }
 
+#if defined(CRSTL_HASHMAP_STATS)
+
+		// Counters since construction or the last reset_stats(), along with the load and clusters of the table as it is now.
+		// Finding the clusters walks every node
+		crstl_nodiscard
+		hashmap_stats get_stats() const
+		{
+			hashmap_stats stats = m_stats;
+			m_find_stats.copy_to(stats);
+
+			const size_t bucket_count = get_bucket_count();
+			stats.length = m_length;
+			stats.bucket_count = bucket_count;
+			stats.load_factor = bucket_count == 0 ? 0.0f : (float)m_length / (float)bucket_count;
+
+			// Start after an empty node so that a cluster that wraps around the end is counted once
+			size_t start_index = 0;
+
+			while (start_index < bucket_count && !m_data[start_index].is_empty())
+			{
+				++start_index;
+			}
+
+			size_t cluster_length = 0;
+
+			for (size_t i = 1; i <= bucket_count; ++i)
+			{
+				const size_t node_index = (start_index + i) % bucket_count;
+
+				if (m_data[node_index].is_valid())
+				{
+					++cluster_length;
+				}
+
+				if (!m_data[node_index].is_valid() || i == bucket_count)
+				{
+					if (cluster_length > 0)
+					{
+						stats.cluster_count++;
+						stats.cluster_max = cluster_length > stats.cluster_max ? cluster_length : stats.cluster_max;
+					}
+
+					cluster_length = 0;
+				}
+			}
+
+			stats.cluster_mean = stats.cluster_count == 0 ? 0.0f : (float)m_length / (float)stats.cluster_count;
+
+			return stats;
+		}
+
+		void reset_stats()
+		{
+			m_stats.reset();
+			m_find_stats.reset();
+		}
+
+#endif
+
 	protected:
 
+		// Number of keys we hash and prefetch ahead in the batch functions. Enough to keep many cache misses in flight
+		static const size_t kBatchSize = 16;
+
 		template<exists_behavior::t Behavior, typename KeyType, typename... Args>
 		crstl_forceinline crstl_constexpr14 pair<iterator, bool> emplace_impl(KeyType&& key, Args&&... args)
 		{
-			return find_create_reallocate<Behavior, insert_emplace::emplace>(crstl_forward(KeyType, key), crstl_forward(Args, args)...);
+			const size_t hash_value = compute_hash_value(key);
+			return find_create_reallocate<Behavior, insert_emplace::emplace>(hash_value, crstl_forward(KeyType, key), crstl_forward(Args, args)...);
 		}
 
 		template<exists_behavior::t Behavior, typename KeyType, typename... ValueTypes>
 		crstl_forceinline crstl_constexpr14 pair<iterator, bool> insert_impl(KeyType&& key, ValueTypes&&... value)
 		{
-			return find_create_reallocate<Behavior, insert_emplace::insert>(crstl_forward(KeyType, key), crstl_forward(ValueTypes, value)...);
+			const size_t hash_value = compute_hash_value(key);
+			return find_create_reallocate<Behavior, insert_emplace::insert>(hash_value, crstl_forward(KeyType, key), crstl_forward(ValueTypes, value)...);
 		}
 		
 		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
-		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_reallocate(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_reallocate(size_t hash_value, KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
 		{
 			reallocate_rehash_if_length_above_load_factor([this](node_type* crstl_restrict current_node, const node_type* const end_node)
 			{
 				reinsert_all_impl(this, current_node, end_node);
 			});
 
-			return find_create_impl<Behavior, InsertEmplace>(crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+			return find_create_impl<Behavior, InsertEmplace>(hash_value, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+		}
+
+		// Hash every key in the batch and prefetch the home bucket
+		template<typename KeyType>
+		crstl_forceinline void prefetch_batch_impl(const KeyType* keys, size_t batch_count, size_t* hash_values) const
+		{
+			for (size_t i = 0; i < batch_count; ++i)
+			{
+				hash_values[i] = compute_hash_value(get_key(keys[i]));
+				crstl_prefetch(m_data + compute_bucket(hash_values[i]));
+			}
+		}
+
+		template<typename KeyType, typename Iterator>
+		crstl_forceinline void find_batch_impl(const KeyType* keys, size_t key_count, Iterator* results) const
+		{
+			size_t hash_values[kBatchSize];
+
+			for (size_t batch_start = 0; batch_start < key_count; batch_start += kBatchSize)
+			{
+				const size_t batch_count = key_count - batch_start < kBatchSize ? key_count - batch_start : kBatchSize;
+				prefetch_batch_impl(keys + batch_start, batch_count, hash_values);
+
+				for (size_t i = 0; i < batch_count; ++i)
+				{
+					results[batch_start + i] = Iterator(m_data, m_data + get_bucket_count(), find_impl(keys[batch_start + i], hash_values[i]));
+				}
+			}
+		}
+
+		// Hashmaps store a pair and hashsets store the key directly
+		template<typename K, typename V>
+		crstl_forceinline void insert_key_value_impl(size_t hash_value, const crstl::pair<K, V>& key_value)
+		{
+			find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::find, insert_emplace::insert>(hash_value, key_value.first, key_value.second);
+		}
+
+		crstl_forceinline void insert_key_value_impl(size_t hash_value, const key_type& key)
+		{
+			find_create_reallocate<IsMultipleValue ? exists_behavior::multi : exists_behavior::find, insert_emplace::insert>(hash_value, key);
+		}
+
+		template<typename KeyType>
+		size_t count_impl(const KeyType& key, size_t hash_value) const
+		{
+			const size_t bucket_count = get_bucket_count();
+			const size_t bucket_index = compute_bucket(hash_value);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* const data = (node_type*)m_data;
+			node_type* const start_node = data + bucket_index;
+			node_type* const end_node = data + bucket_count;
+			node_type* crstl_restrict current_node = start_node;
+
+			size_t count = 0;
+
+			do
+			{
+				if (current_node->is_empty())
+				{
+					break;
+				}
+				else if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == key)
+				{
+					++count;
+				}
+
+				current_node++;
+				current_node = (current_node == end_node) ? data : current_node;
+			} while (current_node != start_node);
+
+			crstl_hashmap_stats(m_find_stats.record_find(current_node->is_empty() ? probe_length(start_node, current_node) : bucket_count, count != 0));
+			return count;
+		}
+
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase_impl(const KeyType& key, size_t hash_value)
+		{
+			const size_t bucket_count = get_bucket_count();
+			const size_t bucket_index = compute_bucket(hash_value);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* const data = m_data;
+			node_type* const start_node = data + bucket_index;
+			node_type* const end_node = data + bucket_count;
+			node_type* crstl_restrict current_node = start_node;
+
+			do
+			{
+				// If this is the last node, we've finished our search
+				if (current_node->is_empty())
+				{
+					return 0;
+				}
+				else if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == key)
+				{
+					erase_iter_impl(current_node);
+					return 1;
+				}
+
+				// Otherwise, look for the next node
+				current_node++;
+				current_node = (current_node == end_node) ? data : current_node;
+			} while (current_node != start_node);
+
+			return 0;
 		}
 
 		// Optimized version of insert when we know we are batch inserting key-value types into a clean hashmap
@@ -429,7 +681,7 @@ namespace crstl
 				if (current_node->is_empty())
 				{
 					crstl_placement_new((void*)&(current_node->key_value)) KeyValueType(crstl_forward(KeyValueType, key_value));
-					current_node->set_valid();
+					current_node->set_valid(open_node_base::compute_fingerprint(hash_value));
 					m_length++;
 					return;
 				}
@@ -443,7 +695,7 @@ namespace crstl
 		// bucket if it already has something in it. If we find the object we're looking for, there are a series of different actions we can
 		// take. If we are simply inserting (or emplacing) we just return the object that was there already
 		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
-		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_impl(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_impl(size_t hash_value, KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
 		{
 			// A hashset uses a value_type of void to indicate we want to only store the key. Therefore, trying to insert a value is an error
 			static_assert(crstl::is_void<value_type>::value ? sizeof...(InsertEmplaceArgs) == 0 : true, "Error: hashset does not store a value");
@@ -451,8 +703,8 @@ namespace crstl
 			// Even when we do have a value, trying to insert many is an error, this is meant for a single value
 			static_assert(InsertEmplace == insert_emplace::insert ? sizeof...(InsertEmplaceArgs) < 2 : true, "Error: too many values provided");
 
-			const size_t hash_value = compute_hash_value(key);
 			const size_t bucket_index = compute_bucket(hash_value);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
 			crstl_assert(bucket_index <= get_bucket_count());
 			
 			node_type* const start_node = m_data + bucket_index;
@@ -465,14 +717,15 @@ namespace crstl
 				{
 					node_type* empty_node = current_node;
 
-					empty_node->set_valid();
+					empty_node->set_valid(fingerprint);
 					node_create_selector<key_value_type, value_type, InsertEmplace>::create(empty_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
 					m_length++;
+					crstl_hashmap_stats(m_stats.record_insert(probe_length(start_node, empty_node)));
 					return { iterator(m_data, m_data + get_bucket_count(), empty_node), true };
 				}
 				else crstl_constexpr_if(Behavior != exists_behavior::multi)
 				{
-					if (current_node->get_key() == key)
+					if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == key)
 					{
 						// If our insert behavior is to assign, replace the existing value with the current one
 						crstl_constexpr_if(Behavior == exists_behavior::assign)
@@ -483,11 +736,11 @@ namespace crstl
 								current_node->key_value.~key_value_type();
 							}
 
-							// Create the new one
-							current_node->set_valid();
+							// Create the new one. The key compares equal so the fingerprint stays the same
 							node_create_selector<key_value_type, value_type, InsertEmplace>::create(current_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
 						}
 
+						crstl_hashmap_stats(m_stats.record_insert(probe_length(start_node, current_node)));
 						return { iterator(m_data, m_data + get_bucket_count(), current_node), Behavior == exists_behavior::assign };
 					}
 				}
@@ -503,8 +756,14 @@ namespace crstl
 		template<typename KeyType>
 		crstl_forceinline node_type* find_impl(const KeyType& key) const
 		{
-			const size_t hash_value = compute_hash_value(key);
+			return find_impl(key, compute_hash_value(key));
+		}
+
+		template<typename KeyType>
+		crstl_forceinline node_type* find_impl(const KeyType& key, size_t hash_value) const
+		{
 			const size_t bucket_index = compute_bucket(hash_value);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
 
 			node_type* const data = (node_type*)m_data;
 			node_type* const end_node = data + get_bucket_count();
@@ -515,11 +774,13 @@ namespace crstl
 			{
 				if (current_node->is_empty())
 				{
+					crstl_hashmap_stats(m_find_stats.record_find(probe_length(start_node, current_node), false));
 					return end_node;
 				}
 
-				if (current_node->get_key() == key)
+				if (current_node->is_fingerprint(fingerprint) && current_node->get_key() == key)
 				{
+					crstl_hashmap_stats(m_find_stats.record_find(probe_length(start_node, current_node), true));
 					return current_node;
 				}
 
@@ -527,6 +788,7 @@ namespace crstl
 				current_node = (current_node == end_node) ? data : current_node;
 			} while(current_node != start_node);
 
+			crstl_hashmap_stats(m_find_stats.record_find(get_bucket_count(), false));
 			return end_node;
 		}
 
@@ -548,13 +810,14 @@ namespace crstl
 			node_type* node_to_move = node_to_erase + 1;
 			node_to_move = (node_to_move >= end_node) ? data : node_to_move;
 
+			crstl_hashmap_stats(size_t shift_count = 0);
+
 			do
 			{
 				// We traverse the entire chain until we find an empty node, at which point it
 				// is not possible to reshuffle the node chain further
 				if (node_to_move->is_empty())
 				{
-					empty_slot->set_empty();
 					break;
 				}
 				else
@@ -576,6 +839,7 @@ namespace crstl
 					if (can_move_node)
 					{
 						crstl_placement_new((void*)&(empty_slot->key_value)) key_value_type(crstl_move(node_to_move->key_value));
+						empty_slot->set_valid(node_to_move->meta);
 
 						// Note that we still need to call the destructor here for moved types
 						crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
@@ -584,6 +848,7 @@ namespace crstl
 						}
 
 						empty_slot = node_to_move;
+						crstl_hashmap_stats(shift_count++);
 					}
 				}
 
@@ -591,9 +856,158 @@ namespace crstl
 				node_to_move = (node_to_move == end_node) ? data : node_to_move;
 			} while (node_to_move != node_to_erase);
 
+			// Setting the slot outside the loop also covers a full table, where we never find an empty node
+			empty_slot->set_empty();
+
+			crstl_hashmap_stats(m_stats.record_erase(shift_count));
 			return empty_slot != node_to_erase;
 		}
 
+		// Walk the table once, starting after an empty node. Every node we keep goes to the first empty node from its bucket,
+		// which is never past where it is now. Nodes are only removed from where the walk is, so the nodes between a bucket
+		// and the node we already placed in it stay valid. Holes only exist in the cluster we are walking, so until we
+		// make one there is no need to hash the nodes we keep
+		template<bool EraseMatching, typename Predicate>
+		size_t erase_if_impl(Predicate& predicate)
+		{
+			if (m_length == 0)
+			{
+				return 0;
+			}
+
+			const size_t bucket_count = get_bucket_count();
+			node_type* const data     = m_data;
+			node_type* const end_node = data + bucket_count;
+
+			size_t erased_count = 0;
+			crstl_hashmap_stats(size_t shift_count = 0);
+
+			node_type* start_node = data;
+
+			while (start_node != end_node && !start_node->is_empty())
+			{
+				++start_node;
+			}
+
+			// Nodes before this one have already been checked by the predicate
+			node_type* checked_end_node = data;
+			node_type* hole_node = nullptr;
+			bool has_holes = false;
+
+			// A full table has no empty node to start from, so remove the first matching node to make one. The nodes after
+			// it may belong before it, so the walk starts at the hole and relocates nodes from the start
+			if (start_node == end_node)
+			{
+				node_type* erase_node = data;
+
+				while (erase_node != end_node && (bool)predicate((const key_value_type&)erase_node->key_value) != EraseMatching)
+				{
+					++erase_node;
+				}
+
+				if (erase_node == end_node)
+				{
+					return 0;
+				}
+
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					erase_node->key_value.~key_value_type();
+				}
+
+				erase_node->set_empty();
+				m_length--;
+				erased_count++;
+
+				start_node = erase_node;
+				checked_end_node = erase_node;
+				hole_node = erase_node;
+				has_holes = true;
+			}
+
+			node_type* crstl_restrict current_node = start_node;
+
+			for (size_t i = 1; i < bucket_count; ++i)
+			{
+				current_node++;
+				current_node = (current_node == end_node) ? data : current_node;
+
+				// The walk never reaches a hole it made, so an empty node ends the cluster
+				if (current_node->is_empty())
+				{
+					has_holes = false;
+				}
+				else if (current_node >= checked_end_node && (bool)predicate((const key_value_type&)current_node->key_value) == EraseMatching)
+				{
+					crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+					{
+						current_node->key_value.~key_value_type();
+					}
+
+					current_node->set_empty();
+					m_length--;
+					erased_count++;
+					has_holes = true;
+				}
+				else if (has_holes && erase_if_relocate(current_node))
+				{
+					crstl_hashmap_stats(shift_count++);
+				}
+			}
+
+			// Nodes after the hole whose bucket is before it were placed before the walk reached the nodes in their bucket
+			// range, which may have been removed since. Walk the cluster from the hole again to move them into place
+			if (hole_node)
+			{
+				current_node = hole_node;
+
+				while (!current_node->is_empty())
+				{
+					if (erase_if_relocate(current_node))
+					{
+						crstl_hashmap_stats(shift_count++);
+					}
+
+					current_node++;
+					current_node = (current_node == end_node) ? data : current_node;
+				}
+			}
+
+			crstl_hashmap_stats(m_stats.record_erase_batch(erased_count, shift_count));
+			return erased_count;
+		}
+
+		// Move a node to the first empty node from its bucket, which is never past where it is now
+		bool erase_if_relocate(node_type* current_node)
+		{
+			node_type* const data     = m_data;
+			node_type* const end_node = data + get_bucket_count();
+
+			node_type* target_node = data + compute_bucket(compute_hash_value(current_node->get_key()));
+
+			while (!target_node->is_empty() && target_node != current_node)
+			{
+				target_node++;
+				target_node = (target_node == end_node) ? data : target_node;
+			}
+
+			if (target_node == current_node)
+			{
+				return false;
+			}
+
+			crstl_placement_new((void*)&(target_node->key_value)) key_value_type(crstl_move(current_node->key_value));
+			target_node->set_valid(current_node->meta);
+
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				current_node->key_value.~key_value_type();
+			}
+
+			current_node->set_empty();
+			return true;
+		}
+
 		node_type* begin_impl() const
 		{
 			if (empty())
@@ -617,6 +1031,8 @@ namespace crstl
 
 		void reinsert_all_impl(this_type* hashmap, node_type* crstl_restrict current_node, const node_type* const end_node)
 		{
+			crstl_hashmap_stats(const size_t length = hashmap->m_length);
+
 			for (; current_node != end_node; ++current_node)
 			{
 				if (current_node->is_valid())
@@ -629,12 +1045,31 @@ namespace crstl
 					}
 				}
 			}
+
+			crstl_hashmap_stats(hashmap->m_stats.record_rehash((hashmap->m_length - length) * sizeof(key_value_type)));
 		}
 
-		static crstl_constexpr14 size_t compute_hash_value(const key_type& key)
+		template<typename KeyType>
+		static crstl_constexpr14 size_t compute_hash_value(const KeyType& key)
 		{
-			size_t hash_value = hasher()(key);
+			size_t hash_value = hashmap_hash_selector<hasher, key_type>::hash(key);
 			return hash_value;
 		}
+
+#if defined(CRSTL_HASHMAP_STATS)
+
+		// Nodes visited past the bucket, wrapping around the end of the table
+		size_t probe_length(const node_type* start_node, const node_type* current_node) const
+		{
+			return current_node >= start_node ? (size_t)(current_node - start_node) : (size_t)(current_node - start_node) + get_bucket_count();
+		}
+
+		// Inserts, erases and rehashes
+		hashmap_stats m_stats;
+
+		// Lookups, which are const
+		hashmap_find_stats m_find_stats;
+
+#endif
 	};
 };
\ No newline at end of file
@@ -0,0 +1,483 @@
+#pragma once
+
+#include "crstl/open_hashmap.h"
+
+#include "crstl/forward_declarations.h"
+
+// crstl::open_incremental_hashmap
+//
+// Version of open_hashmap that never moves all of its nodes at once. When the table reaches its load factor we allocate
+// a table twice as large and keep the old one alive. Every insert, emplace and erase by key then migrates a few buckets
+// from the old table to the new one, and lookups consult both tables until the old one is empty. This replaces the
+// single long stall of a rehash with a small amount of work per operation
+//
+// - Each operation migrates kMigrationBucketCount buckets, so it moves at most that many nodes. Nodes that are migrated
+//   or erased from the old table leave a tombstone instead of shifting the rest of their cluster back, and lookups in
+//   the old table probe past them. The old table is freed as a whole once it is empty
+// - Starting a migration is not bounded. It allocates the new table and sets every node in it to empty, a write per
+//   node of the new capacity, although it doesn't hash or move any key. If the load factor is below 1/8 the current
+//   table can fill up before the migration is done, and whatever is left is then migrated at once
+// - Erasing through an iterator does not migrate, so erase loops are safe. Any other modification invalidates iterators
+// - Only unique keys are supported
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Table, bool IsConst>
+	struct open_incremental_iterator
+	{
+	public:
+
+		typedef open_incremental_iterator<Table, IsConst>                                                           this_type;
+		typedef typename hashmap_type_select<IsConst, typename Table::const_iterator, typename Table::iterator>::type table_iterator;
+		typedef typename hashmap_type_select<IsConst, const Table*, Table*>::type                                    table_pointer;
+		typedef typename table_iterator::pointer                                                                     pointer;
+		typedef typename table_iterator::reference                                                                   reference;
+
+		open_incremental_iterator(table_pointer table, table_pointer old_table, table_iterator iter, bool is_old_table)
+			: m_table(table), m_old_table(old_table), m_iter(iter), m_is_old_table(is_old_table) {}
+
+		pointer operator -> () const { return m_iter.operator->(); }
+
+		reference operator * () const { return *m_iter; }
+
+		open_incremental_iterator& operator ++ () { increment(); return *this; }
+
+		open_incremental_iterator operator ++ (int) { open_incremental_iterator temp(*this); increment(); return temp; }
+
+		// The tables are separate allocations, so a node pointer on its own could compare equal to the end of the other table
+		bool operator == (const this_type& other) const { return m_iter == other.m_iter && m_is_old_table == other.m_is_old_table; }
+
+		bool operator != (const this_type& other) const { return !(*this == other); }
+
+		const table_iterator& get_table_iterator() const { return m_iter; }
+
+		bool is_old_table() const { return m_is_old_table; }
+
+		// Iterate the current table first, then whatever is left in the old one
+		void increment()
+		{
+			++m_iter;
+
+			if (!m_is_old_table && m_iter == m_table->end())
+			{
+				m_iter = m_old_table->begin();
+				m_is_old_table = true;
+			}
+		}
+
+	private:
+
+		table_pointer m_table;
+
+		table_pointer m_old_table;
+
+		table_iterator m_iter;
+
+		bool m_is_old_table;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_incremental_hashtable
+	{
+	public:
+
+		typedef open_hashtable<Key, T, Hasher, Allocator, false> table_type;
+		typedef open_incremental_hashtable                       this_type;
+
+		typedef typename table_type::key_type       key_type;
+		typedef typename table_type::value_type     value_type;
+		typedef typename table_type::key_value_type key_value_type;
+		typedef typename table_type::size_type      size_type;
+		typedef typename table_type::node_type      node_type;
+
+		typedef open_incremental_iterator<table_type, false> iterator;
+		typedef open_incremental_iterator<table_type, true>  const_iterator;
+
+		// Buckets of the old table migrated per operation. The new table has room for as many nodes as the old one
+		// held, so the migration finishes before it needs to grow again as long as the load factor is above 1/8
+		static const size_t kMigrationBucketCount = 8;
+
+		crstl_constexpr14 open_incremental_hashtable() crstl_noexcept : m_migration_index(0) {}
+
+		crstl_constexpr14 open_incremental_hashtable(size_t initial_length) crstl_noexcept : m_table(initial_length), m_migration_index(0) {}
+
+		// A copy of the old table doesn't keep the layout, so start the migration from the beginning
+		crstl_constexpr14 open_incremental_hashtable(const open_incremental_hashtable& other) crstl_noexcept
+			: m_table(other.m_table), m_old_table(other.m_old_table), m_migration_index(0)
+		{
+			if (m_old_table.empty())
+			{
+				end_migration();
+			}
+		}
+
+		crstl_constexpr14 open_incremental_hashtable& operator = (const open_incremental_hashtable& other)
+		{
+			m_table = other.m_table;
+			m_old_table = other.m_old_table;
+			m_migration_index = 0;
+
+			if (m_old_table.empty())
+			{
+				end_migration();
+			}
+
+			return *this;
+		}
+
+		crstl_constexpr14 open_incremental_hashtable& operator = (open_incremental_hashtable&& other)
+		{
+			m_table = crstl_move(other.m_table);
+			m_old_table = crstl_move(other.m_old_table);
+			m_migration_index = other.m_migration_index;
+			other.m_migration_index = 0;
+			return *this;
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator begin() crstl_noexcept
+		{
+			return make_iterator(m_table.begin());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator begin() const crstl_noexcept
+		{
+			return make_iterator(m_table.begin());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cbegin() const crstl_noexcept
+		{
+			return make_iterator(m_table.cbegin());
+		}
+
+		crstl_constexpr14 void clear()
+		{
+			m_table.clear();
+			m_old_table.clear();
+			m_old_table.shrink_to_fit();
+			m_migration_index = 0;
+		}
+
+		template<typename KeyType>
+		size_t count(const KeyType& key) const
+		{
+			return (m_table.count(key) != 0 || m_old_table.count(key) != 0) ? 1 : 0;
+		}
+
+		crstl_constexpr bool empty() const { return m_table.empty() && m_old_table.empty(); }
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator end() { return iterator(&m_table, &m_old_table, m_old_table.end(), true); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator end() const { return const_iterator(&m_table, &m_old_table, m_old_table.end(), true); }
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cend() const { return const_iterator(&m_table, &m_old_table, m_old_table.cend(), true); }
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		//--------
+		// emplace
+		//--------
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(const key_type& key, Args&&... args)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.emplace(key, crstl_forward(Args, args)...));
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(key_type&& key, Args&&... args)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.emplace(crstl_forward(key_type, key), crstl_forward(Args, args)...));
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(const key_type& key, Args&&... args)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.emplace_or_assign(key, crstl_forward(Args, args)...));
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(key_type&& key, Args&&... args)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.emplace_or_assign(crstl_forward(key_type, key), crstl_forward(Args, args)...));
+		}
+
+#endif
+
+		//------
+		// erase
+		//------
+
+		crstl_constexpr14 iterator erase(iterator pos)
+		{
+			crstl_assert(pos != end());
+			return erase_impl<iterator>(pos);
+		}
+
+		crstl_constexpr14 const_iterator erase(const_iterator pos)
+		{
+			crstl_assert(pos != cend());
+			return erase_impl<const_iterator>(pos);
+		}
+
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase(KeyType&& key)
+		{
+			migrate_step();
+
+			if (m_table.erase(key) != 0)
+			{
+				return 1;
+			}
+
+			typename table_type::iterator iter = m_old_table.find(key);
+
+			if (iter == m_old_table.end())
+			{
+				return 0;
+			}
+
+			remove_old_node(iter.get_node());
+			return 1;
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard iterator find(const KeyType& key) crstl_noexcept
+		{
+			typename table_type::iterator iter = m_table.find(key);
+
+			if (iter != m_table.end())
+			{
+				return iterator(&m_table, &m_old_table, iter, false);
+			}
+
+			return iterator(&m_table, &m_old_table, m_old_table.find(key), true);
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard const_iterator find(const KeyType& key) const crstl_noexcept
+		{
+			typename table_type::const_iterator iter = m_table.find(key);
+
+			if (iter != m_table.end())
+			{
+				return const_iterator(&m_table, &m_old_table, iter, false);
+			}
+
+			return const_iterator(&m_table, &m_old_table, m_old_table.find(key), true);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(const key_type& key, ValueType&&... value)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.insert(key, crstl_forward(ValueType, value)...));
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(key_type&& key, ValueType&&... value)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.insert(crstl_forward(key_type, key), crstl_forward(ValueType, value)...));
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(const key_type& key, ValueType&&... value)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.insert_or_assign(key, crstl_forward(ValueType, value)...));
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(key_type&& key, ValueType&&... value)
+		{
+			prepare_insert(key);
+			return make_iterator_pair(m_table.insert_or_assign(crstl_forward(key_type, key), crstl_forward(ValueType, value)...));
+		}
+
+		// Whether there is an old table that is still being migrated
+		crstl_nodiscard
+		bool is_rehashing() const { return m_old_table.bucket_count() != 0; }
+
+		crstl_nodiscard
+		float max_load_factor() const { return m_table.max_load_factor(); }
+
+		void max_load_factor(float load_factor)
+		{
+			m_table.max_load_factor(load_factor);
+			m_old_table.max_load_factor(load_factor);
+		}
+
+		crstl_nodiscard
+		size_t size() const { return m_table.size() + m_old_table.size(); }
+
+	private:
+
+		// Wrap an iterator of the current table, moving on to the old table if it's at the end
+		iterator make_iterator(typename table_type::iterator iter)
+		{
+			if (iter == m_table.end())
+			{
+				return iterator(&m_table, &m_old_table, m_old_table.begin(), true);
+			}
+
+			return iterator(&m_table, &m_old_table, iter, false);
+		}
+
+		const_iterator make_iterator(typename table_type::const_iterator iter) const
+		{
+			if (iter == m_table.end())
+			{
+				return const_iterator(&m_table, &m_old_table, m_old_table.begin(), true);
+			}
+
+			return const_iterator(&m_table, &m_old_table, iter, false);
+		}
+
+		pair<iterator, bool> make_iterator_pair(const pair<typename table_type::iterator, bool>& result)
+		{
+			return { make_iterator(result.first), result.second };
+		}
+
+		template<typename Iterator>
+		Iterator erase_impl(Iterator pos)
+		{
+			if (pos.is_old_table())
+			{
+				// The tombstone isn't valid, so the next node is the same before and after removing this one
+				typename Iterator::table_iterator next = pos.get_table_iterator();
+				++next;
+				remove_old_node(pos.get_table_iterator().get_node());
+				return Iterator(&m_table, &m_old_table, next, true);
+			}
+			else
+			{
+				return make_iterator(m_table.erase(pos.get_table_iterator()));
+			}
+		}
+
+		// Grow if the current table is full, which starts a new migration. Then move the key into the current table if
+		// it's still in the old one, so that the insert into the current table sees it. We leave room for both the
+		// migrated node and the new one so that the current table never rehashes by itself
+		template<typename KeyType>
+		void prepare_insert(const KeyType& key)
+		{
+			migrate_step();
+
+			if (m_table.m_length + 1 >= m_table.m_length_threshold)
+			{
+				begin_migration();
+			}
+
+			if (is_rehashing())
+			{
+				typename table_type::iterator iter = m_old_table.find(key);
+
+				if (iter != m_old_table.end())
+				{
+					migrate_node(iter.get_node());
+				}
+			}
+		}
+
+		void begin_migration()
+		{
+			// With a very low load factor we can fill the current table before we're done migrating
+			while (is_rehashing())
+			{
+				migrate_step();
+			}
+
+			table_type::swap(m_table, m_old_table);
+
+			size_t old_capacity = m_old_table.bucket_count();
+			m_table.rehash(old_capacity * 2 < 16 ? 16 : old_capacity * 2);
+			m_migration_index = 0;
+
+			if (m_old_table.empty())
+			{
+				end_migration();
+			}
+		}
+
+		void end_migration()
+		{
+			m_old_table.shrink_to_fit();
+			m_migration_index = 0;
+		}
+
+		// Leave a tombstone so that the nodes after this one stay where they are and can still be found
+		void remove_old_node(node_type* node)
+		{
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				node->key_value.~key_value_type();
+			}
+
+			node->set_tombstone();
+			m_old_table.m_length--;
+		}
+
+		void migrate_node(node_type* node)
+		{
+			m_table.insert_empty_impl(crstl_move(node->key_value));
+			remove_old_node(node);
+		}
+
+		void migrate_step()
+		{
+			if (!is_rehashing())
+			{
+				return;
+			}
+
+			const size_t old_bucket_count = m_old_table.get_bucket_count();
+			const size_t end_index = m_migration_index + kMigrationBucketCount < old_bucket_count ? m_migration_index + kMigrationBucketCount : old_bucket_count;
+
+			for (; m_migration_index < end_index; ++m_migration_index)
+			{
+				node_type* node = m_old_table.m_data + m_migration_index;
+
+				if (node->is_valid())
+				{
+					migrate_node(node);
+				}
+			}
+
+			if (m_old_table.empty() || m_migration_index == old_bucket_count)
+			{
+				crstl_assert(m_old_table.empty());
+				end_migration();
+			}
+		}
+
+		table_type m_table;
+
+		table_type m_old_table;
+
+		// Every bucket of the old table before this index has been migrated and holds no valid node
+		size_t m_migration_index;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class open_incremental_hashmap : public open_incremental_hashtable<Key, T, Hasher, Allocator>
+	{
+		using open_incremental_hashtable<Key, T, Hasher, Allocator>::open_incremental_hashtable;
+	};
+
+	template<typename Key, typename Hasher, typename Allocator>
+	class open_incremental_hashset : public open_incremental_hashtable<Key, void, Hasher, Allocator>
+	{
+		using open_incremental_hashtable<Key, void, Hasher, Allocator>::open_incremental_hashtable;
+	};
+};
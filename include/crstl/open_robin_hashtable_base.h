@@ -0,0 +1,617 @@
+#pragma once
+
+#include "crstl/open_hashtable_base.h"
+
+// open_robin_hashtable_base
+//
+// Open addressing hashtable with linear probing and Robin Hood displacement. Every node stores how far it is from its
+// home bucket, and an insertion takes the slot of the first node that is closer to home than the incoming one, shifting
+// the rest of the cluster forward. This keeps every cluster sorted by home bucket, which gives us
+//
+//  - Lookups that stop as soon as they reach a node closer to home than the probe, instead of at the next empty node
+//  - Backward shift deletion: the nodes after an erased one move back one slot until one is at home or empty
+//  - Probe lengths that stay short and predictable at high load factors
+//
+// The probe distance is stored in a byte. Distances above kMaxStoredProbeDistance only happen with many equal hashes (a
+// weak hash function or many copies of a key in a multimap), and growing the table wouldn't shorten them. Those nodes
+// store an overflow marker instead and their distance is recomputed from the hash of their key when needed, so probes
+// have no maximum length
+
+namespace crstl
+{
+	struct open_robin_node_base
+	{
+		enum node_meta
+		{
+			empty = 0,      // Indicates an empty node. Valid nodes store their probe distance + 1
+			overflow = 255, // The probe distance is larger than kMaxStoredProbeDistance
+		};
+
+		static const size_t kMaxStoredProbeDistance = 253;
+
+		bool is_empty() const { return meta == node_meta::empty; }
+		bool is_valid() const { return meta != node_meta::empty; }
+		void set_valid(size_t probe_distance, unsigned char hash_fingerprint)
+		{
+			meta = probe_distance <= kMaxStoredProbeDistance ? (unsigned char)(probe_distance + 1) : (unsigned char)node_meta::overflow;
+			fingerprint = hash_fingerprint;
+		}
+
+		void set_empty() { meta = (unsigned char)node_meta::empty; }
+
+		unsigned char meta;
+
+		// Same hash fingerprint as open_node_base, used to skip most key comparisons
+		unsigned char fingerprint;
+	};
+
+	template<typename Key, typename Value>
+	struct open_robin_node : public open_robin_node_base
+	{
+		const Key& get_key() const { return key_value.first; }
+
+		const Value& get_value() const { return key_value.second; }
+
+		crstl::pair<Key, Value> key_value;
+	};
+
+	template<typename Key>
+	struct open_robin_node<Key, void> : public open_robin_node_base
+	{
+		const Key& get_key() const { return key_value; }
+
+		void get_value() const {}
+
+		Key key_value;
+	};
+
+	template<typename HashmapStorage, bool IsMultipleValue = false>
+	class open_robin_hashtable_base : public HashmapStorage
+	{
+	public:
+
+		typedef HashmapStorage            storage_type;
+		typedef open_robin_hashtable_base this_type;
+
+		typedef typename HashmapStorage::key_type       key_type;
+		typedef typename HashmapStorage::value_type     value_type;
+		typedef typename HashmapStorage::key_value_type key_value_type;
+		typedef typename HashmapStorage::hasher         hasher;
+		typedef typename HashmapStorage::iterator       iterator;
+		typedef typename HashmapStorage::const_iterator const_iterator;
+		typedef typename HashmapStorage::node_type      node_type;
+
+		using storage_type::m_data;
+		using storage_type::m_length;
+
+		using storage_type::compute_bucket;
+		using storage_type::get_bucket_count;
+		using storage_type::reallocate_rehash_if_length_above_load_factor;
+		using storage_type::reallocate_rehash_if_length_above_capacity;
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator begin() crstl_noexcept
+		{
+			return iterator(m_data, m_data + get_bucket_count(), begin_impl());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator begin() const crstl_noexcept
+		{
+			return const_iterator(m_data, m_data + get_bucket_count(), begin_impl());
+		}
+
+		crstl_nodiscard
+		crstl_constexpr14 const_iterator cbegin() const crstl_noexcept
+		{
+			return const_iterator(m_data, m_data + get_bucket_count(), begin_impl());
+		}
+
+		crstl_constexpr14 void clear()
+		{
+			if (m_length != 0)
+			{
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					for (const key_value_type& iter : *this)
+					{
+						iter.~key_value_type();
+					}
+				}
+
+				for (size_t i = 0; i < get_bucket_count(); ++i)
+				{
+					m_data[i].set_empty();
+				}
+
+				m_length = 0;
+			}
+		}
+
+		crstl_constexpr bool empty() const { return m_length == 0; }
+
+		crstl_nodiscard
+		crstl_constexpr14 iterator end() { return iterator(m_data, (node_type*)(m_data + get_bucket_count()), (node_type*)(m_data + get_bucket_count())); }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator end() const { return const_iterator(m_data, (node_type*)(m_data + get_bucket_count()), (node_type*)(m_data + get_bucket_count())); }
+
+		crstl_nodiscard
+		crstl_constexpr const_iterator cend() const { return const_iterator(m_data, (node_type*)(m_data + get_bucket_count()), (node_type*)(m_data + get_bucket_count())); }
+
+		template<typename KeyType>
+		size_t count(const KeyType& key) const
+		{
+			const size_t hash_value = compute_hash_value(key);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* crstl_restrict current_node = (node_type*)m_data + compute_bucket(hash_value);
+
+			size_t count = 0;
+
+			for (size_t probe_distance = 0; is_probe_reachable(current_node, probe_distance); ++probe_distance)
+			{
+				if (current_node->fingerprint == fingerprint && current_node->get_key() == key)
+				{
+					++count;
+
+					crstl_constexpr_if(!IsMultipleValue)
+					{
+						break;
+					}
+				}
+
+				current_node = next_node(current_node);
+			}
+
+			return count;
+		}
+
+#if defined(CRSTL_FEATURE_VARIADIC_TEMPLATES)
+
+		//--------
+		// emplace
+		//--------
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(const key_type& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::find>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace(key_type&& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::find>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(const key_type& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::assign>(key, crstl_forward(Args, args)...);
+		}
+
+		template<typename... Args>
+		crstl_constexpr14 pair<iterator, bool> emplace_or_assign(key_type&& key, Args&&... args)
+		{
+			return emplace_impl<exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(Args, args)...);
+		}
+
+#endif
+
+		//------
+		// erase
+		//------
+
+		crstl_constexpr14 iterator erase(iterator pos)
+		{
+			crstl_assert(pos != end());
+			iterator next_iter = pos;
+			bool moved_node = erase_iter_impl(pos.get_node());
+			return moved_node ? pos : ++next_iter;
+		}
+
+		crstl_constexpr14 const_iterator erase(const_iterator pos)
+		{
+			crstl_assert(pos != cend());
+			const_iterator next_iter = pos;
+			bool moved_node = erase_iter_impl(pos.get_node());
+			return moved_node ? pos : ++next_iter;
+		}
+
+		template<typename KeyType>
+		crstl_constexpr14 size_t erase(KeyType&& key)
+		{
+			node_type* found_node = find_impl(key);
+
+			if (found_node != m_data + get_bucket_count())
+			{
+				erase_iter_impl(found_node);
+				return 1;
+			}
+
+			return 0;
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard iterator find(const KeyType& key) crstl_noexcept
+		{
+			node_type* found_node = find_impl(key);
+			return iterator(m_data, m_data + get_bucket_count(), found_node);
+		}
+
+		template<typename KeyType>
+		crstl_nodiscard const_iterator find(const KeyType& key) const crstl_noexcept
+		{
+			node_type* found_node = find_impl(key);
+			return const_iterator(m_data, m_data + get_bucket_count(), found_node);
+		}
+
+		template<typename KeyType, typename Function>
+		void for_each(KeyType&& key, Function&& function)
+		{
+			const size_t hash_value = compute_hash_value(key);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* crstl_restrict current_node = (node_type*)m_data + compute_bucket(hash_value);
+
+			for (size_t probe_distance = 0; is_probe_reachable(current_node, probe_distance); ++probe_distance)
+			{
+				if (current_node->fingerprint == fingerprint && current_node->get_key() == key)
+				{
+					function(current_node->get_value());
+
+					crstl_constexpr_if(!IsMultipleValue)
+					{
+						return;
+					}
+				}
+
+				current_node = next_node(current_node);
+			}
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(const key_type& key, ValueType&&... value)
+		{
+			return insert_impl<IsMultipleValue ? exists_behavior::multi : exists_behavior::find>(key, crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert(key_type&& key, ValueType&&... value)
+		{
+			return insert_impl<IsMultipleValue ? exists_behavior::multi : exists_behavior::find>(crstl_forward(key_type, key), crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(const key_type& key, ValueType&&... value)
+		{
+			return insert_impl<IsMultipleValue ? exists_behavior::multi : exists_behavior::assign>(key, crstl_forward(ValueType, value)...);
+		}
+
+		template<typename... ValueType>
+		pair<iterator, bool> insert_or_assign(key_type&& key, ValueType&&... value)
+		{
+			return insert_impl<IsMultipleValue ? exists_behavior::multi : exists_behavior::assign>(crstl_forward(key_type, key), crstl_forward(ValueType, value)...);
+		}
+
+		// Longest probe sequence a successful lookup currently needs, i.e. the number of nodes it inspects. This walks
+		// all the buckets, so it is meant for monitoring rather than for hot paths
+		crstl_nodiscard
+		size_t max_probe_length() const
+		{
+			size_t max_probe_length = 0;
+
+			for (size_t i = 0; i < get_bucket_count(); ++i)
+			{
+				if (m_data[i].is_valid())
+				{
+					const size_t probe_length = get_probe_distance(&m_data[i]) + 1;
+					max_probe_length = probe_length > max_probe_length ? probe_length : max_probe_length;
+				}
+			}
+
+			return max_probe_length;
+		}
+
+		void reserve(size_t capacity)
+		{
+			reallocate_rehash_if_length_above_capacity(capacity, [this](node_type* crstl_restrict current_node, const node_type* const end_node)
+			{
+				reinsert_all_impl(this, current_node, end_node);
+			});
+		}
+
+		crstl_nodiscard
+		size_t size() const { return m_length; }
+
+	protected:
+
+		template<exists_behavior::t Behavior, typename KeyType, typename... Args>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> emplace_impl(KeyType&& key, Args&&... args)
+		{
+			return find_create_reallocate<Behavior, insert_emplace::emplace>(crstl_forward(KeyType, key), crstl_forward(Args, args)...);
+		}
+
+		template<exists_behavior::t Behavior, typename KeyType, typename... ValueTypes>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> insert_impl(KeyType&& key, ValueTypes&&... value)
+		{
+			return find_create_reallocate<Behavior, insert_emplace::insert>(crstl_forward(KeyType, key), crstl_forward(ValueTypes, value)...);
+		}
+
+		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_reallocate(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		{
+			reallocate_rehash_if_length_above_load_factor([this](node_type* crstl_restrict current_node, const node_type* const end_node)
+			{
+				reinsert_all_impl(this, current_node, end_node);
+			});
+
+			return find_create_impl<Behavior, InsertEmplace>(crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+		}
+
+		crstl_forceinline node_type* next_node(node_type* node) const
+		{
+			node_type* const data = (node_type*)m_data;
+			node++;
+			return node == data + get_bucket_count() ? data : node;
+		}
+
+		// Distance of a valid node from its home bucket. Overflowing distances are recomputed from the hash of the key
+		crstl_forceinline size_t get_probe_distance(const node_type* node) const
+		{
+			if (node->meta != open_robin_node_base::node_meta::overflow)
+			{
+				return (size_t)node->meta - 1;
+			}
+
+			const size_t home_bucket = compute_bucket(compute_hash_value(node->get_key()));
+			const size_t bucket = (size_t)(node - (const node_type*)m_data);
+			return bucket >= home_bucket ? bucket - home_bucket : bucket + get_bucket_count() - home_bucket;
+		}
+
+		// Whether a node at this position can still belong to a probe that is probe_distance slots away from home. A node
+		// that is closer to its home bucket would have been displaced by the key we're looking for. Empty nodes never are.
+		// An overflow marker is only resolved once the probe itself is past the distances a byte can store
+		crstl_forceinline bool is_probe_reachable(const node_type* node, size_t probe_distance) const
+		{
+			return node->meta > probe_distance || (node->meta == open_robin_node_base::node_meta::overflow && get_probe_distance(node) >= probe_distance);
+		}
+
+		// Move every node from insert_node up to the next empty one forward by one slot, so that insert_node can take a new
+		// node. Returns false without modifying anything if the table is full
+		crstl_forceinline crstl_constexpr14 bool shift_forward_impl(node_type* insert_node)
+		{
+			node_type* empty_node = insert_node;
+
+			while (empty_node->is_valid())
+			{
+				empty_node = next_node(empty_node);
+
+				// The table is full, there is nowhere to shift to
+				if (empty_node == insert_node)
+				{
+					return false;
+				}
+			}
+
+			node_type* const data = m_data;
+			node_type* const last_node = data + get_bucket_count() - 1;
+
+			while (empty_node != insert_node)
+			{
+				node_type* node_to_move = empty_node == data ? last_node : empty_node - 1;
+
+				// Overflowing distances are recomputed from the key, so take it before the key is moved from
+				const size_t probe_distance = get_probe_distance(node_to_move);
+
+				crstl_placement_new((void*)&(empty_node->key_value)) key_value_type(crstl_move(node_to_move->key_value));
+				empty_node->set_valid(probe_distance + 1, node_to_move->fingerprint);
+
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					node_to_move->key_value.~key_value_type();
+				}
+
+				empty_node = node_to_move;
+			}
+
+			return true;
+		}
+
+		// Optimized version of insert when we know we are batch inserting key-value types into a clean hashmap
+		// We can skip iterator construction and the comparison with the key
+		inline crstl_constexpr14 void insert_empty_impl(const key_value_type& key_value)
+		{
+			insert_empty_impl(crstl_forward(const key_value_type, key_value));
+		}
+
+		template<typename KeyValueType>
+		inline crstl_constexpr14 void insert_empty_impl(KeyValueType&& key_value)
+		{
+			const size_t hash_value = compute_hash_value(get_key(key_value));
+
+			node_type* current_node = m_data + compute_bucket(hash_value);
+			size_t probe_distance = 0;
+
+			while (is_probe_reachable(current_node, probe_distance))
+			{
+				current_node = next_node(current_node);
+				probe_distance++;
+			}
+
+			// Only a full fixed table has nowhere to shift to. Drop the node rather than overwrite another one
+			if (!shift_forward_impl(current_node))
+			{
+				crstl_assert_msg(false, "Hashtable is full");
+				return;
+			}
+
+			crstl_placement_new((void*)&(current_node->key_value)) KeyValueType(crstl_forward(KeyValueType, key_value));
+			current_node->set_valid(probe_distance, open_node_base::compute_fingerprint(hash_value));
+			m_length++;
+		}
+
+		// Walk the probe sequence while the nodes are at least as far from home as the key. For maps that hold unique keys
+		// this is where the key could be. The first node that is closer to home (or empty) is where the key goes, after
+		// making room by shifting the cluster forward. Only a full fixed table has no room, and then nothing is inserted
+		template<exists_behavior::t Behavior, insert_emplace::t InsertEmplace, typename KeyType, typename... InsertEmplaceArgs>
+		crstl_forceinline crstl_constexpr14 pair<iterator, bool> find_create_impl(KeyType&& key, InsertEmplaceArgs&&... insert_emplace_args)
+		{
+			// A hashset uses a value_type of void to indicate we want to only store the key. Therefore, trying to insert a value is an error
+			static_assert(crstl::is_void<value_type>::value ? sizeof...(InsertEmplaceArgs) == 0 : true, "Error: hashset does not store a value");
+
+			// Even when we do have a value, trying to insert many is an error, this is meant for a single value
+			static_assert(InsertEmplace == insert_emplace::insert ? sizeof...(InsertEmplaceArgs) < 2 : true, "Error: too many values provided");
+
+			const size_t hash_value = compute_hash_value(key);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* current_node = m_data + compute_bucket(hash_value);
+			size_t probe_distance = 0;
+
+			while (is_probe_reachable(current_node, probe_distance))
+			{
+				crstl_constexpr_if(Behavior != exists_behavior::multi)
+				{
+					if (current_node->fingerprint == fingerprint && current_node->get_key() == key)
+					{
+						// If our insert behavior is to assign, replace the existing value with the current one
+						crstl_constexpr_if(Behavior == exists_behavior::assign)
+						{
+							crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+							{
+								current_node->key_value.~key_value_type();
+							}
+
+							node_create_selector<key_value_type, value_type, InsertEmplace>::create(current_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+						}
+
+						return { iterator(m_data, m_data + get_bucket_count(), current_node), Behavior == exists_behavior::assign };
+					}
+				}
+
+				current_node = next_node(current_node);
+				probe_distance++;
+			}
+
+			if (!shift_forward_impl(current_node))
+			{
+				crstl_assert_msg(false, "Hashtable is full");
+				return { end(), false };
+			}
+
+			node_create_selector<key_value_type, value_type, InsertEmplace>::create(current_node, crstl_forward(KeyType, key), crstl_forward(InsertEmplaceArgs, insert_emplace_args)...);
+			current_node->set_valid(probe_distance, fingerprint);
+			m_length++;
+			return { iterator(m_data, m_data + get_bucket_count(), current_node), true };
+		}
+
+		template<typename KeyType>
+		crstl_forceinline node_type* find_impl(const KeyType& key) const
+		{
+			const size_t hash_value = compute_hash_value(key);
+			const unsigned char fingerprint = open_node_base::compute_fingerprint(hash_value);
+
+			node_type* crstl_restrict current_node = (node_type*)m_data + compute_bucket(hash_value);
+
+			for (size_t probe_distance = 0; is_probe_reachable(current_node, probe_distance); ++probe_distance)
+			{
+				if (current_node->fingerprint == fingerprint && current_node->get_key() == key)
+				{
+					return current_node;
+				}
+
+				current_node = next_node(current_node);
+			}
+
+			return (node_type*)m_data + get_bucket_count();
+		}
+
+		// Backward shift deletion. Every node after the erased one that is not in its home bucket moves back one slot,
+		// which leaves the table exactly as if the erased node had never been inserted. Returns whether a node that the
+		// iterator hasn't visited yet took the place of the erased one
+		crstl_forceinline crstl_constexpr14 bool erase_iter_impl(node_type* node_to_erase)
+		{
+			crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+			{
+				node_to_erase->key_value.~key_value_type();
+			}
+
+			m_length--;
+
+			node_type* empty_slot = node_to_erase;
+			node_type* node_to_move = next_node(node_to_erase);
+
+			while (node_to_move != node_to_erase && node_to_move->is_valid())
+			{
+				const size_t probe_distance = get_probe_distance(node_to_move);
+
+				if (probe_distance == 0)
+				{
+					break;
+				}
+
+				crstl_placement_new((void*)&(empty_slot->key_value)) key_value_type(crstl_move(node_to_move->key_value));
+				empty_slot->set_valid(probe_distance - 1, node_to_move->fingerprint);
+
+				crstl_constexpr_if(!crstl_is_trivially_destructible(key_value_type))
+				{
+					node_to_move->key_value.~key_value_type();
+				}
+
+				empty_slot = node_to_move;
+				node_to_move = next_node(node_to_move);
+			}
+
+			empty_slot->set_empty();
+
+			// If the node we moved into the erased slot wrapped around from the beginning, iteration has already seen it
+			return empty_slot != node_to_erase && node_to_erase + 1 != m_data + get_bucket_count();
+		}
+
+		node_type* begin_impl() const
+		{
+			if (empty())
+			{
+				return (node_type*)(m_data + get_bucket_count());
+			}
+			else
+			{
+				node_type* valid_node = (node_type*)m_data;
+				while (true)
+				{
+					if (valid_node->is_valid())
+					{
+						return valid_node;
+					}
+
+					valid_node++;
+				}
+			}
+		}
+
+		void reinsert_all_impl(this_type* hashmap, node_type* crstl_restrict current_node, const node_type* const end_node)
+		{
+			for (; current_node != end_node; ++current_node)
+			{
+				if (current_node->is_valid())
+				{
+					hashmap->insert_empty_impl(crstl_move(current_node->key_value));
+
+					crstl_constexpr_if(!crstl_is_trivially_destructible(node_type))
+					{
+						current_node->~node_type();
+					}
+				}
+			}
+		}
+
+		template<typename KeyType>
+		static crstl_constexpr14 size_t compute_hash_value(const KeyType& key)
+		{
+			size_t hash_value = hashmap_hash_selector<hasher, key_type>::hash(key);
+			return hash_value;
+		}
+	};
+};
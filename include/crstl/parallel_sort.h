@@ -0,0 +1,387 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/crstldef.h"
+
+#include "crstl/sort.h"
+
+#include "crstl/thread.h"
+
+#include "crstl/utility/memory_ops.h"
+
+// crstl::parallel_sort
+//
+// Sample sort that runs on crstl::thread. The calling thread does part of the work and returns once the range is sorted
+//
+// - Elements are sampled, and the sorted samples give a splitter per thread. Each thread counts how many elements of
+//   its part of the range go between each pair of splitters, then moves them into the temp buffer. Each thread then
+//   quick sorts one bucket and moves it back
+// - Splitters are copies of elements, so T must be copyable as well as movable
+// - Many elements that compare equal to a splitter end up in the same bucket, so inputs with few unique values don't
+//   balance well between threads
+//
+// crstl::parallel_radix_sort
+//
+// radix_sort on crstl::thread. Every pass, each thread counts the digits of its part of the range, and the counts of
+// all threads give each one the offsets it writes its elements to. Elements keep their order within a digit, as in
+// radix_sort
+//
+// - Both sorts take a temp buffer of at least as many elements as the range and don't allocate
+// - Threads are created for every step and joined at its end. Small ranges are sorted on the calling thread
+// - The counts of every thread live on the stack of the calling thread, sized by the number of threads. That is 1KB per
+//   thread for parallel_radix_sort, or thread_count * thread_count size_t for parallel_sort. parallel_radix_sort can
+//   also take the counts from the caller, see parallel_radix_sort_count_size(), for threads with a small stack
+//
+
+crstl_module_export namespace crstl
+{
+	enum : size_t
+	{
+		kMaxParallelSortThreads = 32,
+
+		// Fewer elements per thread than this are not worth the cost of starting threads
+		kMinParallelSortSize = 32 * 1024
+	};
+
+	namespace detail
+	{
+		enum : size_t
+		{
+			kParallelSortSamplesPerThread = 64
+		};
+
+		inline size_t compute_parallel_sort_thread_count(size_t size, size_t thread_count)
+		{
+			const size_t max_thread_count = size / kMinParallelSortSize;
+			thread_count = thread_count < max_thread_count ? thread_count : max_thread_count;
+			return thread_count < (size_t)kMaxParallelSortThreads ? thread_count : (size_t)kMaxParallelSortThreads;
+		}
+
+		// Call function(thread_index) on thread_count threads, the calling thread being the first, and wait for all of them
+		template<typename Function>
+		void run_parallel_sort(size_t thread_count, Function& function)
+		{
+			crstl::thread_parameters parameters;
+			crstl::thread threads[kMaxParallelSortThreads];
+
+			for (size_t t = 1; t < thread_count; ++t)
+			{
+				threads[t] = crstl::thread(parameters, function, (size_t)t);
+			}
+
+			function((size_t)0);
+
+			for (size_t t = 1; t < thread_count; ++t)
+			{
+				threads[t].join();
+			}
+		}
+
+		// Storage for splitters without requiring T to be default constructible
+		template<typename T, size_t Count>
+		struct parallel_sort_splitters
+		{
+			parallel_sort_splitters() {}
+
+			~parallel_sort_splitters() {}
+
+			crstl_warning_anonymous_struct_union_begin
+			union
+			{
+				struct { T data[Count]; };
+			};
+			crstl_warning_anonymous_struct_union_end
+		};
+	}
+
+	template<typename T, typename Compare>
+	void parallel_sort(T* begin, T* end, Compare compare, T* temp_buffer, size_t thread_count)
+	{
+		crstl_assert(end >= begin);
+
+		const size_t size = (size_t)(end - begin);
+
+		thread_count = detail::compute_parallel_sort_thread_count(size, thread_count);
+
+		if (thread_count <= 1)
+		{
+			quick_sort(begin, end, compare);
+			return;
+		}
+
+		crstl_assert(temp_buffer != nullptr);
+
+		// Take one sample from each stretch of the range, at a pseudo random position within it so that periodic
+		// patterns don't line up with the samples
+		const size_t sample_count = thread_count * detail::kParallelSortSamplesPerThread;
+		const size_t sample_stride = size / sample_count;
+
+		uint32_t seed = 0x9e3779b9u;
+
+		for (size_t i = 0; i < sample_count; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			temp_buffer[i] = begin[i * sample_stride + (size_t)(seed >> 8) % sample_stride];
+		}
+
+		quick_sort(temp_buffer, temp_buffer + sample_count, compare);
+
+		const size_t splitter_count = thread_count - 1;
+
+		detail::parallel_sort_splitters<T, kMaxParallelSortThreads - 1> splitters;
+
+		for (size_t i = 0; i < splitter_count; ++i)
+		{
+			crstl_placement_new((void*)&splitters.data[i]) T(temp_buffer[(i + 1) * detail::kParallelSortSamplesPerThread]);
+		}
+
+		// Bucket b takes the elements that are less than splitter b and not less than splitter b - 1
+		auto find_bucket = [&](const T& value) -> size_t
+		{
+			size_t first = 0;
+			size_t count = splitter_count;
+
+			while (count > 0)
+			{
+				const size_t half_count = count / 2;
+
+				if (compare(value, splitters.data[first + half_count]))
+				{
+					count = half_count;
+				}
+				else
+				{
+					first += half_count + 1;
+					count -= half_count + 1;
+				}
+			}
+
+			return first;
+		};
+
+		// bucket_offsets[t * thread_count + b] is the number of elements of thread t that go into bucket b, and once the
+		// counts are summed, the position in the temp buffer where thread t writes them
+		size_t* bucket_offsets = (size_t*)crstl_alloca(thread_count * thread_count * sizeof(size_t));
+		size_t bucket_starts[kMaxParallelSortThreads + 1];
+
+		auto count_buckets = [&](size_t thread_index)
+		{
+			size_t* counts = bucket_offsets + thread_index * thread_count;
+
+			for (size_t b = 0; b < thread_count; ++b)
+			{
+				counts[b] = 0;
+			}
+
+			for (T* element = begin + size * thread_index / thread_count; element != begin + size * (thread_index + 1) / thread_count; ++element)
+			{
+				counts[find_bucket(*element)]++;
+			}
+		};
+
+		detail::run_parallel_sort(thread_count, count_buckets);
+
+		size_t offset = 0;
+
+		for (size_t b = 0; b < thread_count; ++b)
+		{
+			bucket_starts[b] = offset;
+
+			for (size_t t = 0; t < thread_count; ++t)
+			{
+				const size_t count = bucket_offsets[t * thread_count + b];
+				bucket_offsets[t * thread_count + b] = offset;
+				offset += count;
+			}
+		}
+
+		bucket_starts[thread_count] = offset;
+
+		auto scatter_buckets = [&](size_t thread_index)
+		{
+			size_t* offsets = bucket_offsets + thread_index * thread_count;
+
+			for (T* element = begin + size * thread_index / thread_count; element != begin + size * (thread_index + 1) / thread_count; ++element)
+			{
+				temp_buffer[offsets[find_bucket(*element)]++] = crstl_move(*element);
+			}
+		};
+
+		detail::run_parallel_sort(thread_count, scatter_buckets);
+
+		auto sort_buckets = [&](size_t thread_index)
+		{
+			T* bucket_begin = temp_buffer + bucket_starts[thread_index];
+			T* bucket_end = temp_buffer + bucket_starts[thread_index + 1];
+
+			quick_sort(bucket_begin, bucket_end, compare);
+
+			for (T* element = bucket_begin; element != bucket_end; ++element)
+			{
+				begin[element - temp_buffer] = crstl_move(*element);
+			}
+		};
+
+		detail::run_parallel_sort(thread_count, sort_buckets);
+
+		crstl_constexpr_if(!crstl_is_trivially_destructible(T))
+		{
+			for (size_t i = 0; i < splitter_count; ++i)
+			{
+				splitters.data[i].~T();
+			}
+		}
+	}
+
+	template<typename T>
+	void parallel_sort(T* begin, T* end, T* temp_buffer, size_t thread_count)
+	{
+		parallel_sort(begin, end, less<>{}, temp_buffer, thread_count);
+	}
+
+	enum : size_t
+	{
+		kParallelRadixSortBucketCount = 256
+	};
+
+	// Number of uint32_t parallel_radix_sort needs for its counts with this many threads
+	crstl_constexpr size_t parallel_radix_sort_count_size(size_t thread_count)
+	{
+		return (thread_count < (size_t)kMaxParallelSortThreads ? thread_count : (size_t)kMaxParallelSortThreads) * kParallelRadixSortBucketCount;
+	}
+
+	// Sort with counts that live in count_buffer, of at least parallel_radix_sort_count_size(thread_count) elements
+	template<typename T>
+	void parallel_radix_sort(T* begin, T* end, T* temp_buffer, uint32_t* count_buffer, size_t thread_count)
+	{
+		crstl_assert(end >= begin);
+
+		typedef typename radix_sort_key<T>::radix_type radix_type;
+
+		const size_t size = (size_t)(end - begin);
+
+		thread_count = detail::compute_parallel_sort_thread_count(size, thread_count);
+
+		if (thread_count <= 1)
+		{
+			radix_sort(begin, end, temp_buffer);
+			return;
+		}
+
+		crstl_assert(temp_buffer != nullptr);
+		crstl_assert(count_buffer != nullptr);
+		crstl_assert(size <= 0xffffffffu);
+
+		static const size_t kBitsPerPass = 8;
+		static const size_t kBitCount    = sizeof(radix_type) * 8;
+		static const size_t kPassCount   = kBitCount / kBitsPerPass;
+		static const size_t kBucketCount = size_t(1) << kBitsPerPass;
+		static const size_t kBitmask     = kBucketCount - size_t(1);
+
+		static_assert(kBucketCount == kParallelRadixSortBucketCount, "Count buffer size doesn't match the digit size");
+
+		// bucket_offsets[t * kBucketCount + b] is the number of elements of thread t with digit b, and once the counts are
+		// summed, the position in the output where thread t writes them
+		uint32_t* bucket_offsets = count_buffer;
+
+		T* input = begin;
+		T* output = temp_buffer;
+
+		size_t pass_count = 0;
+
+		for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
+		{
+			const size_t pass_shift = pass_index * kBitsPerPass;
+
+			auto count_digits = [&](size_t thread_index)
+			{
+				uint32_t* counts = bucket_offsets + thread_index * kBucketCount;
+
+				for (size_t b = 0; b < kBucketCount; ++b)
+				{
+					counts[b] = 0;
+				}
+
+				for (T* element = input + size * thread_index / thread_count; element != input + size * (thread_index + 1) / thread_count; ++element)
+				{
+					counts[(size_t)((radix_sort_key<T>::extract(*element) >> pass_shift) & kBitmask)]++;
+				}
+			};
+
+			detail::run_parallel_sort(thread_count, count_digits);
+
+			// Skip the pass if every element has the same digit
+			bool all_buckets_equal = false;
+			uint32_t offset = 0;
+
+			for (size_t b = 0; b < kBucketCount && !all_buckets_equal; ++b)
+			{
+				size_t bucket_count = 0;
+
+				for (size_t t = 0; t < thread_count; ++t)
+				{
+					const uint32_t count = bucket_offsets[t * kBucketCount + b];
+					bucket_offsets[t * kBucketCount + b] = offset;
+					offset += count;
+					bucket_count += count;
+				}
+
+				all_buckets_equal = bucket_count == size;
+			}
+
+			if (all_buckets_equal)
+			{
+				continue;
+			}
+
+			auto scatter_digits = [&](size_t thread_index)
+			{
+				uint32_t* offsets = bucket_offsets + thread_index * kBucketCount;
+
+				for (T* element = input + size * thread_index / thread_count; element != input + size * (thread_index + 1) / thread_count; ++element)
+				{
+					const size_t bucket_entry = (size_t)((radix_sort_key<T>::extract(*element) >> pass_shift) & kBitmask);
+					output[offsets[bucket_entry]++] = crstl_move(*element);
+				}
+			};
+
+			detail::run_parallel_sort(thread_count, scatter_digits);
+
+			T* temp = input;
+			input = output;
+			output = temp;
+
+			pass_count++;
+		}
+
+		// If the last output was written to the temp buffer we need to move it back out
+		if (pass_count & 1)
+		{
+			auto move_back = [&](size_t thread_index)
+			{
+				for (size_t i = size * thread_index / thread_count; i != size * (thread_index + 1) / thread_count; ++i)
+				{
+					begin[i] = crstl_move(temp_buffer[i]);
+				}
+			};
+
+			detail::run_parallel_sort(thread_count, move_back);
+		}
+	}
+
+	template<typename T>
+	void parallel_radix_sort(T* begin, T* end, T* temp_buffer, size_t thread_count)
+	{
+		thread_count = detail::compute_parallel_sort_thread_count((size_t)(end - begin), thread_count);
+
+		if (thread_count <= 1)
+		{
+			radix_sort(begin, end, temp_buffer);
+			return;
+		}
+
+		uint32_t* count_buffer = (uint32_t*)crstl_alloca(parallel_radix_sort_count_size(thread_count) * sizeof(uint32_t));
+		parallel_radix_sort(begin, end, temp_buffer, count_buffer, thread_count);
+	}
+};
@@ -6,7 +6,7 @@
 
 #define crstl_atomic_store16(target, value) __sync_lock_test_and_set((short*)(target), (value))
 
-#define crstl_atomic_store32(target, value) __sync_lock_test_and_set((long*)(target), (value))
+#define crstl_atomic_store32(target, value) __sync_lock_test_and_set((int32_t*)(target), (value))
 
 #define crstl_atomic_store64(target, value) __sync_lock_test_and_set((long long*)(target), (value))
 
@@ -16,7 +16,7 @@
 
 #define crstl_atomic_add16(target, value) __sync_fetch_and_add((short*)(target), (value))
 
-#define crstl_atomic_add32(target, value) __sync_fetch_and_add((long*)(target), (value))
+#define crstl_atomic_add32(target, value) __sync_fetch_and_add((int32_t*)(target), (value))
 
 #define crstl_atomic_add64(target, value) __sync_fetch_and_add((long long*)(target), (value))
 
@@ -26,7 +26,7 @@
 
 #define crstl_atomic_sub16(target, value) __sync_fetch_and_sub((short*)(target), (value))
 
-#define crstl_atomic_sub32(target, value) __sync_fetch_and_sub((long*)(target), (value))
+#define crstl_atomic_sub32(target, value) __sync_fetch_and_sub((int32_t*)(target), (value))
 
 #define crstl_atomic_sub64(target, value) __sync_fetch_and_sub((long long*)(target), (value))
 
@@ -36,7 +36,7 @@
 
 #define crstl_atomic_and16(target, value) __sync_fetch_and_and((short*)(target), (value))
 
-#define crstl_atomic_and32(target, value) __sync_fetch_and_and((long*)(target), (value))
+#define crstl_atomic_and32(target, value) __sync_fetch_and_and((int32_t*)(target), (value))
 
 #define crstl_atomic_and64(target, value) __sync_fetch_and_and((long long*)(target), (value))
 
@@ -46,7 +46,7 @@
 
 #define crstl_atomic_or16(target, value) __sync_fetch_and_or((short*)(target), (value))
 
-#define crstl_atomic_or32(target, value) __sync_fetch_and_or((long*)(target), (value))
+#define crstl_atomic_or32(target, value) __sync_fetch_and_or((int32_t*)(target), (value))
 
 #define crstl_atomic_or64(target, value) __sync_fetch_and_or((long long*)(target), (value))
 
@@ -56,6 +56,32 @@
 
 #define crstl_atomic_xor16(target, value) __sync_fetch_and_xor((short*)(target), (value))
 
-#define crstl_atomic_xor32(target, value) __sync_fetch_and_xor((long*)(target), (value))
+#define crstl_atomic_xor32(target, value) __sync_fetch_and_xor((int32_t*)(target), (value))
 
-#define crstl_atomic_xor64(target, value) __sync_fetch_and_xor((long long*)(target), (value))
\ No newline at end of file
+#define crstl_atomic_xor64(target, value) __sync_fetch_and_xor((long long*)(target), (value))
+
+// Load
+
+#define crstl_atomic_load8(target) __sync_fetch_and_add((char*)(target), 0)
+
+#define crstl_atomic_load16(target) __sync_fetch_and_add((short*)(target), 0)
+
+#define crstl_atomic_load32(target) __sync_fetch_and_add((int32_t*)(target), 0)
+
+#define crstl_atomic_load64(target) __sync_fetch_and_add((long long*)(target), 0)
+
+// Compare and Exchange
+
+#define crstl_atomic_cmpxchg8(target, exchange, comparand) __sync_val_compare_and_swap((char*)(target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg16(target, exchange, comparand) __sync_val_compare_and_swap((short*)(target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg32(target, exchange, comparand) __sync_val_compare_and_swap((int32_t*)(target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg64(target, exchange, comparand) __sync_val_compare_and_swap((long long*)(target), (comparand), (exchange))
+
+// Relaxed, atomic but with no ordering of other memory accesses
+
+#define crstl_atomic_add64_relaxed(target, value) __atomic_fetch_add((long long*)(target), (value), __ATOMIC_RELAXED)
+
+#define crstl_atomic_load64_relaxed(target) __atomic_load_n((long long*)(target), __ATOMIC_RELAXED)
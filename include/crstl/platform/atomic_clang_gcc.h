@@ -61,3 +61,29 @@
 #define crstl_atomic_xor32(target, value) __atomic_fetch_xor((target), (value), __ATOMIC_SEQ_CST)
 
 #define crstl_atomic_xor64(target, value) __atomic_fetch_xor((target), (value), __ATOMIC_SEQ_CST)
+
+// Load
+
+#define crstl_atomic_load8(target) __atomic_load_n((target), __ATOMIC_SEQ_CST)
+
+#define crstl_atomic_load16(target) __atomic_load_n((target), __ATOMIC_SEQ_CST)
+
+#define crstl_atomic_load32(target) __atomic_load_n((target), __ATOMIC_SEQ_CST)
+
+#define crstl_atomic_load64(target) __atomic_load_n((target), __ATOMIC_SEQ_CST)
+
+// Compare and Exchange
+
+#define crstl_atomic_cmpxchg8(target, exchange, comparand) __sync_val_compare_and_swap((target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg16(target, exchange, comparand) __sync_val_compare_and_swap((target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg32(target, exchange, comparand) __sync_val_compare_and_swap((target), (comparand), (exchange))
+
+#define crstl_atomic_cmpxchg64(target, exchange, comparand) __sync_val_compare_and_swap((target), (comparand), (exchange))
+
+// Relaxed, atomic but with no ordering of other memory accesses
+
+#define crstl_atomic_add64_relaxed(target, value) __atomic_fetch_add((target), (value), __ATOMIC_RELAXED)
+
+#define crstl_atomic_load64_relaxed(target) __atomic_load_n((target), __ATOMIC_RELAXED)
@@ -125,4 +125,30 @@ namespace crstl
 
 #define crstl_atomic_xor32(target, value) _InterlockedXor((long*)(target), (value))
 
-#define crstl_atomic_xor64(target, value) _InterlockedXor64((long long*)(target), (value))
\ No newline at end of file
+#define crstl_atomic_xor64(target, value) _InterlockedXor64((long long*)(target), (value))
+
+// Load
+
+#define crstl_atomic_load8(target) _InterlockedCompareExchange8((char*)(target), 0, 0)
+
+#define crstl_atomic_load16(target) _InterlockedCompareExchange16((short*)(target), 0, 0)
+
+#define crstl_atomic_load32(target) _InterlockedCompareExchange((long*)(target), 0, 0)
+
+#define crstl_atomic_load64(target) _InterlockedCompareExchange64((long long*)(target), 0, 0)
+
+// Compare and Exchange
+
+#define crstl_atomic_cmpxchg8(target, exchange, comparand) _InterlockedCompareExchange8((char*)(target), (exchange), (comparand))
+
+#define crstl_atomic_cmpxchg16(target, exchange, comparand) _InterlockedCompareExchange16((short*)(target), (exchange), (comparand))
+
+#define crstl_atomic_cmpxchg32(target, exchange, comparand) _InterlockedCompareExchange((long*)(target), (exchange), (comparand))
+
+#define crstl_atomic_cmpxchg64(target, exchange, comparand) _InterlockedCompareExchange64((long long*)(target), (exchange), (comparand))
+
+// Relaxed. The interlocked functions are full barriers on x86 and x64, so these are the same as the ordered ones
+
+#define crstl_atomic_add64_relaxed(target, value) crstl_atomic_add64(target, value)
+
+#define crstl_atomic_load64_relaxed(target) crstl_atomic_load64(target)
@@ -0,0 +1,363 @@
+#pragma once
+
+#include "crstl/atomic.h"
+
+#include "crstl/critical_section.h"
+
+#include "crstl/intrusive_ptr.h"
+
+#include "crstl/open_hashmap.h"
+
+#include "crstl/vector.h"
+
+#include "crstl/forward_declarations.h"
+
+// crstl::snapshot_hashmap
+//
+// Hashmap for tables that are read very often and rewritten rarely. The contents live in an immutable open_hashmap
+// snapshot. Writers build a new table and publish it by swapping a single pointer, and readers look up the current
+// snapshot without taking a lock or writing to any memory shared with other readers
+//
+// - Every reading thread owns a snapshot_hashmap_reader, which claims one of MaxReaders slots for its lifetime. While
+//   reading, the slot holds the epoch the read started in
+// - A reader created while every slot is taken has no slot, and reads under the writer lock instead. Nothing can be
+//   retired or freed while it holds it, so it stays correct, but it no longer reads without a lock
+// - Replaced snapshots are retired with the current epoch and freed once no slot is reading in that epoch or an older
+//   one. Retired snapshots are checked every time a writer publishes, or when calling reclaim()
+// - Snapshots are reference counted with intrusive_ptr, so a reader can keep one alive past its read with acquire()
+// - Writers are serialized with a critical section
+//
+
+crstl_module_export namespace crstl
+{
+	template<typename Key, typename T, typename Hasher, typename Allocator>
+	class snapshot_hashmap_snapshot : public intrusive_ptr_interface_delete
+	{
+	public:
+
+		typedef open_hashmap<Key, T, Hasher, Allocator> table_type;
+
+		explicit snapshot_hashmap_snapshot(const table_type& table) : m_table(table) {}
+
+		explicit snapshot_hashmap_snapshot(table_type&& table) : m_table(crstl_move(table)) {}
+
+		const table_type& table() const { return m_table; }
+
+	private:
+
+		table_type m_table;
+	};
+
+	template<typename Key, typename T, typename Hasher, typename Allocator, size_t MaxReaders>
+	class snapshot_hashmap
+	{
+	public:
+
+		typedef snapshot_hashmap_snapshot<Key, T, Hasher, Allocator> snapshot_type;
+		typedef typename snapshot_type::table_type                   table_type;
+		typedef snapshot_hashmap_reader<Key, T, Hasher, Allocator, MaxReaders> reader_type;
+
+		typedef typename table_type::key_type       key_type;
+		typedef typename table_type::value_type     value_type;
+		typedef typename table_type::key_value_type key_value_type;
+
+		snapshot_hashmap()
+		{
+			snapshot_type* snapshot = new snapshot_type(table_type());
+			snapshot->add_ref();
+			m_snapshot.store(snapshot);
+			m_epoch.store(kFirstEpoch);
+		}
+
+		~snapshot_hashmap()
+		{
+			for (size_t i = 0; i < MaxReaders; ++i)
+			{
+				crstl_assert_msg(m_reader_slots[i].epoch.load() == kSlotFree, "A reader outlived the hashmap");
+			}
+
+			for (size_t i = 0; i < m_retired.size(); ++i)
+			{
+				intrusive_ptr_release(m_retired[i].snapshot);
+			}
+
+			intrusive_ptr_release(m_snapshot.load());
+		}
+
+		// Publish a new table. Readers that started before keep reading the previous one
+		void publish(const table_type& table)
+		{
+			publish_snapshot(new snapshot_type(table));
+		}
+
+		void publish(table_type&& table)
+		{
+			publish_snapshot(new snapshot_type(crstl_move(table)));
+		}
+
+		// Copy the current table, call function(table_type&) to modify the copy and publish it. Concurrent updates are
+		// applied one after the other, so none of them is lost
+		template<typename Function>
+		void update(Function function)
+		{
+			m_writer_section.lock();
+
+			table_type table(m_snapshot.load()->table());
+			function(table);
+			publish_snapshot_locked(new snapshot_type(crstl_move(table)));
+
+			m_writer_section.unlock();
+		}
+
+		// Free the retired snapshots that no reader can be using anymore
+		void reclaim()
+		{
+			m_writer_section.lock();
+			reclaim_locked();
+			m_writer_section.unlock();
+		}
+
+		crstl_nodiscard
+		size_t retired_count() const
+		{
+			m_writer_section.lock();
+			size_t retired_count = m_retired.size();
+			m_writer_section.unlock();
+			return retired_count;
+		}
+
+	private:
+
+		friend class snapshot_hashmap_reader<Key, T, Hasher, Allocator, MaxReaders>;
+
+		// Values of a reader slot. Anything from kFirstEpoch up is the epoch of an ongoing read
+		enum slot_state : int64_t
+		{
+			kSlotFree = 0,
+			kSlotIdle = 1,
+			kFirstEpoch = 2
+		};
+
+		// Slot index of a reader that couldn't claim one
+		static const size_t kNoSlot = MaxReaders;
+
+		// Keep every slot on its own cache line so that readers never write to the same one
+		struct crstl_alignas(64) reader_slot
+		{
+			atomic<int64_t> epoch;
+		};
+
+		struct retired_snapshot
+		{
+			snapshot_type* snapshot;
+
+			int64_t epoch;
+		};
+
+		// Returns kNoSlot if every slot is taken
+		size_t claim_slot() const
+		{
+			for (size_t i = 0; i < MaxReaders; ++i)
+			{
+				int64_t expected = kSlotFree;
+
+				if (m_reader_slots[i].epoch.compare_exchange(expected, kSlotIdle))
+				{
+					return i;
+				}
+			}
+
+			return kNoSlot;
+		}
+
+		void release_slot(size_t slot_index) const
+		{
+			if (slot_index != kNoSlot)
+			{
+				m_reader_slots[slot_index].epoch.store(kSlotFree);
+			}
+		}
+
+		// Publishing the epoch in the slot must be visible before we load the snapshot, otherwise a writer could retire
+		// and free the snapshot in between. The store is an exchange, which is a full barrier. Without a slot we hold
+		// the writer lock instead, as snapshots are only retired and freed under it
+		const snapshot_type* begin_read(size_t slot_index) const
+		{
+			if (slot_index == kNoSlot)
+			{
+				m_writer_section.lock();
+			}
+			else
+			{
+				m_reader_slots[slot_index].epoch.store(m_epoch.load());
+			}
+
+			return m_snapshot.load();
+		}
+
+		void end_read(size_t slot_index) const
+		{
+			if (slot_index == kNoSlot)
+			{
+				m_writer_section.unlock();
+			}
+			else
+			{
+				m_reader_slots[slot_index].epoch.store(kSlotIdle);
+			}
+		}
+
+		void publish_snapshot(snapshot_type* snapshot)
+		{
+			m_writer_section.lock();
+			publish_snapshot_locked(snapshot);
+			m_writer_section.unlock();
+		}
+
+		// Any reader that can see the old snapshot wrote an epoch no newer than the one we retire it with
+		void publish_snapshot_locked(snapshot_type* snapshot)
+		{
+			snapshot->add_ref();
+			snapshot_type* old_snapshot = m_snapshot.exchange(snapshot);
+
+			retired_snapshot retired;
+			retired.snapshot = old_snapshot;
+			retired.epoch = m_epoch.load();
+			m_retired.push_back(retired);
+
+			++m_epoch;
+
+			reclaim_locked();
+		}
+
+		void reclaim_locked()
+		{
+			int64_t oldest_reading_epoch = m_epoch.load();
+
+			for (size_t i = 0; i < MaxReaders; ++i)
+			{
+				int64_t slot_epoch = m_reader_slots[i].epoch.load();
+
+				if (slot_epoch >= kFirstEpoch && slot_epoch < oldest_reading_epoch)
+				{
+					oldest_reading_epoch = slot_epoch;
+				}
+			}
+
+			size_t kept_count = 0;
+
+			for (size_t i = 0; i < m_retired.size(); ++i)
+			{
+				if (m_retired[i].epoch < oldest_reading_epoch)
+				{
+					intrusive_ptr_release(m_retired[i].snapshot);
+				}
+				else
+				{
+					m_retired[kept_count++] = m_retired[i];
+				}
+			}
+
+			m_retired.resize(kept_count);
+		}
+
+		snapshot_hashmap(const snapshot_hashmap& other) crstl_constructor_delete;
+
+		snapshot_hashmap& operator = (const snapshot_hashmap& other) crstl_constructor_delete;
+
+		mutable reader_slot m_reader_slots[MaxReaders];
+
+		atomic<snapshot_type*> m_snapshot;
+
+		atomic<int64_t> m_epoch;
+
+		mutable critical_section m_writer_section;
+
+		vector<retired_snapshot> m_retired;
+	};
+
+	// Claims a reader slot of a snapshot_hashmap for its lifetime. Use one per thread, and don't share it
+	template<typename Key, typename T, typename Hasher, typename Allocator, size_t MaxReaders>
+	class snapshot_hashmap_reader
+	{
+	public:
+
+		typedef snapshot_hashmap<Key, T, Hasher, Allocator, MaxReaders> hashmap_type;
+		typedef typename hashmap_type::snapshot_type                    snapshot_type;
+		typedef typename hashmap_type::table_type                       table_type;
+		typedef typename hashmap_type::key_value_type                   key_value_type;
+
+		explicit snapshot_hashmap_reader(const hashmap_type& hashmap)
+			: m_hashmap(hashmap)
+			, m_slot_index(hashmap.claim_slot())
+			, m_snapshot(nullptr)
+		{
+		}
+
+		~snapshot_hashmap_reader()
+		{
+			crstl_assert_msg(m_snapshot == nullptr, "Reader destroyed while reading");
+			m_hashmap.release_slot(m_slot_index);
+		}
+
+		// Whether the reader claimed a slot and reads without taking a lock. See the notes on snapshot_hashmap
+		crstl_nodiscard
+		bool is_lock_free() const { return m_slot_index != hashmap_type::kNoSlot; }
+
+		// Start reading the current snapshot. The table stays valid until unlock()
+		const table_type& lock()
+		{
+			crstl_assert(m_snapshot == nullptr);
+			m_snapshot = m_hashmap.begin_read(m_slot_index);
+			return m_snapshot->table();
+		}
+
+		void unlock()
+		{
+			crstl_assert(m_snapshot != nullptr);
+			m_hashmap.end_read(m_slot_index);
+			m_snapshot = nullptr;
+		}
+
+		// Take a reference to the current snapshot, which stays valid for as long as the pointer lives
+		crstl_nodiscard
+		intrusive_ptr<snapshot_type> acquire()
+		{
+			lock();
+			intrusive_ptr<snapshot_type> snapshot(const_cast<snapshot_type*>(m_snapshot));
+			unlock();
+			return snapshot;
+		}
+
+		// Call visitor(const key_value_type&) if the key exists in the current snapshot. Returns whether it did
+		template<typename KeyType, typename Visitor>
+		bool find_and_visit(const KeyType& key, Visitor visitor)
+		{
+			const table_type& table = lock();
+
+			typename table_type::const_iterator iter = table.find(key);
+			bool found = iter != table.end();
+
+			if (found)
+			{
+				visitor(*iter);
+			}
+
+			unlock();
+
+			return found;
+		}
+
+	private:
+
+		snapshot_hashmap_reader(const snapshot_hashmap_reader& other) crstl_constructor_delete;
+
+		snapshot_hashmap_reader& operator = (const snapshot_hashmap_reader& other) crstl_constructor_delete;
+
+		const hashmap_type& m_hashmap;
+
+		size_t m_slot_index;
+
+		const snapshot_type* m_snapshot;
+	};
+};
@@ -2,9 +2,12 @@
 
 #include "crstl/config.h"
 #include "crstl/crstldef.h"
+#include "crstl/forward_declarations.h"
 #include "crstl/move_forward.h"
+#include "crstl/type_utils.h"
 #include "crstl/utility/cast.h"
 #include "crstl/utility/memory_ops.h"
+#include "crstl/utility/sort_network.h"
 
 crstl_module_export namespace crstl
 {
@@ -77,7 +80,7 @@ crstl_module_export namespace crstl
 		bubble_sort(begin, end, less<>());
 	}
 
-	// insertion_sort takes an element and inserts it in the sorted position of an array. To accomplish that it checks 
+	// insertion_sort takes an element and inserts it in the sorted position of an array. To accomplish that it checks
 	// for all elements until one is found that does not meet the criteria. On its way all elements are moved until we
 	// find a place for the current element
 	template<typename T, typename Compare>
@@ -89,28 +92,24 @@ crstl_module_export namespace crstl
 
 		for (size_t i = 1; i < size; ++i)
 		{
-			// Access the current element
-			T current_element = crstl_move(begin[i]);
-
-			size_t j = i;
-
-			// Compare it walking backward
-			for (; j > 0; --j)
+			// Only take the current element out if it needs to move
+			if (compare(begin[i], begin[i - 1]))
 			{
-				T sort_element = crstl_move(begin[j - 1]);
+				T current_element = crstl_move(begin[i]);
+
+				size_t j = i;
 
-				if (compare(current_element, sort_element))
+				// Compare it walking backward
+				do
 				{
-					begin[j] = crstl_move(sort_element);
+					begin[j] = crstl_move(begin[j - 1]);
+					--j;
 				}
-				else
-				{
-					break;
-				}
-			}
+				while (j > 0 && compare(current_element, begin[j - 1]));
 
-			// Write the last element
-			begin[j] = crstl_move(current_element);
+				// Write the last element
+				begin[j] = crstl_move(current_element);
+			}
 		}
 	}
 
@@ -139,49 +138,564 @@ crstl_module_export namespace crstl
 		return b;
 	}
 
+	namespace detail
+	{
+		template<typename T, typename Compare>
+		void heap_sift_down(T* begin, size_t size, size_t index, Compare& compare)
+		{
+			T value = crstl_move(begin[index]);
+
+			while (true)
+			{
+				size_t child = 2 * index + 1;
+
+				if (child >= size)
+				{
+					break;
+				}
+
+				if (child + 1 < size && compare(begin[child], begin[child + 1]))
+				{
+					++child;
+				}
+
+				if (!compare(value, begin[child]))
+				{
+					break;
+				}
+
+				begin[index] = crstl_move(begin[child]);
+				index = child;
+			}
+
+			begin[index] = crstl_move(value);
+		}
+	}
+
+	// heap_sort builds a max heap in place and repeatedly moves its top to the end. It is O(n log n) in every case but
+	// slower than quick_sort on average, which uses it as a fallback when partitions keep going wrong
 	template<typename T, typename Compare>
-	void quick_sort(T* begin, T* end, Compare compare)
+	void heap_sort(T* begin, T* end, Compare compare)
 	{
 		crstl_assert(end >= begin);
 
 		const size_t size = (size_t)(end - begin);
 
-		if (size > kQuicksortInsertionLimit)
+		for (size_t i = size / 2; i > 0; --i)
+		{
+			detail::heap_sift_down(begin, size, i - 1, compare);
+		}
+
+		for (size_t i = size; i > 1; --i)
 		{
-			// Select pivot from the middle of the array. Median of 3 has some overhead, might be better in some cases
-			// if we can find a really fast way of selecting it (e.g. branchless for integers)
-			T pivot = begin[size >> 1];
+			swap(begin[0], begin[i - 1]);
+			detail::heap_sift_down(begin, i - 1, 0, compare);
+		}
+	}
 
-			// Distribute items for this range. Start from the left and start swapping with the elements at the end
-			// when items are on the wrong side of the pivot
-			int64_t left_index = -1;
-			int64_t right_index = (int64_t)size;
+	template<typename T>
+	void heap_sort(T* begin, T* end)
+	{
+		heap_sort(begin, end, less<>{});
+	}
 
-			while (true)
+	// quick_sort is a pattern-defeating quicksort
+	//
+	// https://github.com/orlp/pdqsort
+	// https://arxiv.org/abs/2106.05123
+	//
+	// 1. The pivot is the median of 3 elements, or the median of 3 medians of 3 (ninther) for large partitions. The
+	//    samples are left sorted around the pivot, which lets the partition loops run without bound checks
+	// 2. Partitions that are very unbalanced count as bad. After log2(n) bad partitions the range is heap sorted, which
+	//    bounds the worst case to O(n log n). Before that, a bad partition swaps a few elements around to break patterns
+	// 3. Only the smaller partition is sorted recursively, the larger one is sorted by the same loop. The stack depth is
+	//    O(log n), which matters inside a crstl::thread with its small default stack
+	// 4. If the element before a partition is equal to the pivot, everything equal to it is put to the left and skipped,
+	//    which makes inputs with few unique values O(n k)
+	// 5. If a partition didn't need any swaps, an insertion sort that gives up after a few moves tries to finish the
+	//    job. Sorted, reversed and mostly sorted inputs become O(n)
+	// 6. Trivially copyable types are partitioned in blocks. The comparisons of a block are stored as offsets without
+	//    branching, and only then are the elements swapped. This avoids branch mispredictions on random data
+	//
+	// Partitions of up to kQuicksortInsertionLimit elements are insertion sorted. For int32_t, uint32_t, float and int64_t
+	// sorted with less<> they go through a sorting network instead, on platforms that have one for the type
+	namespace detail
+	{
+		enum : size_t
+		{
+			kQuicksortNintherThreshold = 128,
+			kQuicksortPartialInsertionLimit = 8,
+			kQuicksortBlockSize = 64
+		};
+
+		template<typename T, typename Compare>
+		inline void sort2(T* a, T* b, Compare& compare)
+		{
+			if (compare(*b, *a))
 			{
-				// We don't range compare here because whether the pivot is the maximum or minimum element,
-				// this is guaranteed to compare with the pivot itself at some point, by construction
-				while (compare(begin[++left_index], pivot));
-				while (compare(pivot, begin[--right_index]));
+				swap(*a, *b);
+			}
+		}
 
-				if (left_index < right_index)
+		template<typename T, typename Compare>
+		inline void sort3(T* a, T* b, T* c, Compare& compare)
+		{
+			sort2(a, b, compare);
+			sort2(b, c, compare);
+			sort2(a, b, compare);
+		}
+
+		// Insertion sort that requires the element before begin to be less than or equal to every element in the range,
+		// so it never checks for the beginning
+		template<typename T, typename Compare>
+		void unguarded_insertion_sort(T* begin, T* end, Compare& compare)
+		{
+			for (T* current = begin; current != end; ++current)
+			{
+				if (compare(*current, *(current - 1)))
 				{
-					swap(begin[left_index], begin[right_index]);
+					T current_element = crstl_move(*current);
+					T* sift = current;
+
+					do
+					{
+						*sift = crstl_move(*(sift - 1));
+						--sift;
+					}
+					while (compare(current_element, *(sift - 1)));
+
+					*sift = crstl_move(current_element);
+				}
+			}
+		}
+
+		// Insertion sort that gives up after moving kQuicksortPartialInsertionLimit elements. Returns whether the range
+		// got sorted
+		template<typename T, typename Compare>
+		bool partial_insertion_sort(T* begin, T* end, Compare& compare)
+		{
+			size_t move_count = 0;
+
+			for (T* current = begin == end ? end : begin + 1; current != end; ++current)
+			{
+				if (compare(*current, *(current - 1)))
+				{
+					T current_element = crstl_move(*current);
+					T* sift = current;
+
+					do
+					{
+						*sift = crstl_move(*(sift - 1));
+						--sift;
+					}
+					while (sift != begin && compare(current_element, *(sift - 1)));
+
+					*sift = crstl_move(current_element);
+					move_count += (size_t)(current - sift);
+
+					if (move_count > kQuicksortPartialInsertionLimit)
+					{
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		// Partition around the pivot at begin into [less than pivot, pivot, greater than or equal to pivot) and return
+		// the position of the pivot. The pivot selection guarantees an element greater than or equal to it after begin
+		template<typename T, typename Compare>
+		T* partition_right(T* begin, T* end, Compare& compare, bool& already_partitioned)
+		{
+			T pivot = crstl_move(*begin);
+
+			T* first = begin;
+			T* last = end;
+
+			while (compare(*++first, pivot));
+
+			// If the first element was already in place there is no element less than the pivot to stop the search
+			if (first - 1 == begin)
+			{
+				while (first < last && !compare(*--last, pivot));
+			}
+			else
+			{
+				while (!compare(*--last, pivot));
+			}
+
+			already_partitioned = first >= last;
+
+			while (first < last)
+			{
+				swap(*first, *last);
+				while (compare(*++first, pivot));
+				while (!compare(*--last, pivot));
+			}
+
+			T* pivot_position = first - 1;
+			*begin = crstl_move(*pivot_position);
+			*pivot_position = crstl_move(pivot);
+			return pivot_position;
+		}
+
+		// Swap the elements at the given offsets from both sides. When there are as many on the left as on the right,
+		// swapping in pairs keeps a reversed input reversed, otherwise the elements are rotated through a cycle, which
+		// does fewer moves
+		template<typename T>
+		inline void swap_offsets(T* first, T* last, const uint8_t* offsets_left, const uint8_t* offsets_right, size_t count, bool use_swaps)
+		{
+			if (use_swaps)
+			{
+				for (size_t i = 0; i < count; ++i)
+				{
+					swap(first[offsets_left[i]], *(last - offsets_right[i]));
+				}
+			}
+			else if (count > 0)
+			{
+				T* left = first + offsets_left[0];
+				T* right = last - offsets_right[0];
+
+				T temp = crstl_move(*left);
+				*left = crstl_move(*right);
+
+				for (size_t i = 1; i < count; ++i)
+				{
+					left = first + offsets_left[i];
+					*right = crstl_move(*left);
+					right = last - offsets_right[i];
+					*left = crstl_move(*right);
+				}
+
+				*right = crstl_move(temp);
+			}
+		}
+
+		// Same result as partition_right, but the elements that need to be swapped are found a block at a time. Stores of
+		// the offsets happen every iteration and only the count depends on the comparison
+		template<typename T, typename Compare>
+		T* partition_right_block(T* begin, T* end, Compare& compare, bool& already_partitioned)
+		{
+			T pivot = crstl_move(*begin);
+
+			T* first = begin;
+			T* last = end;
+
+			while (compare(*++first, pivot));
+
+			if (first - 1 == begin)
+			{
+				while (first < last && !compare(*--last, pivot));
+			}
+			else
+			{
+				while (!compare(*--last, pivot));
+			}
+
+			already_partitioned = first >= last;
+
+			if (!already_partitioned)
+			{
+				swap(*first, *last);
+				++first;
+
+				crstl_alignas(64) uint8_t offsets_left[kQuicksortBlockSize];
+				crstl_alignas(64) uint8_t offsets_right[kQuicksortBlockSize];
+
+				T* offsets_left_base = first;
+				T* offsets_right_base = last;
+
+				size_t count_left = 0;
+				size_t count_right = 0;
+				size_t start_left = 0;
+				size_t start_right = 0;
+
+				while (first < last)
+				{
+					// Split the unknown elements between the sides that ran out of offsets. When both did, split them
+					// in half
+					const size_t unknown_count = (size_t)(last - first);
+					const size_t left_split = count_left == 0 ? (count_right == 0 ? unknown_count / 2 : unknown_count) : 0;
+					const size_t right_split = count_right == 0 ? (unknown_count - left_split) : 0;
+
+					const size_t left_block = left_split < kQuicksortBlockSize ? left_split : kQuicksortBlockSize;
+					const size_t right_block = right_split < kQuicksortBlockSize ? right_split : kQuicksortBlockSize;
+
+					for (size_t i = 0; i < left_block; ++i)
+					{
+						offsets_left[count_left] = (uint8_t)i;
+						count_left += !compare(*first, pivot);
+						++first;
+					}
+
+					for (size_t i = 0; i < right_block; ++i)
+					{
+						offsets_right[count_right] = (uint8_t)(i + 1);
+						count_right += compare(*--last, pivot);
+					}
+
+					const size_t count = count_left < count_right ? count_left : count_right;
+					swap_offsets(offsets_left_base, offsets_right_base, offsets_left + start_left, offsets_right + start_right, count, count_left == count_right);
+
+					count_left -= count;
+					count_right -= count;
+					start_left += count;
+					start_right += count;
+
+					if (count_left == 0)
+					{
+						start_left = 0;
+						offsets_left_base = first;
+					}
+
+					if (count_right == 0)
+					{
+						start_right = 0;
+						offsets_right_base = last;
+					}
+				}
+
+				// Every element is classified, move the ones left over to the boundary
+				if (count_left)
+				{
+					while (count_left--)
+					{
+						swap(offsets_left_base[offsets_left[start_left + count_left]], *--last);
+					}
+
+					first = last;
+				}
+
+				if (count_right)
+				{
+					while (count_right--)
+					{
+						swap(*(offsets_right_base - offsets_right[start_right + count_right]), *first);
+						++first;
+					}
+				}
+			}
+
+			T* pivot_position = first - 1;
+			*begin = crstl_move(*pivot_position);
+			*pivot_position = crstl_move(pivot);
+			return pivot_position;
+		}
+
+		// Partition around the pivot at begin into [less than or equal to pivot, greater than pivot) and return the
+		// position of the pivot. Used when the element before begin equals the pivot, so nothing is less than it
+		template<typename T, typename Compare>
+		T* partition_left(T* begin, T* end, Compare& compare)
+		{
+			T pivot = crstl_move(*begin);
+
+			T* first = begin;
+			T* last = end;
+
+			while (compare(pivot, *--last));
+
+			if (last + 1 == end)
+			{
+				while (first < last && !compare(pivot, *++first));
+			}
+			else
+			{
+				while (!compare(pivot, *++first));
+			}
+
+			while (first < last)
+			{
+				swap(*first, *last);
+				while (compare(pivot, *--last));
+				while (!compare(pivot, *++first));
+			}
+
+			T* pivot_position = last;
+			*begin = crstl_move(*pivot_position);
+			*pivot_position = crstl_move(pivot);
+			return pivot_position;
+		}
+
+		template<typename T, typename Compare>
+		struct sort_network_compare
+		{
+			static const bool value = false;
+		};
+
+		template<typename T>
+		struct sort_network_compare<T, less<void>>
+		{
+			static const bool value = sort_network_enabled<T>::value;
+		};
+
+		template<typename T>
+		struct sort_network_compare<T, less<T>>
+		{
+			static const bool value = sort_network_enabled<T>::value;
+		};
+
+		template<typename T, typename Compare, bool SortNetwork = sort_network_compare<T, Compare>::value>
+		struct quick_sort_small
+		{
+			static void sort(T* begin, T* end, Compare& compare, bool leftmost)
+			{
+				if (leftmost)
+				{
+					insertion_sort(begin, end, compare);
 				}
 				else
 				{
-					break;
+					unguarded_insertion_sort(begin, end, compare);
+				}
+			}
+		};
+
+		template<typename T, typename Compare>
+		struct quick_sort_small<T, Compare, true>
+		{
+			static void sort(T* begin, T* end, Compare& compare, bool leftmost)
+			{
+				const size_t size = (size_t)(end - begin);
+
+				// The insertion limit can be configured above the largest network
+				if (size <= kSortNetworkMaxSize)
+				{
+					if (size > 1)
+					{
+						sort_network(begin, size);
+					}
+				}
+				else
+				{
+					quick_sort_small<T, Compare, false>::sort(begin, end, compare, leftmost);
 				}
 			}
+		};
+
+		template<bool BlockPartition, typename T, typename Compare>
+		void quick_sort_loop(T* begin, T* end, Compare& compare, int bad_partitions_allowed, bool leftmost)
+		{
+			while (true)
+			{
+				const size_t size = (size_t)(end - begin);
+
+				if (size <= kQuicksortInsertionLimit)
+				{
+					quick_sort_small<T, Compare>::sort(begin, end, compare, leftmost);
+					return;
+				}
+
+				// Leave the pivot at begin
+				const size_t half_size = size / 2;
+
+				if (size > kQuicksortNintherThreshold)
+				{
+					sort3(begin, begin + half_size, end - 1, compare);
+					sort3(begin + 1, begin + (half_size - 1), end - 2, compare);
+					sort3(begin + 2, begin + (half_size + 1), end - 3, compare);
+					sort3(begin + (half_size - 1), begin + half_size, begin + (half_size + 1), compare);
+					swap(*begin, *(begin + half_size));
+				}
+				else
+				{
+					sort3(begin + half_size, begin, end - 1, compare);
+				}
+
+				// Everything in this partition is greater than or equal to the element before it. If the pivot isn't
+				// greater, it is equal, and so is every element that goes to the left. They don't need sorting
+				if (!leftmost && !compare(*(begin - 1), *begin))
+				{
+					begin = partition_left(begin, end, compare) + 1;
+					continue;
+				}
+
+				bool already_partitioned = false;
+
+				T* pivot_position = BlockPartition ?
+					partition_right_block(begin, end, compare, already_partitioned) :
+					partition_right(begin, end, compare, already_partitioned);
+
+				const size_t left_size = (size_t)(pivot_position - begin);
+				const size_t right_size = (size_t)(end - (pivot_position + 1));
+
+				if (left_size < size / 8 || right_size < size / 8)
+				{
+					if (--bad_partitions_allowed == 0)
+					{
+						heap_sort(begin, end, compare);
+						return;
+					}
+
+					// Swap elements into the positions the next pivots will be sampled from
+					if (left_size > kQuicksortInsertionLimit)
+					{
+						swap(*begin, *(begin + left_size / 4));
+						swap(*(pivot_position - 1), *(pivot_position - left_size / 4));
+
+						if (left_size > kQuicksortNintherThreshold)
+						{
+							swap(*(begin + 1), *(begin + (left_size / 4 + 1)));
+							swap(*(begin + 2), *(begin + (left_size / 4 + 2)));
+							swap(*(pivot_position - 2), *(pivot_position - (left_size / 4 + 1)));
+							swap(*(pivot_position - 3), *(pivot_position - (left_size / 4 + 2)));
+						}
+					}
+
+					if (right_size > kQuicksortInsertionLimit)
+					{
+						swap(*(pivot_position + 1), *(pivot_position + (1 + right_size / 4)));
+						swap(*(end - 1), *(end - right_size / 4));
+
+						if (right_size > kQuicksortNintherThreshold)
+						{
+							swap(*(pivot_position + 2), *(pivot_position + (2 + right_size / 4)));
+							swap(*(pivot_position + 3), *(pivot_position + (3 + right_size / 4)));
+							swap(*(end - 2), *(end - (1 + right_size / 4)));
+							swap(*(end - 3), *(end - (2 + right_size / 4)));
+						}
+					}
+				}
+				else if (already_partitioned &&
+					partial_insertion_sort(begin, pivot_position, compare) &&
+					partial_insertion_sort(pivot_position + 1, end, compare))
+				{
+					return;
+				}
 
-			// Call recursively for partitions
-			quick_sort(begin, begin + left_index, compare);
-			quick_sort(begin + left_index, end, compare);
+				// Recurse into the smaller partition and keep looping on the larger one
+				if (left_size < right_size)
+				{
+					quick_sort_loop<BlockPartition>(begin, pivot_position, compare, bad_partitions_allowed, leftmost);
+					begin = pivot_position + 1;
+					leftmost = false;
+				}
+				else
+				{
+					quick_sort_loop<BlockPartition>(pivot_position + 1, end, compare, bad_partitions_allowed, false);
+					end = pivot_position;
+				}
+			}
 		}
-		else
+	}
+
+	template<typename T, typename Compare>
+	void quick_sort(T* begin, T* end, Compare compare)
+	{
+		crstl_assert(end >= begin);
+
+		// The pivot samples of a bad partition need at least 8 elements on each side
+		static_assert(kQuicksortInsertionLimit >= 8, "The quick_sort insertion limit must be at least 8");
+
+		int bad_partitions_allowed = 0;
+
+		for (size_t size = (size_t)(end - begin); size > 1; size >>= 1)
 		{
-			insertion_sort(begin, end, compare);
+			bad_partitions_allowed++;
 		}
+
+		detail::quick_sort_loop<crstl_is_trivially_copyable(T)>(begin, end, compare, bad_partitions_allowed, true);
 	}
 
 	template<typename T>
@@ -190,6 +704,62 @@ crstl_module_export namespace crstl
 		quick_sort(begin, end, less<>{});
 	}
 
+	// sort_small sorts arrays whose size is known at compile time, like the ones in crstl::array and fixed_vector.
+	// Up to 64 int32_t, uint32_t, float or int64_t go through a sorting network in SIMD registers, on platforms that have
+	// one for the type. Anything else is sorted with quick_sort
+	namespace detail
+	{
+		template<size_t N>
+		struct sort_network_size
+		{
+			static const size_t value = N <= 8 ? 8 : N <= 16 ? 16 : N <= 32 ? 32 : 64;
+		};
+
+		template<typename T, size_t N, bool SortNetwork = sort_network_enabled<T>::value && N <= kSortNetworkMaxSize>
+		struct sort_small_impl
+		{
+			static void sort(T* begin) { quick_sort(begin, begin + N); }
+
+			static void sort(T* begin, size_t size) { quick_sort(begin, begin + size); }
+		};
+
+		template<typename T, size_t N>
+		struct sort_small_impl<T, N, true>
+		{
+			static void sort(T* begin) { sort_network_padded<sort_network_size<N>::value>(begin, N); }
+
+			static void sort(T* begin, size_t size) { sort_network(begin, size); }
+		};
+	}
+
+	// Sorts exactly N elements
+	template<size_t N, typename T>
+	void sort_small(T* begin)
+	{
+		detail::sort_small_impl<T, N>::sort(begin);
+	}
+
+	// Sorts up to N elements
+	template<size_t N, typename T>
+	void sort_small(T* begin, T* end)
+	{
+		crstl_assert(end >= begin && (size_t)(end - begin) <= N);
+
+		detail::sort_small_impl<T, N>::sort(begin, (size_t)(end - begin));
+	}
+
+	template<typename T, size_t N>
+	void sort_small(array<T, N>& values)
+	{
+		sort_small<N>(values.data());
+	}
+
+	template<typename T, size_t N>
+	void sort_small(fixed_vector<T, N>& values)
+	{
+		sort_small<N>(values.data(), values.data() + values.size());
+	}
+
 	// Radix Sort
 	//
 	// https://probablydance.com/2016/12/02/investigating-radix-sort/
@@ -201,25 +771,28 @@ crstl_module_export namespace crstl
 	//    it cleverly by computing it for the next iteration to reduce stack usage but simplicity was favored in our case
 	// 2. Keeps track of whether a single bucket was used, to avoid sorting parts of the word that are the same. This
 	//    behavior happens when using e.g. smaller numbers or aligned pointers
+	//
+	// radix_sort_key turns a key into an unsigned integer that sorts in the same order. Signed integers flip their sign
+	// bit, and floating point numbers also flip the rest of their bits when negative
 
 	template<typename T>
 	struct radix_sort_key
 	{
-		typedef decltype(T::m_key) radix_type;
+		typedef typename radix_sort_key<decltype(T::m_key)>::radix_type radix_type;
 
 		static radix_type extract(const T& item)
 		{
-			return item.m_key;
+			return radix_sort_key<decltype(T::m_key)>::extract(item.m_key);
 		}
 	};
 
-	template<> struct radix_sort_key<int8_t>   { typedef int8_t   radix_type; static int8_t   extract(int8_t item)   { return item; } };
+	template<> struct radix_sort_key<int8_t>   { typedef uint8_t  radix_type; static uint8_t  extract(int8_t item)   { return (uint8_t)((uint8_t)item ^ 0x80u); } };
 	template<> struct radix_sort_key<uint8_t>  { typedef uint8_t  radix_type; static uint8_t  extract(uint8_t item)  { return item; } };
-	template<> struct radix_sort_key<int16_t>  { typedef int16_t  radix_type; static int16_t  extract(int16_t item)  { return item; } };
+	template<> struct radix_sort_key<int16_t>  { typedef uint16_t radix_type; static uint16_t extract(int16_t item)  { return (uint16_t)((uint16_t)item ^ 0x8000u); } };
 	template<> struct radix_sort_key<uint16_t> { typedef uint16_t radix_type; static uint16_t extract(uint16_t item) { return item; } };
-	template<> struct radix_sort_key<int32_t>  { typedef int32_t  radix_type; static int32_t  extract(int32_t item)  { return item; } };
+	template<> struct radix_sort_key<int32_t>  { typedef uint32_t radix_type; static uint32_t extract(int32_t item)  { return (uint32_t)item ^ 0x80000000u; } };
 	template<> struct radix_sort_key<uint32_t> { typedef uint32_t radix_type; static uint32_t extract(uint32_t item) { return item; } };
-	template<> struct radix_sort_key<int64_t>  { typedef int64_t  radix_type; static int64_t  extract(int64_t item)  { return item; } };
+	template<> struct radix_sort_key<int64_t>  { typedef uint64_t radix_type; static uint64_t extract(int64_t item)  { return (uint64_t)item ^ 0x8000000000000000ull; } };
 	template<> struct radix_sort_key<uint64_t> { typedef uint64_t radix_type; static uint64_t extract(uint64_t item) { return item; } };
 
 	template<> struct radix_sort_key<float>
@@ -246,122 +819,201 @@ crstl_module_export namespace crstl
 		}
 	};
 
-	template<typename T>
-	void radix_sort(T* begin, T* end, T* temp_buffer = nullptr)
+	namespace detail
 	{
-		crstl_assert(end >= begin);
+		template<typename T>
+		struct radix_sort_key_projection
+		{
+			typename radix_sort_key<T>::radix_type operator()(const T& item) const
+			{
+				return radix_sort_key<T>::extract(item);
+			}
+		};
 
-		typedef typename radix_sort_key<T>::radix_type radix_type;
+		template<typename KeyType, typename KeyExtractor>
+		struct radix_sort_projection
+		{
+			radix_sort_projection(KeyExtractor& key_extractor) : key_extractor(key_extractor) {}
 
-		const size_t size = (size_t)(end - begin);
+			template<typename T>
+			typename radix_sort_key<KeyType>::radix_type operator()(const T& item) const
+			{
+				return radix_sort_key<KeyType>::extract(key_extractor(item));
+			}
 
-		if (size > 1)
-		{
-			bool free_memory = false;
+			KeyExtractor& key_extractor;
+		};
 
-			// Allocate temporary memory according to our needs
-			T* temp_memory = nullptr;
+		template<typename KeyType, typename T, typename KeyExtractor>
+		struct radix_sort_index_projection
+		{
+			radix_sort_index_projection(const T* data, KeyExtractor& key_extractor) : data(data), key_extractor(key_extractor) {}
 
-			if (temp_buffer)
+			typename radix_sort_key<KeyType>::radix_type operator()(uint32_t index) const
 			{
-				temp_memory = temp_buffer;
+				return radix_sort_key<KeyType>::extract(key_extractor(data[index]));
 			}
-			else
+
+			const T* data;
+
+			KeyExtractor& key_extractor;
+		};
+
+		template<typename T, typename RadixExtractor>
+		void radix_sort_impl(T* begin, T* end, T* temp_buffer, RadixExtractor extract)
+		{
+			crstl_assert(end >= begin);
+
+			typedef decltype(extract(*begin)) radix_type;
+
+			const size_t size = (size_t)(end - begin);
+
+			if (size > 1)
 			{
-				temp_memory = new T[size];
-				free_memory = true;
-			}
+				bool free_memory = false;
 
-			static const size_t kBitsPerPass = 8;
-			static const size_t kBitCount    = sizeof(radix_type) * 8;
-			static const size_t kPassCount   = kBitCount / kBitsPerPass;
-			static const size_t kBucketCount = size_t(1) << kBitsPerPass;
-			static const size_t kBitmask     = kBucketCount - size_t(1);
+				// Allocate temporary memory according to our needs
+				T* temp_memory = nullptr;
 
-			static_assert((kBitCount & kBitsPerPass) == 0, "bit_count has to be a multiple of bits_per_pass");
+				if (temp_buffer)
+				{
+					temp_memory = temp_buffer;
+				}
+				else
+				{
+					temp_memory = new T[size];
+					free_memory = true;
+				}
 
-			uint32_t bucket[kBucketCount * kPassCount] = {};
-			uint32_t bucket_offsets[kBucketCount * kPassCount]; // Don't initialize
+				static const size_t kBitsPerPass = 8;
+				static const size_t kBitCount    = sizeof(radix_type) * 8;
+				static const size_t kPassCount   = kBitCount / kBitsPerPass;
+				static const size_t kBucketCount = size_t(1) << kBitsPerPass;
+				static const size_t kBitmask     = kBucketCount - size_t(1);
 
-			uint32_t bucket_sums[kPassCount] = {};
-			uint8_t  bucket_allequal[kPassCount] = {};
+				static_assert((kBitCount % kBitsPerPass) == 0, "bit_count has to be a multiple of bits_per_pass");
 
-			T* input = begin;
-			T* output = temp_memory;
+				uint32_t bucket[kBucketCount * kPassCount] = {};
+				uint32_t bucket_offsets[kBucketCount * kPassCount]; // Don't initialize
 
-			size_t pass_count = 0;
+				uint8_t  bucket_allequal[kPassCount] = {};
 
-			radix_type candidate0 = radix_sort_key<T>::extract(input[0]);
+				T* input = begin;
+				T* output = temp_memory;
 
-			// Initialize all buckets and compute prefix sum for all passes. This is much faster than computing as we go since we reduce
-			// the number of times we loop through the whole data set
-			for (size_t i = 0; i < size; ++i)
-			{
-				radix_type candidate = radix_sort_key<T>::extract(input[i]);
+				size_t pass_count = 0;
+
+				radix_type candidate0 = extract(input[0]);
+
+				// Initialize all buckets and compute prefix sum for all passes. This is much faster than computing as we go since we reduce
+				// the number of times we loop through the whole data set
+				for (size_t i = 0; i < size; ++i)
+				{
+					radix_type candidate = extract(input[i]);
+
+					for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
+					{
+						size_t pass_shift = pass_index * kBitsPerPass;
+						uint32_t bucket_entry = (candidate >> pass_shift) & kBitmask;
+						bucket[pass_index * kBucketCount + bucket_entry]++;
+					}
+				}
 
 				for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
 				{
 					size_t pass_shift = pass_index * kBitsPerPass;
-					uint32_t bucket_entry = (candidate >> pass_shift) & kBitmask;
-					bucket_sums[pass_index] += bucket_entry;
-					bucket[pass_index * kBucketCount + bucket_entry]++;
-				}
-			}
+					uint32_t bucket_entry0 = (candidate0 >> pass_shift) & kBitmask;
+					bool all_buckets_equal = bucket[pass_index * kBucketCount + bucket_entry0] == size;
+					bucket_allequal[pass_index] = all_buckets_equal;
 
-			for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
-			{
-				size_t pass_shift = pass_index * kBitsPerPass;
-				uint32_t bucket_entry0 = (candidate0 >> pass_shift) & kBitmask;
-				bool all_buckets_equal = (bucket_sums[pass_index] / 255) == bucket_entry0;
-				bucket_allequal[pass_index] = all_buckets_equal;
+					if (!all_buckets_equal)
+					{
+						bucket_offsets[pass_index * kBucketCount] = 0;
+						for (size_t i = 1; i < kBucketCount; ++i)
+						{
+							bucket_offsets[pass_index * kBucketCount + i] = bucket_offsets[pass_index * kBucketCount + i - 1] + bucket[pass_index * kBucketCount + i - 1];
+						}
+					}
+				}
 
-				if (!all_buckets_equal)
+				for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
 				{
-					bucket_offsets[pass_index * kBucketCount] = 0;
-					for (size_t i = 1; i < kBucketCount; ++i)
+					size_t pass_shift = pass_index * kBitsPerPass;
+					bool all_buckets_equal = bucket_allequal[pass_index];
+					if (!all_buckets_equal)
 					{
-						bucket_offsets[pass_index * kBucketCount + i] = bucket_offsets[pass_index * kBucketCount + i - 1] + bucket[pass_index * kBucketCount + i - 1];
+						for (size_t i = 0; i < size; ++i)
+						{
+							radix_type candidate = extract(input[i]);
+							size_t bucket_entry = (size_t)((candidate >> pass_shift) & kBitmask);
+							size_t bucket_offset = bucket_offsets[pass_index * kBucketCount + bucket_entry]++;
+							output[bucket_offset] = crstl_move(input[i]);
+						}
+
+						// Swap input and output
+						T* temp = input;
+						input = output;
+						output = temp;
+
+						pass_count++;
 					}
 				}
-			}
 
-			for (size_t pass_index = 0; pass_index < kPassCount; ++pass_index)
-			{
-				size_t pass_shift = pass_index * kBitsPerPass;
-				bool all_buckets_equal = bucket_allequal[pass_index];
-				if (!all_buckets_equal)
+				// If the last output was written to the temp memory we need to copy it back out
+				if (pass_count & 1)
 				{
 					for (size_t i = 0; i < size; ++i)
 					{
-						radix_type candidate = radix_sort_key<T>::extract(input[i]);
-						size_t bucket_entry = (size_t)((candidate >> pass_shift) & kBitmask);
-						size_t bucket_offset = bucket_offsets[pass_index * kBucketCount + bucket_entry]++;
-						output[bucket_offset] = crstl_move(input[i]);
+						begin[i] = crstl_move(temp_memory[i]);
 					}
-
-					// Swap input and output
-					T* temp = input;
-					input = output;
-					output = temp;
-
-					pass_count++;
 				}
-			}
 
-			// If the last output was written to the temp memory we need to copy it back out
-			if (pass_count & 1)
-			{
-				for (size_t i = 0; i < size; ++i)
+				if (free_memory)
 				{
-					begin[i] = crstl_move(temp_memory[i]);
+					delete[] temp_memory;
 				}
 			}
+		}
 
-			if (free_memory)
-			{
-				delete[] temp_memory;
-			}
+	}
+
+	template<typename T>
+	void radix_sort(T* begin, T* end, T* temp_buffer = nullptr)
+	{
+		detail::radix_sort_impl(begin, end, temp_buffer, detail::radix_sort_key_projection<T>());
+	}
+
+	// Sort the range by the key that key_extractor(const T&) returns, which can be of any type radix_sort_key supports.
+	// Elements are moved whole every pass, so for large elements radix_sort_indices can be faster
+	template<typename T, typename KeyExtractor>
+	void radix_sort_by(T* begin, T* end, KeyExtractor key_extractor, T* temp_buffer = nullptr)
+	{
+		typedef typename remove_cv<typename remove_reference<decltype(key_extractor(*begin))>::type>::type key_type;
+
+		detail::radix_sort_impl(begin, end, temp_buffer, detail::radix_sort_projection<key_type, KeyExtractor>(key_extractor));
+	}
+
+	// Write to indices the permutation that sorts the range by the key key_extractor(const T&) returns, leaving the range
+	// as it is. begin[indices[0]] has the smallest key, and elements with equal keys keep their order. Both indices and
+	// temp_buffer hold as many indices as there are elements. Only the first pass reads the elements in order, the rest
+	// read them through the indices
+	template<typename T, typename KeyExtractor>
+	void radix_sort_indices(const T* begin, const T* end, KeyExtractor key_extractor, uint32_t* indices, uint32_t* temp_buffer = nullptr)
+	{
+		crstl_assert(end >= begin);
+
+		typedef typename remove_cv<typename remove_reference<decltype(key_extractor(*begin))>::type>::type key_type;
+
+		const size_t size = (size_t)(end - begin);
+
+		crstl_assert(size <= 0xffffffffu);
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			indices[i] = (uint32_t)i;
 		}
+
+		detail::radix_sort_impl(indices, indices + size, temp_buffer, detail::radix_sort_index_projection<key_type, T, KeyExtractor>(begin, key_extractor));
 	}
 
 	// Map sort to quick_sort
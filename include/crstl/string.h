@@ -1241,6 +1241,16 @@ crstl_module_export namespace crstl
 		crstl_constexpr bool operator >  (const basic_string& string) const crstl_noexcept { return compare(string) >  0; }
 		crstl_constexpr bool operator >= (const basic_string& string) const crstl_noexcept { return compare(string) >= 0; }
 
+		// Comparisons against other string types without converting them, used by heterogeneous hashmap lookups
+		crstl_constexpr bool operator == (const basic_string_view<CharT>& string) const crstl_noexcept { return compare(string.data(), string.length()) == 0; }
+		crstl_constexpr bool operator != (const basic_string_view<CharT>& string) const crstl_noexcept { return compare(string.data(), string.length()) != 0; }
+
+		template<int N>
+		crstl_constexpr bool operator == (const basic_fixed_string<CharT, N>& string) const crstl_noexcept { return compare(string.data(), string.length()) == 0; }
+
+		template<int N>
+		crstl_constexpr bool operator != (const basic_fixed_string<CharT, N>& string) const crstl_noexcept { return compare(string.data(), string.length()) != 0; }
+
 	private:
 
 		crstl_constexpr size_t compute_new_capacity(size_t old_capacity) const
@@ -1473,11 +1483,5 @@ crstl_module_export namespace crstl
 	template<typename T> struct hash;
 
 	template <typename T, typename Allocator>
-	struct hash<basic_string<T, Allocator>>
-	{
-		size_t operator()(const basic_string<T, Allocator>& string) const
-		{
-			return string_hash(string.c_str(), string.length());
-		}
-	};
+	struct hash<basic_string<T, Allocator>> : transparent_string_hash<T> {};
 };
\ No newline at end of file
@@ -0,0 +1,314 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/crstldef.h"
+
+#include "crstl/fixed_string.h"
+
+#include "crstl/sort.h"
+
+#include "crstl/string.h"
+
+#include "crstl/string_view.h"
+
+#include "crstl/utility/memory_ops.h"
+
+// crstl::string_sort
+//
+// Multikey quicksort for arrays of strings, in the same order as sorting them with less<>
+//
+// https://www.cs.princeton.edu/~rs/strings/paper.pdf
+//
+// - Partitions compare a single character at the current depth into less, equal and greater than the pivot character.
+//   Only the strings in the equal partition go on to the next character, so a common prefix is read once per level
+//   instead of once per comparison
+// - Partitions of up to kStringSortInsertionLimit strings are insertion sorted, comparing from the current depth
+// - The largest of the three partitions is sorted by the same loop and the other two recursively, so the stack depth
+//   is O(log n) regardless of the length of the strings
+// - string_sort_key gives the characters of a string and swaps two of them. basic_string swaps its layout, which holds
+//   either the small string or the pointer to the heap, so characters on the heap are never copied. basic_string_view
+//   swaps the view. basic_fixed_string has to copy its characters, but only up to the length of each string
+//
+
+crstl_module_export namespace crstl
+{
+#if defined(CRSTL_STRING_SORT_INSERTION_SIZE)
+	static const size_t kStringSortInsertionLimit = CRSTL_STRING_SORT_INSERTION_SIZE;
+#else
+	static const size_t kStringSortInsertionLimit = 16;
+#endif
+
+	template<typename T>
+	struct string_sort_key;
+
+	template<typename CharT, typename Allocator>
+	struct string_sort_key<basic_string<CharT, Allocator>>
+	{
+		typedef CharT char_type;
+		typedef basic_string<CharT, Allocator> string_type;
+
+		static const CharT* data(const string_type& string) { return string.data(); }
+
+		static size_t length(const string_type& string) { return string.length(); }
+
+		// Nothing points into the layout of a string, so swapping its bytes swaps the strings
+		static void swap(string_type& string1, string_type& string2)
+		{
+			if (&string1 == &string2)
+			{
+				return;
+			}
+
+			char temp[sizeof(string_type)];
+			crstl::memory_copy(temp, (const void*)&string1, sizeof(string_type));
+			crstl::memory_copy((void*)&string1, (const void*)&string2, sizeof(string_type));
+			crstl::memory_copy((void*)&string2, temp, sizeof(string_type));
+		}
+	};
+
+	template<typename CharT, int NumElements>
+	struct string_sort_key<basic_fixed_string<CharT, NumElements>>
+	{
+		typedef CharT char_type;
+		typedef basic_fixed_string<CharT, NumElements> string_type;
+
+		static const CharT* data(const string_type& string) { return string.data(); }
+
+		static size_t length(const string_type& string) { return string.length(); }
+
+		static void swap(string_type& string1, string_type& string2)
+		{
+			if (&string1 != &string2)
+			{
+				crstl::swap(string1, string2);
+			}
+		}
+	};
+
+	template<typename CharT>
+	struct string_sort_key<basic_string_view<CharT>>
+	{
+		typedef CharT char_type;
+		typedef basic_string_view<CharT> string_type;
+
+		static const CharT* data(const string_type& string) { return string.data(); }
+
+		static size_t length(const string_type& string) { return string.length(); }
+
+		static void swap(string_type& string1, string_type& string2) { crstl::swap(string1, string2); }
+	};
+
+	namespace detail
+	{
+		enum : int64_t
+		{
+			// Less than any character, so shorter strings go first
+			kStringSortEnd = -0x7fffffffffffffffll - 1
+		};
+
+		template<typename T>
+		inline int64_t string_sort_character(const T& string, size_t depth)
+		{
+			typedef string_sort_key<T> key;
+			return depth < key::length(string) ? (int64_t)key::data(string)[depth] : (int64_t)kStringSortEnd;
+		}
+
+		template<typename T>
+		inline void string_sort_swap_range(T* range1, T* range2, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				string_sort_key<T>::swap(range1[i], range2[i]);
+			}
+		}
+
+		// Length of the prefix that all strings share past depth. They all have a character at depth
+		template<typename T>
+		size_t string_sort_common_prefix(const T* begin, size_t size, size_t depth)
+		{
+			typedef string_sort_key<T> key;
+
+			const typename key::char_type* first_data = key::data(begin[0]) + depth;
+			size_t common_length = key::length(begin[0]) - depth;
+
+			for (size_t i = 1; i < size && common_length > 1; ++i)
+			{
+				const typename key::char_type* data = key::data(begin[i]) + depth;
+				const size_t length = key::length(begin[i]) - depth;
+				const size_t max_length = length < common_length ? length : common_length;
+
+				size_t c = 1;
+
+				while (c < max_length && data[c] == first_data[c])
+				{
+					++c;
+				}
+
+				common_length = c;
+			}
+
+			return common_length;
+		}
+
+		// The strings share their first depth characters, so they only need comparing from there
+		template<typename T>
+		void string_sort_insertion(T* begin, size_t size, size_t depth)
+		{
+			typedef string_sort_key<T> key;
+
+			for (size_t i = 1; i < size; ++i)
+			{
+				for (size_t j = i; j > 0; --j)
+				{
+					const size_t length1 = key::length(begin[j]);
+					const size_t length2 = key::length(begin[j - 1]);
+
+					if (crstl::string_compare(key::data(begin[j]) + depth, length1 - depth, key::data(begin[j - 1]) + depth, length2 - depth) >= 0)
+					{
+						break;
+					}
+
+					key::swap(begin[j], begin[j - 1]);
+				}
+			}
+		}
+
+		template<typename T>
+		void string_sort_impl(T* begin, size_t size, size_t depth)
+		{
+			while (size > kStringSortInsertionLimit)
+			{
+				// Put the string with the median character at the front
+				{
+					T* a = begin;
+					T* b = begin + size / 2;
+					T* c = begin + (size - 1);
+
+					const int64_t char_a = string_sort_character(*a, depth);
+					const int64_t char_b = string_sort_character(*b, depth);
+					const int64_t char_c = string_sort_character(*c, depth);
+
+					T* pivot = char_a < char_b ?
+						(char_b < char_c ? b : (char_a < char_c ? c : a)) :
+						(char_a < char_c ? a : (char_b < char_c ? c : b));
+
+					if (pivot != begin)
+					{
+						string_sort_key<T>::swap(*begin, *pivot);
+					}
+				}
+
+				const int64_t pivot_char = string_sort_character(*begin, depth);
+
+				// Strings equal to the pivot gather at both ends while the rest are partitioned in the middle, as in
+				// Bentley and McIlroy's three way partition. They are then swapped into the middle
+				size_t equal_left_end = 1;
+				size_t less_scan = 1;
+				size_t greater_scan = size - 1;
+				size_t equal_right_begin = size - 1;
+
+				while (true)
+				{
+					while (less_scan <= greater_scan)
+					{
+						const int64_t current_char = string_sort_character(begin[less_scan], depth);
+
+						if (current_char > pivot_char)
+						{
+							break;
+						}
+
+						if (current_char == pivot_char)
+						{
+							string_sort_key<T>::swap(begin[equal_left_end], begin[less_scan]);
+							equal_left_end++;
+						}
+
+						less_scan++;
+					}
+
+					while (less_scan <= greater_scan)
+					{
+						const int64_t current_char = string_sort_character(begin[greater_scan], depth);
+
+						if (current_char < pivot_char)
+						{
+							break;
+						}
+
+						if (current_char == pivot_char)
+						{
+							string_sort_key<T>::swap(begin[greater_scan], begin[equal_right_begin]);
+							equal_right_begin--;
+						}
+
+						greater_scan--;
+					}
+
+					if (less_scan > greater_scan)
+					{
+						break;
+					}
+
+					string_sort_key<T>::swap(begin[less_scan], begin[greater_scan]);
+					less_scan++;
+					greater_scan--;
+				}
+
+				const size_t less_count = less_scan - equal_left_end;
+				const size_t greater_count = equal_right_begin - greater_scan;
+
+				size_t swap_count = equal_left_end < less_count ? equal_left_end : less_count;
+				string_sort_swap_range(begin, begin + (less_scan - swap_count), swap_count);
+
+				swap_count = greater_count < (size - 1 - equal_right_begin) ? greater_count : (size - 1 - equal_right_begin);
+				string_sort_swap_range(begin + less_scan, begin + (size - swap_count), swap_count);
+
+				// Strings that end here are all equal and need no more sorting
+				T* equal_begin = begin + less_count;
+				const size_t equal_count = size - less_count - greater_count;
+				const size_t equal_sort_count = pivot_char != kStringSortEnd ? equal_count : 0;
+
+				T* greater_begin = begin + (size - greater_count);
+
+				// Loop on the largest partition and recurse into the others, which have at most half the strings
+				if (less_count >= equal_sort_count && less_count >= greater_count)
+				{
+					string_sort_impl(equal_begin, equal_sort_count, depth + 1);
+					string_sort_impl(greater_begin, greater_count, depth);
+					size = less_count;
+				}
+				else if (greater_count >= equal_sort_count)
+				{
+					string_sort_impl(begin, less_count, depth);
+					string_sort_impl(equal_begin, equal_sort_count, depth + 1);
+					begin = greater_begin;
+					size = greater_count;
+				}
+				else
+				{
+					string_sort_impl(begin, less_count, depth);
+					string_sort_impl(greater_begin, greater_count, depth);
+					begin = equal_begin;
+					size = equal_sort_count;
+
+					// If every string had the pivot character they may share more than that. Skip the whole common
+					// prefix in one pass, instead of one pass per character
+					depth = less_count == 0 && greater_count == 0 ?
+						depth + string_sort_common_prefix(begin, size, depth) : depth + 1;
+				}
+			}
+
+			string_sort_insertion(begin, size, depth);
+		}
+	}
+
+	template<typename T>
+	void string_sort(T* begin, T* end)
+	{
+		crstl_assert(end >= begin);
+
+		detail::string_sort_impl(begin, (size_t)(end - begin), 0);
+	}
+};
@@ -4,6 +4,8 @@
 
 #include "crstl/crstldef.h"
 
+#include "crstl/forward_declarations.h"
+
 #include "crstl/utility/string_common.h"
 
 // crstl::string_view
@@ -29,11 +31,11 @@ crstl_module_export namespace crstl
 
 		static const crstl_constexpr size_type npos = (size_type)-1;
 
-		basic_string_view() crstl_noexcept : m_data(nullptr), m_length(0) {}
+		crstl_constexpr basic_string_view() crstl_noexcept : m_data(nullptr), m_length(0) {}
 
-		basic_string_view(const_pointer ptr) crstl_noexcept : m_data(ptr), m_length(string_length(ptr)) {}
+		crstl_constexpr14 basic_string_view(const_pointer ptr) crstl_noexcept : m_data(ptr), m_length(string_length(ptr)) {}
 
-		basic_string_view(const_pointer ptr, size_type size) : m_data(ptr), m_length(size) {}
+		crstl_constexpr basic_string_view(const_pointer ptr, size_type size) : m_data(ptr), m_length(size) {}
 
 		basic_string_view(const_pointer begin, const_pointer end) : m_data(begin)
 		{
@@ -296,6 +298,31 @@ crstl_module_export namespace crstl
 			return compare(sv) != 0;
 		}
 
+		// Comparisons against other string types without converting them, used by heterogeneous hashmap lookups
+		template<typename Allocator>
+		crstl_constexpr bool operator == (const basic_string<CharT, Allocator>& string) const crstl_noexcept
+		{
+			return compare(string.data(), string.length()) == 0;
+		}
+
+		template<typename Allocator>
+		crstl_constexpr bool operator != (const basic_string<CharT, Allocator>& string) const crstl_noexcept
+		{
+			return compare(string.data(), string.length()) != 0;
+		}
+
+		template<int N>
+		crstl_constexpr bool operator == (const basic_fixed_string<CharT, N>& string) const crstl_noexcept
+		{
+			return compare(string.data(), string.length()) == 0;
+		}
+
+		template<int N>
+		crstl_constexpr bool operator != (const basic_fixed_string<CharT, N>& string) const crstl_noexcept
+		{
+			return compare(string.data(), string.length()) != 0;
+		}
+
 	private:
 
 		// Given a position and a length, return the length that fits the string
@@ -312,4 +339,9 @@ crstl_module_export namespace crstl
 	typedef basic_string_view<char> string_view;
 
 	typedef basic_string_view<wchar_t> wstring_view;
+
+	template<typename T> struct hash;
+
+	template <typename T>
+	struct hash<basic_string_view<T>> : transparent_string_hash<T> {};
 };
\ No newline at end of file
@@ -2,12 +2,33 @@
 
 #include "crstl/config.h"
 
+#include "crstl/bit.h"
+
+#include "crstl/pair.h"
+
 #include "crstl/utility/placement_new.h"
 
 #define crstl_is_pow2(n) (!((n) & ((n) - 1)))
 
 crstl_module_export namespace crstl
 {
+	// Bucket arrays start on a cache line, so that the nodes in a line are always the same ones and a group of control
+	// bytes never straddles two lines
+	static const size_t kHashmapBucketAlignment = 64;
+
+	// Multiply by 2^N / phi (fibonacci hashing). Every bit of the input affects the top bits of the result
+	crstl_forceinline size_t hashmap_mix(size_t hash_value)
+	{
+		crstl_constexpr_if(sizeof(size_t) == 8)
+		{
+			return (size_t)((uint64_t)hash_value * 0x9e3779b97f4a7c15ull);
+		}
+		else
+		{
+			return (size_t)((uint32_t)hash_value * 0x9e3779b9u);
+		}
+	}
+
 	// Compute which bucket a certain hash_value goes into, by taking into account whether it's a power of 2 or not
 
 	template<bool IsPowerOfTwo = false>
@@ -16,10 +37,16 @@ crstl_module_export namespace crstl
 		static size_t compute_bucket(size_t hash_value, size_t bucket_count) { return hash_value % bucket_count; }
 	};
 
+	// Masking the low bits directly would put keys that only differ in their high bits (shifted ids, aligned addresses)
+	// in the same bucket, as integer hashes are the identity. Mix the hash and take its top bits instead, rotating them
+	// down so that a bucket count of 1 doesn't need a shift by the full width
 	template<>
 	struct compute_bucket_function<true>
 	{
-		static size_t compute_bucket(size_t hash_value, size_t bucket_count) { return hash_value & (bucket_count - 1); }
+		static size_t compute_bucket(size_t hash_value, size_t bucket_count)
+		{
+			return crstl::rotl(hashmap_mix(hash_value), crstl::countr_zero(bucket_count)) & (bucket_count - 1);
+		}
 	};
 
 	template<size_t BucketCount>
@@ -30,6 +57,13 @@ crstl_module_export namespace crstl
 		return bucket_index;
 	}
 
+	// Extract the key from the key-value type stored in a node, so that hashmaps and hashsets can share code paths
+	template<typename Key, typename Value>
+	inline const Key& get_key(const crstl::pair<Key, Value>& key_value) { return key_value.first; }
+
+	template<typename Key>
+	inline const Key& get_key(const Key& key) { return key; }
+
 	// To be able to select between a const and a non-const object for const and non-const iterators
 	template <bool Condition, class IsTrueType, class IsFalseType>
 	struct hashmap_type_select { typedef IsTrueType type; };
@@ -37,6 +71,76 @@ crstl_module_export namespace crstl
 	template <typename IsTrueType, class IsFalseType>
 	struct hashmap_type_select<false, IsTrueType, IsFalseType> { typedef IsFalseType type; };
 
+	// Detects whether Hasher declares is_transparent, meaning it can hash types other than the key consistently with it
+	template<typename Hasher>
+	struct hasher_is_transparent
+	{
+		template<typename U> static char test(typename U::is_transparent*);
+		template<typename U> static long test(...);
+		static const bool value = sizeof(test<Hasher>(nullptr)) == sizeof(char);
+	};
+
+	// Detects whether Allocator has allocate_aligned and deallocate_aligned, like crstl::allocator. Custom allocators
+	// might only have allocate and deallocate
+	template<typename Allocator>
+	struct allocator_has_aligned
+	{
+		template<typename U> static char test(decltype(((U*)nullptr)->allocate_aligned(size_t(), size_t()))*);
+		template<typename U> static long test(...);
+		static const bool value = sizeof(test<Allocator>(nullptr)) == sizeof(char);
+	};
+
+	// Allocate the bucket arrays on kHashmapBucketAlignment through the allocator's aligned functions if it has them.
+	// Otherwise allocate enough to round the pointer up and store the original pointer right before the one we return
+	template<typename Allocator, bool HasAligned = allocator_has_aligned<Allocator>::value>
+	struct hashmap_bucket_allocator
+	{
+		static void* allocate(Allocator& allocator, size_t size_bytes)
+		{
+			return allocator.allocate_aligned(size_bytes, kHashmapBucketAlignment);
+		}
+
+		static void deallocate(Allocator& allocator, void* p, size_t size_bytes)
+		{
+			allocator.deallocate_aligned(p, size_bytes, kHashmapBucketAlignment);
+		}
+	};
+
+	template<typename Allocator>
+	struct hashmap_bucket_allocator<Allocator, false>
+	{
+		static void* allocate(Allocator& allocator, size_t size_bytes)
+		{
+			void* p = allocator.allocate(size_bytes + kHashmapBucketAlignment + sizeof(void*));
+			void* aligned_p = (void*)(((uintptr_t)p + sizeof(void*) + kHashmapBucketAlignment - 1) & ~(uintptr_t)(kHashmapBucketAlignment - 1));
+			((void**)aligned_p)[-1] = p;
+			return aligned_p;
+		}
+
+		static void deallocate(Allocator& allocator, void* p, size_t size_bytes)
+		{
+			if (p)
+			{
+				allocator.deallocate(((void**)p)[-1], size_bytes + kHashmapBucketAlignment + sizeof(void*));
+			}
+		}
+	};
+
+	// Transparent hashers get the lookup key as is. Otherwise the lookup key is converted to the key type first, as the
+	// hasher might not produce the same hash for it
+	template<typename Hasher, typename Key, bool IsTransparent = hasher_is_transparent<Hasher>::value>
+	struct hashmap_hash_selector
+	{
+		template<typename KeyType>
+		static crstl_constexpr14 size_t hash(const KeyType& key) { return Hasher()(key); }
+	};
+
+	template<typename Hasher, typename Key>
+	struct hashmap_hash_selector<Hasher, Key, false>
+	{
+		static crstl_constexpr14 size_t hash(const Key& key) { return Hasher()(key); }
+	};
+
 	// Behavior to run when node exists already
 	namespace exists_behavior
 	{
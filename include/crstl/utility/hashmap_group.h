@@ -0,0 +1,231 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/crstldef.h"
+
+#include "crstl/bit.h"
+
+#include "crstl/utility/hashmap_common.h"
+
+// Group probing primitives for hashtables that store a separate array of control bytes
+//
+// Every slot has a one-byte control tag. Full slots store 7 bits of the hash (h2) and have the top bit clear, whereas
+// empty and deleted slots have the top bit set. A group of 16 control bytes is loaded at once and compared against a
+// tag, producing a bitmask of candidate slots. Keys are only compared for slots whose tag matched
+//
+// https://abseil.io/about/design/swisstables
+
+#if defined(CRSTL_ARCH_X86_64) || (defined(CRSTL_ARCH_X86) && (defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)))
+
+	#define CRSTL_HASHMAP_GROUP_SSE2
+
+	// GCC and Clang expose the instructions we need as builtins, which avoids pulling in the intrinsic headers
+	#if defined(CRSTL_COMPILER_MSVC)
+		#include <emmintrin.h>
+	#endif
+
+#elif defined(CRSTL_ARCH_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__) || (defined(CRSTL_COMPILER_MSVC) && defined(CRSTL_ARCH_ARM32))
+
+	#define CRSTL_HASHMAP_GROUP_NEON
+
+	#if defined(CRSTL_COMPILER_MSVC) && defined(CRSTL_ARCH_ARM64)
+		#include <arm64_neon.h>
+	#else
+		#include <arm_neon.h>
+	#endif
+
+#endif
+
+crstl_module_export namespace crstl
+{
+	namespace hashmap_ctrl
+	{
+		enum t : int8_t
+		{
+			empty   = -128, // 0b10000000
+			deleted = -2,   // 0b11111110
+			// Full slots store h2 as 0b0hhhhhhh
+		};
+	};
+
+	// Split the hash into the group index (h1) and the control tag (h2). We always mix the incoming hash because
+	// many hashers (integers, floats) are the identity, and taking bits straight from them would put consecutive
+	// keys in the same group with the same tag
+	crstl_forceinline size_t hashmap_group_mix(size_t hash_value)
+	{
+		return hashmap_mix(hash_value);
+	}
+
+	// The top bits of the product are the best mixed, so use them for the tag and rotate the middle bits down for h1
+	crstl_forceinline size_t hashmap_group_h1(size_t mixed_hash)
+	{
+		return crstl::rotl(mixed_hash, (int)(sizeof(size_t) * 4));
+	}
+
+	crstl_forceinline int8_t hashmap_group_h2(size_t mixed_hash)
+	{
+		return (int8_t)(mixed_hash >> (sizeof(size_t) * 8 - 7));
+	}
+
+	// A bitmask where each set bit represents a slot in the group. Iterating it gives the slot indices in ascending order
+	class hashmap_group_mask
+	{
+	public:
+
+#if defined(CRSTL_HASHMAP_GROUP_NEON)
+		typedef uint64_t mask_type;
+		static const int kShift = 2; // NEON has no movemask, so every slot is represented by 4 bits
+#else
+		typedef uint32_t mask_type;
+		static const int kShift = 0;
+#endif
+
+		explicit hashmap_group_mask(mask_type mask) : m_mask(mask) {}
+
+		bool any() const { return m_mask != 0; }
+
+		uint32_t lowest() const { return (uint32_t)(crstl::countr_zero(m_mask) >> kShift); }
+
+		void clear_lowest() { m_mask &= (m_mask - 1); }
+
+	private:
+
+		mask_type m_mask;
+	};
+
+	class hashmap_group
+	{
+	public:
+
+		static const size_t kWidth = 16;
+
+#if defined(CRSTL_HASHMAP_GROUP_SSE2) && defined(CRSTL_COMPILER_MSVC)
+
+		explicit hashmap_group(const int8_t* ctrl) : m_ctrl(_mm_loadu_si128((const __m128i*)ctrl)) {}
+
+		hashmap_group_mask match(int8_t h2) const
+		{
+			return hashmap_group_mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(h2))));
+		}
+
+		hashmap_group_mask match_empty() const
+		{
+			return hashmap_group_mask((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(m_ctrl, _mm_set1_epi8(hashmap_ctrl::empty))));
+		}
+
+		// Both empty and deleted have the top bit set so we can extract them directly
+		hashmap_group_mask match_empty_or_deleted() const
+		{
+			return hashmap_group_mask((uint32_t)_mm_movemask_epi8(m_ctrl));
+		}
+
+	private:
+
+		__m128i m_ctrl;
+
+#elif defined(CRSTL_HASHMAP_GROUP_SSE2)
+
+		typedef char vector_type __attribute__((vector_size(16)));
+
+		explicit hashmap_group(const int8_t* ctrl) { __builtin_memcpy(&m_ctrl, ctrl, sizeof(m_ctrl)); }
+
+		hashmap_group_mask match(int8_t h2) const
+		{
+			return hashmap_group_mask((uint32_t)__builtin_ia32_pmovmskb128((vector_type)(m_ctrl == splat(h2))));
+		}
+
+		hashmap_group_mask match_empty() const
+		{
+			return match(hashmap_ctrl::empty);
+		}
+
+		// Both empty and deleted have the top bit set so we can extract them directly
+		hashmap_group_mask match_empty_or_deleted() const
+		{
+			return hashmap_group_mask((uint32_t)__builtin_ia32_pmovmskb128(m_ctrl));
+		}
+
+	private:
+
+		static vector_type splat(int8_t value)
+		{
+			const char c = (char)value;
+			vector_type result = { c, c, c, c, c, c, c, c, c, c, c, c, c, c, c, c };
+			return result;
+		}
+
+		vector_type m_ctrl;
+
+#elif defined(CRSTL_HASHMAP_GROUP_NEON)
+
+		explicit hashmap_group(const int8_t* ctrl) : m_ctrl(vld1q_s8(ctrl)) {}
+
+		hashmap_group_mask match(int8_t h2) const
+		{
+			return to_mask(vceqq_s8(m_ctrl, vdupq_n_s8(h2)));
+		}
+
+		hashmap_group_mask match_empty() const
+		{
+			return to_mask(vceqq_s8(m_ctrl, vdupq_n_s8(hashmap_ctrl::empty)));
+		}
+
+		hashmap_group_mask match_empty_or_deleted() const
+		{
+			return to_mask(vcltq_s8(m_ctrl, vdupq_n_s8(0)));
+		}
+
+	private:
+
+		// Narrow every 16-bit lane by 4 bits, which leaves a nibble per byte. Keep one bit per nibble
+		static hashmap_group_mask to_mask(uint8x16_t comparison)
+		{
+			uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(comparison), 4);
+			return hashmap_group_mask(vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ull);
+		}
+
+		int8x16_t m_ctrl;
+
+#else
+
+		explicit hashmap_group(const int8_t* ctrl)
+		{
+			for (size_t i = 0; i < kWidth; ++i)
+			{
+				m_ctrl[i] = ctrl[i];
+			}
+		}
+
+		hashmap_group_mask match(int8_t h2) const
+		{
+			uint32_t mask = 0;
+			for (uint32_t i = 0; i < kWidth; ++i)
+			{
+				mask |= (uint32_t)(m_ctrl[i] == h2) << i;
+			}
+			return hashmap_group_mask(mask);
+		}
+
+		hashmap_group_mask match_empty() const
+		{
+			return match(hashmap_ctrl::empty);
+		}
+
+		hashmap_group_mask match_empty_or_deleted() const
+		{
+			uint32_t mask = 0;
+			for (uint32_t i = 0; i < kWidth; ++i)
+			{
+				mask |= (uint32_t)(m_ctrl[i] < 0) << i;
+			}
+			return hashmap_group_mask(mask);
+		}
+
+	private:
+
+		int8_t m_ctrl[kWidth];
+
+#endif
+	};
+};
@@ -0,0 +1,251 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/crstldef.h"
+
+// crstl::hashmap_stats
+//
+// Opt-in instrumentation for the open addressing hashmaps, enabled by defining CRSTL_HASHMAP_STATS. Without it the
+// hashmaps have no stats member and every crstl_hashmap_stats() statement compiles away
+//
+// - Probe lengths count the nodes visited past the bucket the key hashes to, so a key found in its own bucket has a
+//   probe length of 0
+// - Erasing shifts the nodes that follow back towards their bucket, and erases report how many nodes they shifted. The
+//   old table of open_incremental_hashmap is the exception, it leaves tombstones and records nothing
+// - Lookups are const and may run concurrently, e.g. under concurrent_open_hashmap's shared lock or from
+//   snapshot_hashmap's readers, so their counters are relaxed atomics. Inserts, erases and rehashes already need
+//   exclusive access and update theirs without synchronization
+// - Tables viewed in place with fixed_open_hashmap::view_from_memory don't record lookups, as the memory may be read
+//   only. Their stats were saved as zeros, which is what turns recording off
+//
+
+#if defined(CRSTL_HASHMAP_STATS)
+	#define crstl_hashmap_stats(x) x
+#else
+	#define crstl_hashmap_stats(x)
+#endif
+
+#if defined(CRSTL_HASHMAP_STATS)
+
+#include "crstl/atomic.h"
+
+crstl_module_export namespace crstl
+{
+	struct hashmap_stats
+	{
+		// The last entry of a histogram also counts every longer probe
+		enum
+		{
+			kProbeHistogramSize = 32
+		};
+
+		hashmap_stats() { reset(); }
+
+		void reset()
+		{
+			find_count = 0;
+			find_miss_count = 0;
+			find_probe_total = 0;
+			find_probe_max = 0;
+			insert_count = 0;
+			insert_probe_total = 0;
+			insert_probe_max = 0;
+			erase_count = 0;
+			erase_shift_count = 0;
+			rehash_count = 0;
+			rehash_bytes_moved = 0;
+
+			for (size_t i = 0; i < kProbeHistogramSize; ++i)
+			{
+				find_probe_histogram[i] = 0;
+				insert_probe_histogram[i] = 0;
+			}
+
+			length = 0;
+			bucket_count = 0;
+			load_factor = 0.0f;
+			cluster_count = 0;
+			cluster_max = 0;
+			cluster_mean = 0.0f;
+		}
+
+		void record_insert(size_t probe_length)
+		{
+			insert_count++;
+			insert_probe_total += probe_length;
+			insert_probe_max = probe_length > insert_probe_max ? probe_length : insert_probe_max;
+			insert_probe_histogram[probe_length < kProbeHistogramSize ? probe_length : kProbeHistogramSize - 1]++;
+		}
+
+		void record_erase(size_t shift_count)
+		{
+			erase_count++;
+			erase_shift_count += shift_count;
+		}
+
+		void record_erase_batch(size_t erased_count, size_t shift_count)
+		{
+			erase_count += erased_count;
+			erase_shift_count += shift_count;
+		}
+
+		void record_rehash(size_t bytes_moved)
+		{
+			rehash_count++;
+			rehash_bytes_moved += bytes_moved;
+		}
+
+		// Call function(const char* name, size_t index, double value) for every value, e.g. to write rows of a CSV file.
+		// Histogram entries pass their probe length as the index, every other value passes 0
+		template<typename Function>
+		void for_each_value(Function function) const
+		{
+			function("find_count", 0, (double)find_count);
+			function("find_miss_count", 0, (double)find_miss_count);
+			function("find_probe_mean", 0, find_count == 0 ? 0.0 : (double)find_probe_total / (double)find_count);
+			function("find_probe_max", 0, (double)find_probe_max);
+			function("insert_count", 0, (double)insert_count);
+			function("insert_probe_mean", 0, insert_count == 0 ? 0.0 : (double)insert_probe_total / (double)insert_count);
+			function("insert_probe_max", 0, (double)insert_probe_max);
+			function("erase_count", 0, (double)erase_count);
+			function("erase_shift_count", 0, (double)erase_shift_count);
+			function("rehash_count", 0, (double)rehash_count);
+			function("rehash_bytes_moved", 0, (double)rehash_bytes_moved);
+			function("length", 0, (double)length);
+			function("bucket_count", 0, (double)bucket_count);
+			function("load_factor", 0, (double)load_factor);
+			function("cluster_count", 0, (double)cluster_count);
+			function("cluster_max", 0, (double)cluster_max);
+			function("cluster_mean", 0, (double)cluster_mean);
+
+			for (size_t i = 0; i < kProbeHistogramSize; ++i)
+			{
+				function("find_probe_histogram", i, (double)find_probe_histogram[i]);
+			}
+
+			for (size_t i = 0; i < kProbeHistogramSize; ++i)
+			{
+				function("insert_probe_histogram", i, (double)insert_probe_histogram[i]);
+			}
+		}
+
+		// Lookups through find, count and their hashed and batched versions
+
+		uint64_t find_count;
+
+		uint64_t find_miss_count;
+
+		uint64_t find_probe_total;
+
+		uint64_t find_probe_max;
+
+		uint64_t find_probe_histogram[kProbeHistogramSize];
+
+		// Inserts and emplaces, including the ones that find the key already there
+
+		uint64_t insert_count;
+
+		uint64_t insert_probe_total;
+
+		uint64_t insert_probe_max;
+
+		uint64_t insert_probe_histogram[kProbeHistogramSize];
+
+		uint64_t erase_count;
+
+		uint64_t erase_shift_count;
+
+		uint64_t rehash_count;
+
+		uint64_t rehash_bytes_moved;
+
+		// The state of the table when the stats were taken. A cluster is a run of consecutive valid nodes
+
+		size_t length;
+
+		size_t bucket_count;
+
+		float load_factor;
+
+		size_t cluster_count;
+
+		size_t cluster_max;
+
+		float cluster_mean;
+	};
+
+	// Lookup counters, kept apart from hashmap_stats as they are updated from const functions
+	struct hashmap_find_stats
+	{
+		hashmap_find_stats() : enabled(1) { reset(); }
+
+		void reset()
+		{
+			find_count = 0;
+			find_miss_count = 0;
+			find_probe_total = 0;
+			find_probe_max = 0;
+
+			for (size_t i = 0; i < hashmap_stats::kProbeHistogramSize; ++i)
+			{
+				find_probe_histogram[i] = 0;
+			}
+		}
+
+		void record_find(size_t probe_length, bool found) const
+		{
+			if (!enabled)
+			{
+				return;
+			}
+
+			atomic_add_relaxed(&find_count, 1);
+			atomic_add_relaxed(&find_miss_count, found ? 0 : 1);
+			atomic_add_relaxed(&find_probe_total, (int64_t)probe_length);
+			atomic_add_relaxed(&find_probe_histogram[probe_length < hashmap_stats::kProbeHistogramSize ? probe_length : hashmap_stats::kProbeHistogramSize - 1], 1);
+
+			int64_t probe_max = atomic_load_relaxed(&find_probe_max);
+
+			while ((int64_t)probe_length > probe_max)
+			{
+				const int64_t previous_max = atomic_compare_exchange(&find_probe_max, (int64_t)probe_length, probe_max);
+
+				if (previous_max == probe_max)
+				{
+					break;
+				}
+
+				probe_max = previous_max;
+			}
+		}
+
+		void copy_to(hashmap_stats& stats) const
+		{
+			stats.find_count = (uint64_t)atomic_load_relaxed(&find_count);
+			stats.find_miss_count = (uint64_t)atomic_load_relaxed(&find_miss_count);
+			stats.find_probe_total = (uint64_t)atomic_load_relaxed(&find_probe_total);
+			stats.find_probe_max = (uint64_t)atomic_load_relaxed(&find_probe_max);
+
+			for (size_t i = 0; i < hashmap_stats::kProbeHistogramSize; ++i)
+			{
+				stats.find_probe_histogram[i] = (uint64_t)atomic_load_relaxed(&find_probe_histogram[i]);
+			}
+		}
+
+		// Zero in a table viewed from saved memory, which must not be written to
+		int64_t enabled;
+
+		mutable int64_t find_count;
+
+		mutable int64_t find_miss_count;
+
+		mutable int64_t find_probe_total;
+
+		mutable int64_t find_probe_max;
+
+		mutable int64_t find_probe_histogram[hashmap_stats::kProbeHistogramSize];
+	};
+};
+
+#endif
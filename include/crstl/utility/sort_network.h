@@ -0,0 +1,564 @@
+#pragma once
+
+#include "crstl/config.h"
+
+#include "crstl/crstldef.h"
+
+#include "crstl/utility/cast.h"
+
+// Sorting networks for small arrays of primitive types in SIMD registers
+//
+// The elements are loaded into registers of kLanes elements. Every group of kLanes registers is sorted column-wise, with
+// min and max across registers, and transposed so that each register holds a sorted run. The runs are then merged in
+// pairs with bitonic merges, first across registers and finally within each register, until a single run remains. There
+// are no branches, and every array of the same size goes through the same instructions
+//
+// https://www.vldb.org/pvldb/vol8/p1274-inoue.pdf
+//
+// sort_network_ops<T> describes the registers for a type on the current platform, and has kLanes = 0 if there are none.
+// 32-bit types need SSE4.1 or NEON. int64_t needs AVX2, SSE4.2 or 64-bit NEON, as SSE4.1 can't compare 64-bit lanes.
+// Floats are sorted as integers after flipping the bits of negative numbers, which keeps NaNs instead of losing them
+// through min and max
+
+#if defined(__AVX2__)
+
+	#define CRSTL_SORT_NETWORK_SSE4_1
+	#define CRSTL_SORT_NETWORK_AVX2
+	#include <immintrin.h>
+
+#elif defined(__SSE4_2__)
+
+	#define CRSTL_SORT_NETWORK_SSE4_1
+	#define CRSTL_SORT_NETWORK_SSE4_2
+	#include <nmmintrin.h>
+
+#elif defined(__SSE4_1__)
+
+	#define CRSTL_SORT_NETWORK_SSE4_1
+	#include <smmintrin.h>
+
+#elif defined(CRSTL_ARCH_ARM64) || defined(__ARM_NEON) || defined(__ARM_NEON__)
+
+	#define CRSTL_SORT_NETWORK_NEON
+
+	#if defined(CRSTL_COMPILER_MSVC) && defined(CRSTL_ARCH_ARM64)
+		#include <arm64_neon.h>
+	#else
+		#include <arm_neon.h>
+	#endif
+
+#endif
+
+crstl_module_export namespace crstl
+{
+	namespace detail
+	{
+		enum : size_t
+		{
+			kSortNetworkMaxSize = 64
+		};
+
+		template<typename T>
+		struct sort_network_ops
+		{
+			static const size_t kLanes = 0;
+		};
+
+#if defined(CRSTL_SORT_NETWORK_SSE4_1)
+
+		template<bool Unsigned>
+		struct sort_network_sse_32
+		{
+			typedef __m128i vector_type;
+
+			static const size_t kLanes = 4;
+
+			static crstl_forceinline vector_type min(vector_type a, vector_type b) { return Unsigned ? _mm_min_epu32(a, b) : _mm_min_epi32(a, b); }
+
+			static crstl_forceinline vector_type max(vector_type a, vector_type b) { return Unsigned ? _mm_max_epu32(a, b) : _mm_max_epi32(a, b); }
+
+			static crstl_forceinline vector_type reverse(vector_type v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+			// Sorts a bitonic register, comparing lanes 2 apart and then 1 apart
+			static crstl_forceinline vector_type merge(vector_type v)
+			{
+				vector_type t = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+				v = _mm_blend_epi16(min(v, t), max(v, t), 0xf0);
+				t = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+				return _mm_blend_epi16(min(v, t), max(v, t), 0xcc);
+			}
+
+			// Sorts both pairs, and reverses the second one to make the register bitonic
+			static crstl_forceinline vector_type sort(vector_type v)
+			{
+				const vector_type t = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+				v = _mm_blend_epi16(min(v, t), max(v, t), 0xcc);
+				return merge(_mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 1, 0)));
+			}
+
+			static crstl_forceinline void transpose(vector_type* r)
+			{
+				const vector_type t0 = _mm_unpacklo_epi32(r[0], r[1]);
+				const vector_type t1 = _mm_unpacklo_epi32(r[2], r[3]);
+				const vector_type t2 = _mm_unpackhi_epi32(r[0], r[1]);
+				const vector_type t3 = _mm_unpackhi_epi32(r[2], r[3]);
+				r[0] = _mm_unpacklo_epi64(t0, t1);
+				r[1] = _mm_unpackhi_epi64(t0, t1);
+				r[2] = _mm_unpacklo_epi64(t2, t3);
+				r[3] = _mm_unpackhi_epi64(t2, t3);
+			}
+		};
+
+		template<>
+		struct sort_network_ops<int32_t> : sort_network_sse_32<false>
+		{
+			static crstl_forceinline vector_type load(const int32_t* data) { return _mm_loadu_si128((const __m128i*)data); }
+
+			static crstl_forceinline void store(int32_t* data, vector_type v) { _mm_storeu_si128((__m128i*)data, v); }
+
+			static int32_t padding() { return 0x7fffffff; }
+		};
+
+		template<>
+		struct sort_network_ops<uint32_t> : sort_network_sse_32<true>
+		{
+			static crstl_forceinline vector_type load(const uint32_t* data) { return _mm_loadu_si128((const __m128i*)data); }
+
+			static crstl_forceinline void store(uint32_t* data, vector_type v) { _mm_storeu_si128((__m128i*)data, v); }
+
+			static uint32_t padding() { return 0xffffffffu; }
+		};
+
+		template<>
+		struct sort_network_ops<float> : sort_network_sse_32<false>
+		{
+			// Flipping every bit but the sign of negative numbers orders them as signed integers. Flipping them again
+			// restores the float
+			static crstl_forceinline vector_type flip(vector_type v) { return _mm_xor_si128(v, _mm_srli_epi32(_mm_srai_epi32(v, 31), 1)); }
+
+			static crstl_forceinline vector_type load(const float* data) { return flip(_mm_loadu_si128((const __m128i*)data)); }
+
+			static crstl_forceinline void store(float* data, vector_type v) { _mm_storeu_si128((__m128i*)data, flip(v)); }
+
+			// The largest integer is a NaN
+			static float padding() { return union_cast<float>(0x7fffffffu); }
+		};
+
+	#if defined(CRSTL_SORT_NETWORK_AVX2)
+
+		template<>
+		struct sort_network_ops<int64_t>
+		{
+			typedef __m256i vector_type;
+
+			static const size_t kLanes = 4;
+
+			static crstl_forceinline vector_type load(const int64_t* data) { return _mm256_loadu_si256((const __m256i*)data); }
+
+			static crstl_forceinline void store(int64_t* data, vector_type v) { _mm256_storeu_si256((__m256i*)data, v); }
+
+			static int64_t padding() { return 0x7fffffffffffffffll; }
+
+			static crstl_forceinline vector_type min(vector_type a, vector_type b) { return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b)); }
+
+			static crstl_forceinline vector_type max(vector_type a, vector_type b) { return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b)); }
+
+			static crstl_forceinline vector_type reverse(vector_type v) { return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+			static crstl_forceinline vector_type merge(vector_type v)
+			{
+				vector_type t = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 3, 2));
+				v = _mm256_blend_epi32(min(v, t), max(v, t), 0xf0);
+				t = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 3, 0, 1));
+				return _mm256_blend_epi32(min(v, t), max(v, t), 0xcc);
+			}
+
+			static crstl_forceinline vector_type sort(vector_type v)
+			{
+				const vector_type t = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 3, 0, 1));
+				v = _mm256_blend_epi32(min(v, t), max(v, t), 0xcc);
+				return merge(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 3, 1, 0)));
+			}
+
+			static crstl_forceinline void transpose(vector_type* r)
+			{
+				const vector_type t0 = _mm256_unpacklo_epi64(r[0], r[1]);
+				const vector_type t1 = _mm256_unpackhi_epi64(r[0], r[1]);
+				const vector_type t2 = _mm256_unpacklo_epi64(r[2], r[3]);
+				const vector_type t3 = _mm256_unpackhi_epi64(r[2], r[3]);
+				r[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+				r[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+				r[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+				r[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+			}
+		};
+
+	#elif defined(CRSTL_SORT_NETWORK_SSE4_2)
+
+		template<>
+		struct sort_network_ops<int64_t>
+		{
+			typedef __m128i vector_type;
+
+			static const size_t kLanes = 2;
+
+			static crstl_forceinline vector_type load(const int64_t* data) { return _mm_loadu_si128((const __m128i*)data); }
+
+			static crstl_forceinline void store(int64_t* data, vector_type v) { _mm_storeu_si128((__m128i*)data, v); }
+
+			static int64_t padding() { return 0x7fffffffffffffffll; }
+
+			static crstl_forceinline vector_type min(vector_type a, vector_type b) { return _mm_blendv_epi8(a, b, _mm_cmpgt_epi64(a, b)); }
+
+			static crstl_forceinline vector_type max(vector_type a, vector_type b) { return _mm_blendv_epi8(b, a, _mm_cmpgt_epi64(a, b)); }
+
+			static crstl_forceinline vector_type reverse(vector_type v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+
+			static crstl_forceinline vector_type merge(vector_type v)
+			{
+				const vector_type t = reverse(v);
+				return _mm_blend_epi16(min(v, t), max(v, t), 0xf0);
+			}
+
+			static crstl_forceinline vector_type sort(vector_type v) { return merge(v); }
+
+			static crstl_forceinline void transpose(vector_type* r)
+			{
+				const vector_type t0 = _mm_unpacklo_epi64(r[0], r[1]);
+				r[1] = _mm_unpackhi_epi64(r[0], r[1]);
+				r[0] = t0;
+			}
+		};
+
+	#endif
+
+#elif defined(CRSTL_SORT_NETWORK_NEON)
+
+		// NEON has the same operations for every 32-bit lane type, under different names. vtrnq is used instead of
+		// vtrn1q so that 32-bit ARM has them too
+		#define crstl_sort_network_neon_32(T, S)                                                                            \
+		template<>                                                                                                          \
+		struct sort_network_ops<T>                                                                                          \
+		{                                                                                                                   \
+			typedef S##x4_t vector_type;                                                                                    \
+			static const size_t kLanes = 4;                                                                                 \
+			static crstl_forceinline vector_type min(vector_type a, vector_type b) { return vminq_##S(a, b); }              \
+			static crstl_forceinline vector_type max(vector_type a, vector_type b) { return vmaxq_##S(a, b); }              \
+			static crstl_forceinline vector_type reverse(vector_type v) { v = vrev64q_##S(v); return vextq_##S(v, v, 2); }  \
+			static crstl_forceinline vector_type merge(vector_type v)                                                       \
+			{                                                                                                               \
+				vector_type t = vextq_##S(v, v, 2);                                                                         \
+				v = vcombine_##S(vget_low_##S(min(v, t)), vget_high_##S(max(v, t)));                                        \
+				t = vrev64q_##S(v);                                                                                         \
+				return vtrnq_##S(min(v, t), max(v, t)).val[0];                                                              \
+			}                                                                                                               \
+			static crstl_forceinline vector_type sort(vector_type v)                                                        \
+			{                                                                                                               \
+				const vector_type t = vrev64q_##S(v);                                                                       \
+				v = vtrnq_##S(min(v, t), max(v, t)).val[0];                                                                 \
+				return merge(vcombine_##S(vget_low_##S(v), vrev64_##S(vget_high_##S(v))));                                  \
+			}                                                                                                               \
+			static crstl_forceinline void transpose(vector_type* r)                                                         \
+			{                                                                                                               \
+				const S##x4x2_t t01 = vtrnq_##S(r[0], r[1]);                                                                \
+				const S##x4x2_t t23 = vtrnq_##S(r[2], r[3]);                                                                \
+				r[0] = vcombine_##S(vget_low_##S(t01.val[0]), vget_low_##S(t23.val[0]));                                    \
+				r[1] = vcombine_##S(vget_low_##S(t01.val[1]), vget_low_##S(t23.val[1]));                                    \
+				r[2] = vcombine_##S(vget_high_##S(t01.val[0]), vget_high_##S(t23.val[0]));                                  \
+				r[3] = vcombine_##S(vget_high_##S(t01.val[1]), vget_high_##S(t23.val[1]));                                  \
+			}
+
+		crstl_sort_network_neon_32(int32_t, s32)
+
+			static crstl_forceinline vector_type load(const int32_t* data) { return vld1q_s32(data); }
+
+			static crstl_forceinline void store(int32_t* data, vector_type v) { vst1q_s32(data, v); }
+
+			static int32_t padding() { return 0x7fffffff; }
+		};
+
+		crstl_sort_network_neon_32(uint32_t, u32)
+
+			static crstl_forceinline vector_type load(const uint32_t* data) { return vld1q_u32(data); }
+
+			static crstl_forceinline void store(uint32_t* data, vector_type v) { vst1q_u32(data, v); }
+
+			static uint32_t padding() { return 0xffffffffu; }
+		};
+
+		crstl_sort_network_neon_32(float, s32)
+
+			// Flipping every bit but the sign of negative numbers orders them as signed integers. Flipping them again
+			// restores the float
+			static crstl_forceinline vector_type flip(vector_type v)
+			{
+				return veorq_s32(v, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(v, 31)), 1)));
+			}
+
+			static crstl_forceinline vector_type load(const float* data) { return flip(vreinterpretq_s32_f32(vld1q_f32(data))); }
+
+			static crstl_forceinline void store(float* data, vector_type v) { vst1q_f32(data, vreinterpretq_f32_s32(flip(v))); }
+
+			// The largest integer is a NaN
+			static float padding() { return union_cast<float>(0x7fffffffu); }
+		};
+
+		#undef crstl_sort_network_neon_32
+
+	#if defined(CRSTL_ARCH_ARM64)
+
+		template<>
+		struct sort_network_ops<int64_t>
+		{
+			typedef int64x2_t vector_type;
+
+			static const size_t kLanes = 2;
+
+			static crstl_forceinline vector_type load(const int64_t* data) { return vld1q_s64(data); }
+
+			static crstl_forceinline void store(int64_t* data, vector_type v) { vst1q_s64(data, v); }
+
+			static int64_t padding() { return 0x7fffffffffffffffll; }
+
+			static crstl_forceinline vector_type min(vector_type a, vector_type b) { return vbslq_s64(vcgtq_s64(a, b), b, a); }
+
+			static crstl_forceinline vector_type max(vector_type a, vector_type b) { return vbslq_s64(vcgtq_s64(a, b), a, b); }
+
+			static crstl_forceinline vector_type reverse(vector_type v) { return vextq_s64(v, v, 1); }
+
+			static crstl_forceinline vector_type merge(vector_type v)
+			{
+				const vector_type t = reverse(v);
+				return vcombine_s64(vget_low_s64(min(v, t)), vget_high_s64(max(v, t)));
+			}
+
+			static crstl_forceinline vector_type sort(vector_type v) { return merge(v); }
+
+			static crstl_forceinline void transpose(vector_type* r)
+			{
+				const vector_type t0 = vcombine_s64(vget_low_s64(r[0]), vget_low_s64(r[1]));
+				r[1] = vcombine_s64(vget_high_s64(r[0]), vget_high_s64(r[1]));
+				r[0] = t0;
+			}
+		};
+
+	#endif
+
+#endif
+
+		template<typename T>
+		struct sort_network_enabled
+		{
+			static const bool value = sort_network_ops<T>::kLanes != 0;
+		};
+
+		template<typename Ops>
+		crstl_forceinline void sort_network_exchange(typename Ops::vector_type& a, typename Ops::vector_type& b)
+		{
+			const typename Ops::vector_type minimum = Ops::min(a, b);
+			b = Ops::max(a, b);
+			a = minimum;
+		}
+
+		// Sorts the columns of kLanes registers and transposes them into rows. There is an optimal network for each
+		template<typename Ops, size_t Lanes = Ops::kLanes>
+		struct sort_network_columns;
+
+		template<typename Ops>
+		struct sort_network_columns<Ops, 2>
+		{
+			static crstl_forceinline void sort(typename Ops::vector_type* r)
+			{
+				sort_network_exchange<Ops>(r[0], r[1]);
+				Ops::transpose(r);
+			}
+		};
+
+		template<typename Ops>
+		struct sort_network_columns<Ops, 4>
+		{
+			static crstl_forceinline void sort(typename Ops::vector_type* r)
+			{
+				sort_network_exchange<Ops>(r[0], r[1]);
+				sort_network_exchange<Ops>(r[2], r[3]);
+				sort_network_exchange<Ops>(r[0], r[2]);
+				sort_network_exchange<Ops>(r[1], r[3]);
+				sort_network_exchange<Ops>(r[1], r[2]);
+				Ops::transpose(r);
+			}
+		};
+
+		// Sorts a bitonic sequence of Count registers. Each step splits it into two bitonic halves, where everything in
+		// the first half is smaller than the second
+		template<typename Ops, size_t Count>
+		struct sort_network_merge
+		{
+			static crstl_forceinline void merge(typename Ops::vector_type* r)
+			{
+				for (size_t i = 0; i < Count / 2; ++i)
+				{
+					sort_network_exchange<Ops>(r[i], r[i + Count / 2]);
+				}
+
+				sort_network_merge<Ops, Count / 2>::merge(r);
+				sort_network_merge<Ops, Count / 2>::merge(r + Count / 2);
+			}
+		};
+
+		template<typename Ops>
+		struct sort_network_merge<Ops, 1>
+		{
+			static crstl_forceinline void merge(typename Ops::vector_type* r)
+			{
+				r[0] = Ops::merge(r[0]);
+			}
+		};
+
+		// Sorts every register into a run, by columns when there are enough registers for them
+		template<typename Ops, size_t Count, bool Columns = Count >= Ops::kLanes>
+		struct sort_network_runs
+		{
+			static crstl_forceinline void sort(typename Ops::vector_type* r)
+			{
+				for (size_t i = 0; i < Count; i += Ops::kLanes)
+				{
+					sort_network_columns<Ops>::sort(r + i);
+				}
+			}
+		};
+
+		template<typename Ops, size_t Count>
+		struct sort_network_runs<Ops, Count, false>
+		{
+			static crstl_forceinline void sort(typename Ops::vector_type* r)
+			{
+				for (size_t i = 0; i < Count; ++i)
+				{
+					r[i] = Ops::sort(r[i]);
+				}
+			}
+		};
+
+		// Merges Count runs of one register into a single run
+		template<typename Ops, size_t Count>
+		struct sort_network_merge_runs
+		{
+			static crstl_forceinline void merge(typename Ops::vector_type* r)
+			{
+				const size_t half = Count / 2;
+
+				typename Ops::vector_type* second = r + half;
+
+				sort_network_merge_runs<Ops, half>::merge(r);
+				sort_network_merge_runs<Ops, half>::merge(second);
+
+				// The first run followed by the second one reversed is a bitonic sequence
+				for (size_t i = 0; i < (half + 1) / 2; ++i)
+				{
+					const typename Ops::vector_type reversed = Ops::reverse(second[i]);
+					second[i] = Ops::reverse(second[half - 1 - i]);
+					second[half - 1 - i] = reversed;
+				}
+
+				for (size_t i = 0; i < half; ++i)
+				{
+					sort_network_exchange<Ops>(r[i], second[i]);
+				}
+
+				sort_network_merge<Ops, half>::merge(r);
+				sort_network_merge<Ops, half>::merge(second);
+			}
+		};
+
+		template<typename Ops>
+		struct sort_network_merge_runs<Ops, 1>
+		{
+			static crstl_forceinline void merge(typename Ops::vector_type*) {}
+		};
+
+		// Sorts exactly N elements, for N of 8, 16, 32 or 64
+		template<size_t N, typename T>
+		void sort_network(T* data)
+		{
+			typedef sort_network_ops<T> ops;
+
+			static_assert(N >= 8 && N <= kSortNetworkMaxSize && (N & (N - 1)) == 0, "Sorting networks are 8, 16, 32 or 64 elements");
+
+			const size_t count = N / ops::kLanes;
+
+			typename ops::vector_type r[count];
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				r[i] = ops::load(data + i * ops::kLanes);
+			}
+
+			sort_network_runs<ops, count>::sort(r);
+			sort_network_merge_runs<ops, count>::merge(r);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				ops::store(data + i * ops::kLanes, r[i]);
+			}
+		}
+
+		// Sorts up to N elements with the network for N. The rest of the network is filled with the largest value,
+		// which sorts to the end
+		template<size_t N, typename T>
+		void sort_network_padded(T* begin, size_t size)
+		{
+			crstl_assert(size <= N);
+
+			if (size == N)
+			{
+				sort_network<N>(begin);
+				return;
+			}
+
+			T buffer[N];
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				buffer[i] = begin[i];
+			}
+
+			const T padding = sort_network_ops<T>::padding();
+
+			for (size_t i = size; i < N; ++i)
+			{
+				buffer[i] = padding;
+			}
+
+			sort_network<N>(buffer);
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				begin[i] = buffer[i];
+			}
+		}
+
+		// Sorts up to kSortNetworkMaxSize elements with the smallest network that fits them
+		template<typename T>
+		void sort_network(T* begin, size_t size)
+		{
+			crstl_assert(size <= kSortNetworkMaxSize);
+
+			if (size <= 8)
+			{
+				sort_network_padded<8>(begin, size);
+			}
+			else if (size <= 16)
+			{
+				sort_network_padded<16>(begin, size);
+			}
+			else if (size <= 32)
+			{
+				sort_network_padded<32>(begin, size);
+			}
+			else
+			{
+				sort_network_padded<64>(begin, size);
+			}
+		}
+	}
+};
@@ -386,17 +386,158 @@ crstl_module_export namespace crstl
 		}
 	}
 
-	// FNV-like string hash
+	// Multiply two 64-bit values into 128 bits, returning the low half in a and the high half in b
+	inline crstl_constexpr14 void string_hash_multiply(uint64_t& a, uint64_t& b)
+	{
+#if defined(__SIZEOF_INT128__)
+		__extension__ typedef unsigned __int128 uint128;
+		const uint128 result = (uint128)a * b;
+		a = (uint64_t)result;
+		b = (uint64_t)(result >> 64);
+#else
+		const uint64_t a_hi = a >> 32, a_lo = (uint32_t)a;
+		const uint64_t b_hi = b >> 32, b_lo = (uint32_t)b;
+		const uint64_t hi_hi = a_hi * b_hi, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, lo_lo = a_lo * b_lo;
+		const uint64_t middle = lo_lo + (hi_lo << 32);
+		const uint64_t low = middle + (lo_hi << 32);
+		const uint64_t carry = (uint64_t)(middle < lo_lo) + (uint64_t)(low < middle);
+		a = low;
+		b = hi_hi + (hi_lo >> 32) + (lo_hi >> 32) + carry;
+#endif
+	}
+
+	inline crstl_constexpr14 uint64_t string_hash_mix(uint64_t a, uint64_t b)
+	{
+		string_hash_multiply(a, b);
+		return a ^ b;
+	}
+
+	template<size_t Size> struct string_hash_unsigned;
+	template<> struct string_hash_unsigned<1> { typedef uint8_t type; };
+	template<> struct string_hash_unsigned<2> { typedef uint16_t type; };
+	template<> struct string_hash_unsigned<4> { typedef uint32_t type; };
+
+	// Read the characters as a little endian stream of bytes. Reading byte by byte keeps the hash usable in constant
+	// expressions and gives the same result on every platform, and compilers merge the reads into a single load
+	template<typename CharT>
+	inline crstl_constexpr14 uint64_t string_hash_read_byte(const CharT* string, size_t byte_index)
+	{
+		typedef typename string_hash_unsigned<sizeof(CharT)>::type unsigned_char_type;
+		return (uint8_t)((unsigned_char_type)string[byte_index / sizeof(CharT)] >> ((byte_index % sizeof(CharT)) * 8));
+	}
+
+	template<typename CharT>
+	inline crstl_constexpr14 uint64_t string_hash_read4_impl(const CharT* string, size_t byte_index)
+	{
+		return string_hash_read_byte(string, byte_index) |
+			(string_hash_read_byte(string, byte_index + 1) << 8) |
+			(string_hash_read_byte(string, byte_index + 2) << 16) |
+			(string_hash_read_byte(string, byte_index + 3) << 24);
+	}
+
+	template<typename CharT>
+	inline crstl_constexpr14 uint64_t string_hash_read4(const CharT* string, size_t byte_index)
+	{
+		return string_hash_read4_impl(string + byte_index / sizeof(CharT), byte_index % sizeof(CharT));
+	}
+
+	// Offset the pointer first so that the byte offsets within a read are constants, otherwise compilers don't merge them
+	template<typename CharT>
+	inline crstl_constexpr14 uint64_t string_hash_read8(const CharT* string, size_t byte_index)
+	{
+		const CharT* characters = string + byte_index / sizeof(CharT);
+		const size_t character_byte_index = byte_index % sizeof(CharT);
+		return string_hash_read4_impl(characters, character_byte_index) | (string_hash_read4_impl(characters, character_byte_index + 4) << 32);
+	}
+
+	// String hash based on wyhash (https://github.com/wangyi-fudan/wyhash). It consumes 16 bytes per step with a single
+	// wide multiply, and long strings run three independent lanes of 16 bytes to hide the multiply latency
 	template<typename CharT>
 	inline crstl_constexpr14 size_t string_hash(const CharT* string, size_t length)
 	{
-		size_t result = 2166136261U;
-		for (size_t i = 0; i < length; ++i)
+		const uint64_t secret0 = 0x2d358dccaa6c78a5ull;
+		const uint64_t secret1 = 0x8bb84b93962eacc9ull;
+		const uint64_t secret2 = 0x4b33a62ed433d4a3ull;
+		const uint64_t secret3 = 0x4d5a2da51de1aa47ull;
+
+		const size_t byte_length = length * sizeof(CharT);
+
+		uint64_t seed = 0xca813bf4c7abf0a9ull; // string_hash_mix(secret0, secret1)
+		uint64_t a = 0;
+		uint64_t b = 0;
+
+		if (byte_length <= 16)
 		{
-			size_t c = string[i];
-			result = (result * 16777619) ^ c;
+			if (byte_length >= 4)
+			{
+				// Two overlapping reads from each end cover every byte for lengths 4 to 16
+				const size_t offset = (byte_length >> 3) << 2;
+				a = (string_hash_read4(string, 0) << 32) | string_hash_read4(string, offset);
+				b = (string_hash_read4(string, byte_length - 4) << 32) | string_hash_read4(string, byte_length - 4 - offset);
+			}
+			else if (byte_length > 0)
+			{
+				a = (string_hash_read_byte(string, 0) << 16) | (string_hash_read_byte(string, byte_length >> 1) << 8) | string_hash_read_byte(string, byte_length - 1);
+			}
 		}
+		else
+		{
+			size_t byte_index = 0;
+			size_t remaining = byte_length;
 
-		return result;
+			if (remaining > 48)
+			{
+				uint64_t seed1 = seed;
+				uint64_t seed2 = seed;
+
+				do
+				{
+					seed = string_hash_mix(string_hash_read8(string, byte_index) ^ secret1, string_hash_read8(string, byte_index + 8) ^ seed);
+					seed1 = string_hash_mix(string_hash_read8(string, byte_index + 16) ^ secret2, string_hash_read8(string, byte_index + 24) ^ seed1);
+					seed2 = string_hash_mix(string_hash_read8(string, byte_index + 32) ^ secret3, string_hash_read8(string, byte_index + 40) ^ seed2);
+					byte_index += 48;
+					remaining -= 48;
+				} while (remaining > 48);
+
+				seed ^= seed1 ^ seed2;
+			}
+
+			while (remaining > 16)
+			{
+				seed = string_hash_mix(string_hash_read8(string, byte_index) ^ secret1, string_hash_read8(string, byte_index + 8) ^ seed);
+				byte_index += 16;
+				remaining -= 16;
+			}
+
+			// The last 16 bytes, which may overlap with bytes we already consumed
+			a = string_hash_read8(string, byte_index + remaining - 16);
+			b = string_hash_read8(string, byte_index + remaining - 8);
+		}
+
+		a ^= secret1;
+		b ^= seed;
+		string_hash_multiply(a, b);
+
+		return (size_t)string_hash_mix(a ^ secret0 ^ byte_length, b ^ secret1);
 	}
+
+	// Hashes any string type through its characters, so that basic_string, basic_fixed_string, basic_string_view and
+	// const CharT* all produce the same hash for the same contents. is_transparent lets hashmaps use it for lookups
+	// with a different type than the key, without constructing a temporary key
+	template<typename CharT>
+	struct transparent_string_hash
+	{
+		typedef void is_transparent;
+
+		crstl_constexpr14 size_t operator()(const CharT* string) const
+		{
+			return string_hash(string, string_length(string));
+		}
+
+		template<typename StringType>
+		crstl_constexpr14 size_t operator()(const StringType& string) const
+		{
+			return string_hash(string.data(), string.length());
+		}
+	};
 };
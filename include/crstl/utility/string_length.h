@@ -25,9 +25,16 @@ extern "C"
 #endif
 }
 
+#if defined(CRSTL_BUILTIN_STRLEN)
+	#define crstl_string_length_constexpr crstl_constexpr14
+#else
+	#define crstl_string_length_constexpr
+#endif
+
 crstl_module_export namespace crstl
 {
-	inline size_t string_length(const char* str)
+	// Can be used in constant expressions where strlen is a builtin
+	inline crstl_string_length_constexpr size_t string_length(const char* str)
 	{
 #if defined(CRSTL_BUILTIN_STRLEN)
 		return __builtin_strlen(str);
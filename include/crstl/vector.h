@@ -72,11 +72,14 @@ crstl_module_export namespace crstl
 
 			T* temp = (T*)m_capacity_allocator.second().allocate(new_capacity * kDataSize);
 
-			// Copy existing data
-			copy_initialize_or_memcpy(temp, m_data, m_length);
+			// Copy existing data. An empty vector may not have any data, and memcpy doesn't accept null even for 0 bytes
+			if (m_length > 0)
+			{
+				copy_initialize_or_memcpy(temp, m_data, m_length);
 
-			// Destroy existing data
-			destruct_or_ignore(m_data, m_length);
+				// Destroy existing data
+				destruct_or_ignore(m_data, m_length);
+			}
 
 			m_capacity_allocator.second().deallocate(m_data, m_capacity_allocator.m_first * kDataSize);
 			m_data = temp;
@@ -5,26 +5,39 @@ export module crstl;
 #include "crstl/array.h"
 #include "crstl/bit.h"
 #include "crstl/bitset.h"
+#include "crstl/concurrent_open_hashmap.h"
+#include "crstl/constexpr_hashmap.h"
 #include "crstl/critical_section.h"
 #include "crstl/debugging.h"
 #include "crstl/deque.h"
 #include "crstl/filesystem.h"
 #include "crstl/fixed_deque.h"
 #include "crstl/fixed_function.h"
+#include "crstl/fixed_open_group_hashmap.h"
 #include "crstl/fixed_open_hashmap.h"
+#include "crstl/fixed_open_robin_hashmap.h"
 #include "crstl/fixed_path.h"
 #include "crstl/fixed_string.h"
 #include "crstl/fixed_vector.h"
 #include "crstl/function.h"
 #include "crstl/hash.h"
 #include "crstl/intrusive_ptr.h"
+#include "crstl/lru_cache.h"
+#include "crstl/open_dense_hashmap.h"
+#include "crstl/open_group_hashmap.h"
 #include "crstl/open_hashmap.h"
+#include "crstl/open_incremental_hashmap.h"
+#include "crstl/open_robin_hashmap.h"
 #include "crstl/pair.h"
+#include "crstl/parallel_sort.h"
 #include "crstl/path.h"
 #include "crstl/process.h"
+#include "crstl/snapshot_hashmap.h"
+#include "crstl/sort.h"
 #include "crstl/span.h"
 #include "crstl/stack_vector.h"
 #include "crstl/string.h"
+#include "crstl/string_sort.h"
 #include "crstl/string_view.h"
 #include "crstl/thread.h"
 #include "crstl/timer.h"
@@ -143,10 +143,12 @@ void RunUnitTestsBitset();
 void RunUnitTestsDeque();
 void RunUnitTestsFilesystem();
 void RunUnitTestsFunction();
+void RunUnitTestsHashmapStats();
 void RunUnitTestsPair();
 void RunUnitTestsPath();
 void RunUnitTestsProcess();
 void RunUnitTestsSmartPtr();
+void RunUnitTestsSort();
 void RunUnitTestsString();
 void RunUnitTestsThread();
 void RunUnitTestsTimer();
@@ -175,10 +177,12 @@ extern "C"
 	RunUnitTestsDeque();
 	RunUnitTestsFilesystem();
 	RunUnitTestsFunction();
+	RunUnitTestsHashmapStats();
 	RunUnitTestsPair();
 	RunUnitTestsPath();
 	RunUnitTestsProcess();
 	RunUnitTestsSmartPtr();
+	RunUnitTestsSort();
 	RunUnitTestsString();
 	RunUnitTestsThread();
 	RunUnitTestsTimer();
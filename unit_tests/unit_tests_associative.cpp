@@ -3,16 +3,32 @@
 #if defined(CRSTL_UNIT_MODULES)
 import crstl;
 #else
+#include "crstl/concurrent_open_hashmap.h"
+#include "crstl/constexpr_hashmap.h"
+#include "crstl/fixed_open_group_hashmap.h"
 #include "crstl/fixed_open_hashmap.h"
+#include "crstl/fixed_open_robin_hashmap.h"
+#include "crstl/lru_cache.h"
+#include "crstl/open_dense_hashmap.h"
+#include "crstl/open_group_hashmap.h"
 #include "crstl/open_hashmap.h"
+#include "crstl/open_incremental_hashmap.h"
+#include "crstl/open_robin_hashmap.h"
+#include "crstl/snapshot_hashmap.h"
+#include "crstl/fixed_string.h"
+#include "crstl/string.h"
+#include "crstl/string_view.h"
 #include "crstl/timer.h"
 #include "crstl/type_array.h"
+#include "crstl/unique_ptr.h"
+#include "crstl/vector.h"
 #endif
 
 #include <functional>
 #include <unordered_map>
 #include <string>
 #include <stdio.h>
+#include <string.h>
 
 namespace crstl
 {
@@ -24,6 +40,10 @@ int ManualKeys[] = { 16, 48, 80, 76, 86, 96, 106, 116, 126, 136, 146, 156, 166,
 
 // Explicit instantiation to help catch errors
 template class crstl::fixed_open_hashmap<int, int, 64>;
+template class crstl::fixed_open_group_hashmap<int, int, 64>;
+template class crstl::fixed_open_robin_hashmap<int, int, 64>;
+template class crstl::constexpr_hashmap<int, int, 64>;
+template class crstl::open_dense_hashmap<int, int>;
 
 template<typename Hashmap>
 void RunUnitTestHashmapT()
@@ -332,6 +352,1254 @@ void RunUnitTestHashsetT()
 	crstl_check(crHashsetInitializerList.size() == 6);
 }
 
+// Run a long sequence of random inserts, erases and finds and compare against std::unordered_map. This
+// exercises probe sequences that wrap around, erased slots being reused and rehashing
+template<typename Hashmap>
+void RunUnitTestHashmapRandomT(size_t key_range, size_t operation_count)
+{
+	using namespace crstl_unit;
+
+	Hashmap crHashmap;
+	std::unordered_map<int, int> stdHashmap;
+
+	unsigned int seed = 12345;
+
+	for (size_t i = 0; i < operation_count; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		int key = (int)((seed >> 8) % key_range);
+		unsigned int operation = (seed >> 4) & 3;
+
+		if (operation <= 1)
+		{
+			bool crInserted = crHashmap.insert(key, (int)i).second;
+			bool stdInserted = stdHashmap.insert({ key, (int)i }).second;
+			crstl_check(crInserted == stdInserted);
+		}
+		else if (operation == 2)
+		{
+			crstl_check(crHashmap.erase(key) == stdHashmap.erase(key));
+		}
+		else
+		{
+			auto crIter = crHashmap.find(key);
+			auto stdIter = stdHashmap.find(key);
+			crstl_check((crIter == crHashmap.end()) == (stdIter == stdHashmap.end()));
+			crstl_check(crIter == crHashmap.end() || crIter->second == stdIter->second);
+		}
+
+		crstl_check(crHashmap.size() == stdHashmap.size());
+	}
+
+	size_t iterCount = 0;
+	for (const auto& iter : crHashmap)
+	{
+		crstl_check(stdHashmap.find(iter.first)->second == iter.second);
+		iterCount++;
+	}
+
+	crstl_check(iterCount == stdHashmap.size());
+}
+
+// Only produces a handful of hash values, so that keys form long clusters
+struct CollidingHash
+{
+	size_t operator()(int key) const { return (size_t)(key % 4); }
+};
+
+struct ConstantHash
+{
+	size_t operator()(int) const { return 42; }
+};
+
+// Check that lookups terminate correctly in long clusters and that backward shift deletion keeps every key reachable
+void RunUnitTestRobinHashmap()
+{
+	using namespace crstl_unit;
+
+	crstl::open_robin_hashmap<int, int, CollidingHash> crHashmap;
+
+	for (int i = 0; i < 150; ++i)
+	{
+		crHashmap.insert(i * 64, i);
+	}
+
+	crstl_check(crHashmap.size() == 150);
+	crstl_check(crHashmap.max_probe_length() >= 1);
+	crstl_check(crHashmap.max_probe_length() <= 150);
+
+	for (int i = 0; i < 150; ++i)
+	{
+		crstl_check(crHashmap.find(i * 64) != crHashmap.end());
+		crstl_check(crHashmap.find(i * 64 + 1) == crHashmap.end());
+	}
+
+	// Erase every other key while iterating
+	for (auto iter = crHashmap.begin(); iter != crHashmap.end();)
+	{
+		if ((iter->second & 1) == 0)
+		{
+			iter = crHashmap.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	crstl_check(crHashmap.size() == 75);
+
+	for (int i = 0; i < 150; ++i)
+	{
+		crstl_check(crHashmap.count(i * 64) == (size_t)(i & 1));
+	}
+
+	crstl::open_robin_multi_hashmap<int, int> crMultiHashmap;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		crMultiHashmap.insert(i % 10, i);
+	}
+
+	crstl_check(crMultiHashmap.count(3) == 10);
+	crstl_check(crMultiHashmap.count(10) == 0);
+
+	size_t foundCount = 0;
+	crMultiHashmap.for_each(7, [&foundCount](int value) { crstl_check(value % 10 == 7); foundCount++; });
+	crstl_check(foundCount == 10);
+
+	// Fill a fixed hashmap completely
+	crstl::fixed_open_robin_hashmap<int, int, 32> crFixedHashmap;
+
+	for (int i = 0; i < 32; ++i)
+	{
+		crFixedHashmap.insert(i * 3, i);
+	}
+
+	crstl_check(crFixedHashmap.size() == 32);
+	crstl_check(crFixedHashmap.insert(9, 0).second == false);
+	crstl_check(crFixedHashmap.find(1) == crFixedHashmap.end());
+	crstl_check(crFixedHashmap.erase(9) == 1);
+	crstl_check(crFixedHashmap.find(12) != crFixedHashmap.end());
+
+	// Probes longer than a byte can store. Growing doesn't shorten them, so the table must not grow because of them
+	crstl::open_robin_multi_hashmap<int, int> crSameKeyHashmap;
+
+	for (int i = 0; i < 300; ++i)
+	{
+		crSameKeyHashmap.insert(7, i);
+	}
+
+	crSameKeyHashmap.insert(8, 0);
+
+	crstl_check(crSameKeyHashmap.size() == 301);
+	crstl_check(crSameKeyHashmap.count(7) == 300);
+	crstl_check(crSameKeyHashmap.count(8) == 1);
+	crstl_check(crSameKeyHashmap.max_probe_length() >= 300);
+
+	crstl::open_robin_hashmap<int, int, ConstantHash> crConstantHashmap;
+
+	for (int i = 0; i < 600; ++i)
+	{
+		crConstantHashmap.insert(i, i);
+	}
+
+	crstl_check(crConstantHashmap.size() == 600);
+
+	for (int i = 0; i < 600; i += 2)
+	{
+		crstl_check(crConstantHashmap.erase(i) == 1);
+	}
+
+	bool foundAll = crConstantHashmap.size() == 300;
+
+	for (int i = 0; i < 600; ++i)
+	{
+		foundAll &= (crConstantHashmap.find(i) != crConstantHashmap.end()) == ((i & 1) == 1);
+	}
+
+	crstl_check(foundAll);
+
+	crstl::fixed_open_robin_hashmap<int, int, 300, ConstantHash> crFixedConstantHashmap;
+
+	for (int i = 0; i < 300; ++i)
+	{
+		crFixedConstantHashmap.insert(i, i);
+	}
+
+	crstl_check(crFixedConstantHashmap.size() == 300);
+	crstl_check(crFixedConstantHashmap.find(299)->second == 299);
+	crstl_check(crFixedConstantHashmap.erase(0) == 1);
+	crstl_check(crFixedConstantHashmap.find(299)->second == 299);
+}
+
+// Keys that only differ in their high bits used to share the low bits the bucket was taken from, and ended up in a
+// single cluster with the identity hash
+void RunUnitTestHashmapHighBitKeys()
+{
+	using namespace crstl_unit;
+
+	crstl::open_robin_hashmap<uint64_t, int> crHashmap;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		crHashmap.insert((uint64_t)i << 32, i);
+	}
+
+	crstl_check(crHashmap.max_probe_length() <= 16);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		crstl_check(crHashmap.find((uint64_t)i << 32)->second == i);
+	}
+}
+
+// Stands in for crstl::file when saving hashtables
+struct MemoryFile
+{
+	MemoryFile(char* data, size_t capacity) : data(data), capacity(capacity), size(0) {}
+
+	size_t write(const void* source, size_t bytes)
+	{
+		size_t written = bytes < capacity - size ? bytes : capacity - size;
+		memcpy(data + size, source, written);
+		size += written;
+		return written;
+	}
+
+	char* data;
+
+	size_t capacity;
+
+	size_t size;
+};
+
+void RunUnitTestFixedHashmapSave()
+{
+	using namespace crstl_unit;
+
+	typedef crstl::fixed_open_hashmap<uint32_t, uint64_t, 256> FixedHashmap;
+	typedef crstl::fixed_open_hashset<uint32_t, 256> FixedHashset;
+
+	crstl_alignas(64) char buffer[FixedHashmap::saved_size() + 64];
+
+	FixedHashmap crHashmap;
+
+	for (uint32_t i = 0; i < 200; ++i)
+	{
+		crHashmap.insert(i * 7919, (uint64_t)i << 32);
+	}
+
+	// Erasing shifts parts of the clusters back, so the view sees the table as it is after backward shift deletion
+	for (uint32_t i = 0; i < 200; i += 5)
+	{
+		crHashmap.erase(i * 7919);
+	}
+
+	MemoryFile memoryFile(buffer, sizeof(buffer));
+	crstl_check(crHashmap.save(memoryFile));
+	crstl_check(memoryFile.size == FixedHashmap::saved_size());
+
+	// Padding and empty nodes are saved as zeros, so the same table in memory that held different bytes saves the same
+	{
+		crstl_alignas(64) char dirtyMemory[sizeof(FixedHashmap)];
+		memset(dirtyMemory, 0xcd, sizeof(dirtyMemory));
+		FixedHashmap* crDirtyHashmap = crstl_placement_new(dirtyMemory) FixedHashmap();
+
+		for (uint32_t i = 0; i < 200; ++i)
+		{
+			crDirtyHashmap->insert(i * 7919, (uint64_t)i << 32);
+		}
+
+		for (uint32_t i = 0; i < 200; i += 5)
+		{
+			crDirtyHashmap->erase(i * 7919);
+		}
+
+		crstl_alignas(64) char dirtyBuffer[FixedHashmap::saved_size()];
+		MemoryFile dirtyFile(dirtyBuffer, sizeof(dirtyBuffer));
+		crstl_check(crDirtyHashmap->save(dirtyFile));
+		crstl_check(memcmp(buffer, dirtyBuffer, sizeof(dirtyBuffer)) == 0);
+
+		crDirtyHashmap->~FixedHashmap();
+	}
+
+	const FixedHashmap::fixed_open_hashtable* crView = FixedHashmap::view_from_memory(buffer, memoryFile.size);
+	crstl_check(crView != nullptr);
+	crstl_check(crView->size() == crHashmap.size());
+
+	for (uint32_t i = 0; i < 200; ++i)
+	{
+		if (i % 5 == 0)
+		{
+			crstl_check(crView->find(i * 7919) == crView->end());
+		}
+		else
+		{
+			crstl_check(crView->find(i * 7919)->second == (uint64_t)i << 32);
+		}
+	}
+
+	size_t iteratedCount = 0;
+
+	for (const crstl::pair<uint32_t, uint64_t>& iter : *crView)
+	{
+		crstl_check(crHashmap.find(iter.first)->second == iter.second);
+		++iteratedCount;
+	}
+
+	crstl_check(iteratedCount == crHashmap.size());
+
+	// Memory that doesn't hold a table of the same type is rejected
+	crstl_check(FixedHashmap::view_from_memory(buffer, memoryFile.size - 1) == nullptr);
+	crstl_check(FixedHashmap::view_from_memory(buffer + 8, memoryFile.size) == nullptr);
+	crstl_check((crstl::fixed_open_hashmap<uint32_t, uint64_t, 128>::view_from_memory(buffer, memoryFile.size) == nullptr));
+	crstl_check((crstl::fixed_open_hashmap<uint32_t, uint32_t, 256>::view_from_memory(buffer, memoryFile.size) == nullptr));
+
+	buffer[0] ^= 1;
+	crstl_check(FixedHashmap::view_from_memory(buffer, memoryFile.size) == nullptr);
+
+	// A buffer that is too small fails the save
+	MemoryFile smallFile(buffer, 100);
+	crstl_check(!crHashmap.save(smallFile));
+
+	FixedHashset crHashset;
+	crHashset.insert(3);
+	crHashset.insert(259);
+
+	MemoryFile setFile(buffer, sizeof(buffer));
+	crstl_check(crHashset.save(setFile));
+
+	const FixedHashset::fixed_open_hashtable* crSetView = FixedHashset::view_from_memory(buffer, setFile.size);
+	crstl_check(crSetView != nullptr);
+	crstl_check(crSetView->count(3u) == 1);
+	crstl_check(crSetView->count(259u) == 1);
+	crstl_check(crSetView->count(4u) == 0);
+}
+
+void RunUnitTestConstexprHashmap()
+{
+	using namespace crstl_unit;
+
+	typedef crstl::constexpr_hashmap<crstl::string_view, int, 8> KeywordHashmap;
+
+	static crstl_constexpr14 KeywordHashmap Keywords =
+	{
+		{ "if", 1 }, { "else", 2 }, { "while", 3 }, { "for", 4 }, { "return", 5 }, { "break", 6 }, { "continue", 7 }, { "switch", 8 }
+	};
+
+#if CRSTL_CPPVERSION >= CRSTL_CPP14
+	static_assert(Keywords.size() == 8, "Table must be built at compile time");
+	static_assert(Keywords.count("while") == 1, "Table must be built at compile time");
+	static_assert(Keywords.count("goto") == 0, "Table must be built at compile time");
+#endif
+
+	crstl_check(Keywords.size() == 8);
+	crstl_check(Keywords.find("if")->second == 1);
+	crstl_check(Keywords.find(crstl::string_view("continue"))->second == 7);
+	crstl_check(Keywords.find("goto") == Keywords.end());
+	crstl_check(Keywords.count("els") == 0);
+
+	// Large enough that most buckets need a displacement, with no spare nodes
+	const int KeyCount = 1000;
+	crstl::vector<crstl::pair<int, int>> keyValues;
+
+	for (int i = 0; i < KeyCount; ++i)
+	{
+		keyValues.push_back(crstl::pair<int, int>(i * 3, i));
+	}
+
+	crstl::constexpr_hashmap<int, int, KeyCount> crHashmap(keyValues.data(), keyValues.size());
+	crstl_check(crHashmap.size() == (size_t)KeyCount);
+
+	for (int i = 0; i < KeyCount; ++i)
+	{
+		crstl_check(crHashmap.find(i * 3)->second == i);
+		crstl_check(crHashmap.count(i * 3 + 1) == 0);
+	}
+
+	size_t iteratedCount = 0;
+
+	for (const crstl::pair<int, int>& iter : crHashmap)
+	{
+		crstl_check(iter.first == iter.second * 3);
+		++iteratedCount;
+	}
+
+	crstl_check(iteratedCount == (size_t)KeyCount);
+
+	// Repeated keys keep the first value and spare nodes stay empty
+	crstl::constexpr_hashmap<int, int, 8> crRepeatedHashmap = { { 1, 10 }, { 2, 20 }, { 1, 30 } };
+	crstl_check(crRepeatedHashmap.size() == 2);
+	crstl_check(crRepeatedHashmap.find(1)->second == 10);
+	crstl_check(crRepeatedHashmap.find(2)->second == 20);
+	crstl_check(crRepeatedHashmap.count(0) == 0);
+
+	crstl::constexpr_hashmap<int, int, 4> crEmptyHashmap(nullptr, 0);
+	crstl_check(crEmptyHashmap.empty());
+	crstl_check(crEmptyHashmap.begin() == crEmptyHashmap.end());
+	crstl_check(crEmptyHashmap.find(0) == crEmptyHashmap.end());
+}
+
+// Keys form long clusters so that erasing has to shift slots back, and moving the last pair has to find its slot
+void RunUnitTestDenseHashmap()
+{
+	using namespace crstl_unit;
+
+	crstl::open_dense_hashmap<int, int, CollidingHash> crHashmap;
+
+	for (int i = 0; i < 150; ++i)
+	{
+		crHashmap.insert(i * 64, i);
+	}
+
+	crstl_check(crHashmap.size() == 150);
+	crstl_check(crHashmap.insert(0, 1000).second == false);
+
+	// Pairs are packed in insertion order
+	for (int i = 0; i < 150; ++i)
+	{
+		crstl_check(crHashmap.data()[i].first == i * 64);
+		crstl_check(crHashmap.find(i * 64)->second == i);
+		crstl_check(crHashmap.find(i * 64 + 1) == crHashmap.end());
+	}
+
+	// Erase every other key while iterating. The erased position receives the last pair, which we then check
+	for (auto iter = crHashmap.begin(); iter != crHashmap.end();)
+	{
+		if ((iter->second & 1) == 0)
+		{
+			iter = crHashmap.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+
+	crstl_check(crHashmap.size() == 75);
+
+	for (int i = 0; i < 150; ++i)
+	{
+		crstl_check(crHashmap.count(i * 64) == (size_t)(i & 1));
+	}
+
+	crstl::open_dense_hashmap<int, int, CollidingHash> crHashmapCopy(crHashmap);
+	crstl_check(crHashmapCopy.size() == 75);
+	crstl_check(crHashmapCopy.find(64)->second == 1);
+
+	crstl::open_dense_hashmap<int, int, CollidingHash> crHashmapMoved(crstl_move(crHashmapCopy));
+	crstl_check(crHashmapCopy.empty());
+	crstl_check(crHashmapMoved.find(64 * 149)->second == 149);
+	crstl_check(crHashmapCopy.find(64) == crHashmapCopy.end());
+
+	crstl_check(crHashmap.insert_or_assign(64, 7).second);
+	crstl_check(crHashmap.find(64)->second == 7);
+	crstl_check(crHashmap.erase(64) == 1);
+	crstl_check(crHashmap.erase(64) == 0);
+
+	const size_t bucketCount = crHashmap.bucket_count();
+	crHashmap.clear();
+	crstl_check(crHashmap.empty());
+	crstl_check(crHashmap.bucket_count() == bucketCount);
+	crstl_check(crHashmap.find(64 * 3) == crHashmap.end());
+
+	// Large values only live in the vector, and lookups go through a transparent hash
+	crstl::open_dense_hashmap<crstl::string, crstl::fixed_string64> crStringHashmap = { { "one", "1" }, { "two", "2" } };
+	crstl_check(crStringHashmap.find("one")->second == "1");
+	crstl_check(crStringHashmap.find(crstl::string_view("two"))->second == "2");
+	crstl_check(crStringHashmap.count("three") == 0);
+
+	crStringHashmap.emplace("three", "3");
+	crstl_check(crStringHashmap.find("three")->second == "3");
+}
+
+template<typename Hashmap>
+void RunUnitTestHashmapEraseIfT(size_t key_count)
+{
+	using namespace crstl_unit;
+
+	Hashmap crHashmap;
+	std::unordered_map<int, int> stdHashmap;
+
+	unsigned int seed = 54321;
+
+	for (size_t i = 0; i < key_count; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		int key = (int)(seed >> 8);
+		crHashmap.insert(key, (int)i);
+		stdHashmap.insert({ key, (int)i });
+	}
+
+	crstl_check(crHashmap.erase_if([](const crstl::pair<int, int>&) { return false; }) == 0);
+	crstl_check(crHashmap.size() == stdHashmap.size());
+
+	size_t stdErased = 0;
+	for (auto iter = stdHashmap.begin(); iter != stdHashmap.end();)
+	{
+		if (iter->second % 3 == 0) { iter = stdHashmap.erase(iter); stdErased++; } else { ++iter; }
+	}
+
+	crstl_check(crHashmap.erase_if([](const crstl::pair<int, int>& kv) { return kv.second % 3 == 0; }) == stdErased);
+
+	stdErased = 0;
+	for (auto iter = stdHashmap.begin(); iter != stdHashmap.end();)
+	{
+		if (iter->second % 4 != 1) { iter = stdHashmap.erase(iter); stdErased++; } else { ++iter; }
+	}
+
+	crstl_check(crHashmap.retain([](const crstl::pair<int, int>& kv) { return kv.second % 4 == 1; }) == stdErased);
+	crstl_check(crHashmap.size() == stdHashmap.size());
+
+	for (const auto& iter : stdHashmap)
+	{
+		crstl_check(crHashmap.find(iter.first) != crHashmap.end() && crHashmap.find(iter.first)->second == iter.second);
+	}
+
+	size_t iterCount = 0;
+	for (const auto& iter : crHashmap)
+	{
+		crstl_check(stdHashmap.find(iter.first)->second == iter.second);
+		iterCount++;
+	}
+
+	crstl_check(iterCount == stdHashmap.size());
+
+	crstl_check(crHashmap.erase_if([](const crstl::pair<int, int>&) { return true; }) == stdHashmap.size());
+	crstl_check(crHashmap.empty());
+}
+
+// Long clusters, sets, multimaps and a table with no empty node left
+void RunUnitTestHashmapEraseIf()
+{
+	using namespace crstl_unit;
+
+	crstl::open_hashmap<int, int, CollidingHash> crHashmap;
+
+	for (int i = 0; i < 200; ++i)
+	{
+		crHashmap.insert(i, i);
+	}
+
+	crstl_check(crHashmap.erase_if([](const crstl::pair<int, int>& kv) { return kv.first % 3 == 0 || kv.first % 4 == 1; }) == 101);
+	crstl_check(crHashmap.size() == 99);
+
+	for (int i = 0; i < 200; ++i)
+	{
+		crstl_check(crHashmap.count(i) == ((i % 3 == 0 || i % 4 == 1) ? 0u : 1u));
+	}
+
+	crstl::open_hashset<int> crHashset;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		crHashset.insert(i);
+	}
+
+	crstl_check(crHashset.retain([](int key) { return key < 10; }) == 90);
+	crstl_check(crHashset.size() == 10 && crHashset.count(9) == 1 && crHashset.count(10) == 0);
+
+	crstl::open_multi_hashmap<int, int, CollidingHash> crMultiHashmap;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		crMultiHashmap.insert(i % 10, i);
+	}
+
+	crstl_check(crMultiHashmap.erase_if([](const crstl::pair<int, int>& kv) { return kv.second >= 50; }) == 50);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		crstl_check(crMultiHashmap.count(i) == 5);
+	}
+
+	crstl::fixed_open_hashmap<int, int, 16> crFixedHashmap;
+
+	for (int i = 0; i < 16; ++i)
+	{
+		crFixedHashmap.insert(i * 5, i);
+	}
+
+	crstl_check(crFixedHashmap.size() == 16);
+	crstl_check(crFixedHashmap.retain([](const crstl::pair<int, int>& kv) { return kv.second != 7; }) == 1);
+	crstl_check(crFixedHashmap.size() == 15 && crFixedHashmap.count(35) == 0);
+
+	for (int i = 0; i < 16; ++i)
+	{
+		crFixedHashmap.insert(i * 5, i);
+	}
+
+	crstl_check(crFixedHashmap.erase_if([](const crstl::pair<int, int>& kv) { return kv.second % 2 == 0; }) == 8);
+
+	for (int i = 0; i < 16; ++i)
+	{
+		crstl_check(crFixedHashmap.count(i * 5) == (size_t)(i % 2));
+	}
+
+	// The predicate sees every node of a full table exactly once, and displaced nodes stay reachable
+	crstl::fixed_open_hashmap<int, int, 16, CollidingHash> crFullHashmap;
+
+	for (int erasedKey = 0; erasedKey < 16; ++erasedKey)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			crFullHashmap.insert(i, i);
+		}
+
+		crstl_check(crFullHashmap.size() == 16);
+
+		size_t predicateCalls = 0;
+		crstl_check(crFullHashmap.erase_if([&](const crstl::pair<int, int>& kv) { predicateCalls++; return kv.first == erasedKey || kv.first % 5 == 4; }) == (erasedKey % 5 == 4 ? 3u : 4u));
+		crstl_check(predicateCalls == 16);
+
+		for (int i = 0; i < 16; ++i)
+		{
+			crstl_check(crFullHashmap.count(i) == ((i == erasedKey || i % 5 == 4) ? 0u : 1u));
+		}
+
+		crFullHashmap.clear();
+	}
+}
+
+// Enough keys for several regions per thread, with repeated keys and keys that exist already
+void RunUnitTestHashmapBuildParallel()
+{
+	using namespace crstl_unit;
+
+	const int kKeyCount = 200000;
+	crstl::vector<crstl::pair<int, int>> keyValues;
+	std::unordered_map<int, int> stdHashmap;
+
+	crstl::open_hashmap<int, int> crHashmap;
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		crHashmap.insert(i * 3, -1);
+		stdHashmap.insert({ i * 3, -1 });
+	}
+
+	unsigned int seed = 999;
+
+	for (int i = 0; i < kKeyCount; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		int key = (int)((seed >> 8) % (kKeyCount * 2));
+		keyValues.push_back(crstl::pair<int, int>(key, i));
+		stdHashmap.insert({ key, i });
+	}
+
+	crHashmap.build_parallel(keyValues.data(), keyValues.size(), 4);
+	crstl_check(crHashmap.size() == stdHashmap.size());
+	crstl_check(crHashmap.load_factor() <= crHashmap.max_load_factor());
+
+	for (const auto& iter : stdHashmap)
+	{
+		auto crIter = crHashmap.find(iter.first);
+		crstl_check(crIter != crHashmap.end() && crIter->second == iter.second);
+	}
+
+	// Grow and shrink back, then keep inserting as usual
+	size_t bucketCount = crHashmap.bucket_count();
+	crHashmap.rehash_parallel(bucketCount * 4, 4);
+	crstl_check(crHashmap.bucket_count() == bucketCount * 4);
+	crHashmap.rehash_parallel(0, 3);
+	crstl_check(crHashmap.bucket_count() <= bucketCount);
+	crstl_check(crHashmap.size() == stdHashmap.size());
+
+	crHashmap.insert(-5, 5);
+	crstl_check(crHashmap.find(-5)->second == 5);
+	crstl_check(crHashmap.erase(-5) == 1);
+
+	size_t iterCount = 0;
+	for (const auto& iter : crHashmap)
+	{
+		crstl_check(stdHashmap.find(iter.first)->second == iter.second);
+		iterCount++;
+	}
+
+	crstl_check(iterCount == stdHashmap.size());
+
+	// Keys with destructors, and the single thread fallback
+	crstl::vector<crstl::pair<crstl::string, int>> stringKeyValues;
+
+	for (int i = 0; i < 50000; ++i)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "key_%d", i);
+		stringKeyValues.push_back(crstl::pair<crstl::string, int>(crstl::string(buffer), i));
+	}
+
+	crstl::open_hashmap<crstl::string, int> crStringHashmap;
+	crStringHashmap.build_parallel(stringKeyValues.data(), stringKeyValues.size(), 2);
+	crstl_check(crStringHashmap.size() == 50000);
+	crStringHashmap.rehash_parallel(crStringHashmap.bucket_count() * 2, 2);
+	crstl_check(crStringHashmap.find(crstl::string("key_4321"))->second == 4321);
+
+	crstl::open_hashmap<crstl::string, int> crSerialHashmap;
+	crSerialHashmap.build_parallel(stringKeyValues.data(), 100, 8);
+	crstl_check(crSerialHashmap.size() == 100 && crSerialHashmap.count(crstl::string("key_99")) == 1);
+
+	// Multimaps keep every value
+	crstl::open_multi_hashmap<int, int> crMultiHashmap;
+	crMultiHashmap.build_parallel(keyValues.data(), keyValues.size(), 4);
+	crstl_check(crMultiHashmap.size() == keyValues.size());
+}
+
+// Takes the cache by reference as the fixed and heap caches are constructed differently. Capacity must be 4
+template<typename Cache>
+void RunUnitTestLruCacheT(Cache& crCache)
+{
+	using namespace crstl_unit;
+
+	crstl::vector<int> evictedKeys;
+	crCache.set_evict_function([&evictedKeys](typename Cache::key_value_type& keyValue) { evictedKeys.push_back(keyValue.first); });
+
+	crstl_check(crCache.capacity() == 4);
+	crstl_check(crCache.empty());
+	crstl_check(crCache.get(1) == nullptr);
+	crstl_check(!crCache.evict());
+
+	for (int i = 0; i < 4; ++i)
+	{
+		crCache.put(i, crstl::string("value") + crstl::string(1, (char)('0' + i)));
+	}
+
+	crstl_check(crCache.size() == 4);
+	crstl_check(evictedKeys.empty());
+
+	// 0 becomes the most recently used, so 1 is evicted first
+	crstl_check(*crCache.get(0) == "value0");
+	crCache.put(4, "value4");
+	crstl_check(evictedKeys.size() == 1 && evictedKeys[0] == 1);
+	crstl_check(crCache.count(1) == 0 && crCache.size() == 4);
+
+	// Peeking doesn't change the order, and assigning marks the key as used
+	crstl_check(*crCache.peek(2) == "value2");
+	crCache.put(3, "value3b");
+	crCache.put(5, "value5");
+	crstl_check(evictedKeys.size() == 2 && evictedKeys[1] == 2);
+	crstl_check(*crCache.peek(3) == "value3b");
+
+	int order[4] = {};
+	int orderCount = 0;
+	crCache.for_each([&](const typename Cache::key_value_type& keyValue) { order[orderCount++] = keyValue.first; });
+	crstl_check(orderCount == 4 && order[0] == 5 && order[1] == 3 && order[2] == 4 && order[3] == 0);
+
+	// Erasing frees an entry without calling the evict function
+	crstl_check(crCache.erase(4) == 1);
+	crstl_check(crCache.erase(4) == 0);
+	crCache.put(6, "value6");
+	crstl_check(evictedKeys.size() == 2 && crCache.size() == 4);
+
+	crstl_check(crCache.evict());
+	crstl_check(evictedKeys.size() == 3 && evictedKeys[2] == 0);
+
+	// Cycling through more keys than fit misses every time, and every put but the first evicts
+	for (int i = 0; i < 100; ++i)
+	{
+		crCache.put(i % 7, crstl::string("value"));
+	}
+
+	crstl_check(crCache.size() == 4 && evictedKeys.size() == 3 + 99);
+
+	crCache.clear();
+	crstl_check(crCache.empty() && crCache.get(6) == nullptr);
+	crCache.put(1, "value1");
+	crstl_check(crCache.size() == 1 && *crCache.get(1) == "value1");
+}
+
+void RunUnitTestHashmapLoadFactor()
+{
+	using namespace crstl_unit;
+
+	crstl::open_hashmap<int, int> crHashmap;
+	crstl_check(crHashmap.bucket_count() == 0);
+	crstl_check(crHashmap.max_load_factor() == 0.75f);
+
+	crHashmap.max_load_factor(0.5f);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		crHashmap.insert(i, i);
+		crstl_check(crHashmap.load_factor() <= 0.5f);
+	}
+
+	crHashmap.max_load_factor(0.9f);
+	crHashmap.shrink_to_fit();
+	crstl_check(crHashmap.bucket_count() == 2048);
+	crstl_check(crHashmap.load_factor() <= 0.9f);
+
+	// Lowering the load factor grows on the next insert even if doubling is not enough
+	crHashmap.max_load_factor(0.2f);
+	crHashmap.insert(1000, 1000);
+	crstl_check(crHashmap.load_factor() <= 0.2f);
+
+	crHashmap.rehash(16384);
+	crstl_check(crHashmap.bucket_count() == 16384);
+
+	for (int i = 0; i <= 1000; ++i)
+	{
+		crstl_check(crHashmap.find(i)->second == i);
+	}
+
+	crstl::open_hashmap<int, int> crHashmapCopy = crHashmap;
+	crstl_check(crHashmapCopy.max_load_factor() == 0.2f);
+	crstl_check(crHashmapCopy.load_factor() <= 0.2f);
+	crstl_check(crHashmapCopy.size() == 1001);
+
+	crHashmap.clear();
+	crHashmap.shrink_to_fit();
+	crstl_check(crHashmap.bucket_count() == 0);
+	crstl_check(crHashmap.find(5) == crHashmap.end());
+	crHashmap.insert(5, 5);
+	crstl_check(crHashmap.find(5)->second == 5);
+}
+
+// Only has allocate and deallocate, so the hashmaps have to align their buckets themselves. Counts the bytes it hands
+// out so we can check they are all given back with the same sizes
+struct BasicAllocator
+{
+	typedef size_t size_type;
+
+	void* allocate(size_type size_bytes)
+	{
+		allocated_bytes += size_bytes;
+		return ::operator new(size_bytes);
+	}
+
+	void deallocate(void* p, size_type size_bytes)
+	{
+		allocated_bytes -= size_bytes;
+		::operator delete(p);
+	}
+
+	static size_t allocated_bytes;
+};
+
+size_t BasicAllocator::allocated_bytes = 0;
+
+template<typename Hashmap>
+void RunUnitTestHashmapAllocatorT()
+{
+	using namespace crstl_unit;
+
+	{
+		Hashmap crHashmap;
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			crHashmap.insert(i, i);
+		}
+
+		crstl_check(BasicAllocator::allocated_bytes > 0);
+
+		for (int i = 0; i < 1000; i += 2)
+		{
+			crHashmap.erase(i);
+		}
+
+		Hashmap crHashmapCopy(crHashmap);
+		crstl_check(crHashmapCopy.size() == 500 && crHashmapCopy.find(999)->second == 999);
+	}
+
+	crstl_check(BasicAllocator::allocated_bytes == 0);
+}
+
+void RunUnitTestIncrementalHashmap()
+{
+	using namespace crstl_unit;
+
+	crstl::open_incremental_hashmap<int, int> crHashmap;
+
+	bool sawRehashing = false;
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		crstl_check(crHashmap.insert(i, i).second);
+		sawRehashing |= crHashmap.is_rehashing();
+
+		// Keys that are still in the old table must be found and must not be inserted twice
+		crstl_check(!crHashmap.insert(i / 2, 0).second);
+		crstl_check(crHashmap.find(i / 2)->second == i / 2);
+	}
+
+	crstl_check(sawRehashing);
+	crstl_check(crHashmap.size() == 5000);
+
+	size_t iterCount = 0;
+	for (const auto& iter : crHashmap)
+	{
+		crstl_check(iter.first == iter.second);
+		iterCount++;
+	}
+
+	crstl_check(iterCount == 5000);
+
+	// Erasing through iterators can happen in the middle of a migration
+	for (auto iter = crHashmap.begin(); iter != crHashmap.end();)
+	{
+		iter = (iter->first % 3 == 0) ? crHashmap.erase(iter) : ++iter;
+	}
+
+	for (int i = 0; i < 5000; ++i)
+	{
+		crstl_check(crHashmap.count(i) == (i % 3 == 0 ? 0u : 1u));
+	}
+
+	crstl::open_incremental_hashmap<int, int> crHashmapCopy = crHashmap;
+	crstl_check(crHashmapCopy.size() == crHashmap.size());
+
+	crHashmap.clear();
+	crstl_check(crHashmap.empty());
+	crstl_check(!crHashmap.is_rehashing());
+
+	// Every key is in the same cluster, which is migrated over many operations. The keys that are still in the old
+	// table must stay reachable as the ones before them are migrated or erased. Keys below i / 2 have been erased
+	crstl::open_incremental_hashmap<int, int, ConstantHash> crClusterHashmap;
+	bool sawClusterRehashing = false;
+	bool foundAll = true;
+
+	for (int i = 0; i < 600; ++i)
+	{
+		crClusterHashmap.insert(i, i);
+		sawClusterRehashing |= crClusterHashmap.is_rehashing();
+
+		if (i % 2 == 1)
+		{
+			foundAll &= crClusterHashmap.erase(i / 2) == 1;
+		}
+
+		if (i % 50 == 49)
+		{
+			for (int j = 0; j <= i; ++j)
+			{
+				foundAll &= crClusterHashmap.count(j) == (j > i / 2 ? 1u : 0u);
+			}
+		}
+	}
+
+	crstl_check(sawClusterRehashing);
+	crstl_check(foundAll);
+	crstl_check(crClusterHashmap.size() == 300);
+}
+
+template<typename Hashmap>
+void RunUnitTestHashmapBatchT()
+{
+	using namespace crstl_unit;
+
+	Hashmap crHashmap;
+
+	crstl::pair<int, int> keyValues[40];
+	for (int i = 0; i < 40; ++i)
+	{
+		keyValues[i] = crstl::pair<int, int>(i * 7, i);
+	}
+
+	crHashmap.insert_batch(keyValues, 40);
+	crstl_check(crHashmap.size() == 40);
+
+	// Existing keys are not replaced
+	keyValues[3].second = 100;
+	crHashmap.insert_batch(keyValues, 4);
+	crstl_check(crHashmap.size() == 40);
+	crstl_check(crHashmap.find(21)->second == 3);
+
+	int keys[50];
+	for (int i = 0; i < 50; ++i)
+	{
+		keys[i] = i * 7;
+	}
+
+	typename Hashmap::iterator results[50];
+	crHashmap.find_batch(keys, 50, results);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		crstl_check(i < 40 ? results[i]->second == i : results[i] == crHashmap.end());
+	}
+
+	const Hashmap& crHashmapConst = crHashmap;
+	typename Hashmap::const_iterator constResults[50];
+	crHashmapConst.find_batch(keys, 50, constResults);
+	crstl_check(constResults[17]->second == 17);
+
+	crstl_check(crHashmap.count_batch(keys, 50) == 40);
+	crstl_check(crHashmap.count_batch(keys, 0) == 0);
+}
+
+void RunUnitTestHashmapHashed()
+{
+	using namespace crstl_unit;
+
+	crstl::open_hashmap<std::string, int> crHashmap1;
+	crstl::fixed_open_hashmap<std::string, int, 32> crHashmap2;
+
+	const std::string key = "a key that is hashed once";
+	const size_t hashValue = crHashmap1.hash_of(key);
+	crstl_check(hashValue == crHashmap2.hash_of(key));
+
+	crstl_check(crHashmap1.emplace_hashed(key, hashValue, 1).second);
+	crstl_check(!crHashmap1.emplace_hashed(key, hashValue, 2).second);
+	crstl_check(crHashmap2.emplace_hashed(key, hashValue, 3).second);
+
+	crstl_check(crHashmap1.find_hashed(key, hashValue)->second == 1);
+	crstl_check(crHashmap2.find_hashed(key, hashValue)->second == 3);
+	crstl_check(crHashmap1.find(key) == crHashmap1.find_hashed(key, hashValue));
+	crstl_check(crHashmap1.count_hashed(key, hashValue) == 1);
+
+	crstl_check(crHashmap1.erase_hashed(key, hashValue) == 1);
+	crstl_check(crHashmap1.erase_hashed(key, hashValue) == 0);
+	crstl_check(crHashmap1.count_hashed(key, hashValue) == 0);
+	crstl_check(crHashmap2.count(key) == 1);
+}
+
+// Look up string keys with other string types. Keys are longer than the small string buffer, so converting them
+// into a temporary key would allocate
+template<typename Hashmap>
+void RunUnitTestHashmapTransparentT()
+{
+	using namespace crstl_unit;
+
+	typedef typename Hashmap::key_type key_type;
+
+	const char* keyString = "a key that doesn't fit in the small string buffer";
+	const crstl::string_view keyView(keyString);
+	const crstl::fixed_string64 keyFixed(keyString);
+	const crstl::string keyDynamic(keyString);
+
+	crstl_check(Hashmap::hash_of(keyString) == Hashmap::hash_of(keyView));
+	crstl_check(Hashmap::hash_of(keyString) == Hashmap::hash_of(keyFixed));
+	crstl_check(Hashmap::hash_of(keyString) == Hashmap::hash_of(keyDynamic));
+
+	Hashmap crHashmap;
+	crHashmap.insert(key_type(keyString), 7);
+	crHashmap.insert(key_type("short"), 8);
+
+	crstl_check(crHashmap.find(keyString) != crHashmap.end());
+	crstl_check(crHashmap.find(keyView)->second == 7);
+	crstl_check(crHashmap.find(keyFixed)->second == 7);
+	crstl_check(crHashmap.find(keyDynamic)->second == 7);
+	crstl_check(crHashmap.find(crstl::string_view("shor")) == crHashmap.end());
+
+	crstl_check(crHashmap.count(keyView) == 1);
+	crstl_check(crHashmap.count(crstl::string_view("short")) == 1);
+
+	crstl_check(crHashmap.erase(keyView) == 1);
+	crstl_check(crHashmap.erase(keyString) == 0);
+	crstl_check(crHashmap.size() == 1);
+}
+
+void RunUnitTestConcurrentHashmap()
+{
+	using namespace crstl_unit;
+
+	crstl::concurrent_open_hashmap<int, int, crstl::hash<int>, crstl::allocator, 8> crHashmap;
+
+	crstl_check(crHashmap.empty());
+	crstl_check(crHashmap.insert(1, 10));
+	crstl_check(!crHashmap.insert(1, 11));
+	crstl_check(!crHashmap.insert_or_assign(1, 12));
+	crstl_check(crHashmap.insert_or_assign(2, 20));
+
+	int value = 0;
+	crstl_check(crHashmap.find_and_visit(1, [&value](const crstl::pair<int, int>& key_value) { value = key_value.second; }));
+	crstl_check(value == 12);
+	crstl_check(!crHashmap.find_and_visit(3, [&value](const crstl::pair<int, int>&) { value = -1; }));
+	crstl_check(value == 12);
+
+	crstl_check(crHashmap.erase(2) == 1);
+	crstl_check(crHashmap.erase(2) == 0);
+	crstl_check(crHashmap.size() == 1);
+
+	// Writers insert disjoint ranges while readers look up keys that may or may not be there yet
+	const int kThreadCount = 4;
+	const int kKeysPerThread = 5000;
+	crstl::thread_parameters params;
+	crstl::thread writers[kThreadCount];
+	crstl::thread readers[kThreadCount];
+	crstl::atomic<int32_t> foundCount;
+
+	for (int t = 0; t < kThreadCount; ++t)
+	{
+		writers[t] = crstl::thread(params, [&crHashmap, t]()
+		{
+			for (int i = 0; i < kKeysPerThread; ++i)
+			{
+				int key = 100 + t * kKeysPerThread + i;
+				crHashmap.insert_or_assign(key, key * 2);
+			}
+		});
+
+		readers[t] = crstl::thread(params, [&crHashmap, &foundCount, t]()
+		{
+			for (int i = 0; i < kKeysPerThread; ++i)
+			{
+				int key = 100 + ((t + 1) % kThreadCount) * kKeysPerThread + i;
+				bool correct = true;
+				crHashmap.find_and_visit(key, [key, &correct](const crstl::pair<int, int>& key_value) { correct = key_value.second == key * 2; });
+				if (correct)
+				{
+					++foundCount;
+				}
+			}
+		});
+	}
+
+	for (int t = 0; t < kThreadCount; ++t)
+	{
+		writers[t].join();
+		readers[t].join();
+	}
+
+	crstl_check(foundCount.load() == kThreadCount * kKeysPerThread);
+	crstl_check(crHashmap.size() == 1 + kThreadCount * kKeysPerThread);
+
+	size_t shardTotal = 0;
+	crHashmap.for_each_shard([&shardTotal](const crstl::open_hashmap<int, int>& shard)
+	{
+		crstl_check(shard.size() > 0);
+		shardTotal += shard.size();
+	});
+	crstl_check(shardTotal == crHashmap.size());
+
+	crHashmap.clear();
+	crstl_check(crHashmap.empty());
+
+	// Move-only values are moved in by both the insertion and the assignment
+	crstl::concurrent_open_hashmap<int, crstl::unique_ptr<int>, crstl::hash<int>, crstl::allocator, 8> crUniqueHashmap;
+	crstl_check(crUniqueHashmap.insert_or_assign(1, crstl::unique_ptr<int>(new int(10))));
+	crstl_check(!crUniqueHashmap.insert_or_assign(1, crstl::unique_ptr<int>(new int(11))));
+
+	value = 0;
+	crstl_check(crUniqueHashmap.find_and_visit(1, [&value](const crstl::pair<int, crstl::unique_ptr<int>>& key_value) { value = *key_value.second.get(); }));
+	crstl_check(value == 11);
+}
+
+void RunUnitTestSnapshotHashmap()
+{
+	using namespace crstl_unit;
+
+	typedef crstl::snapshot_hashmap<int, int, crstl::hash<int>, crstl::allocator, 8> SnapshotHashmap;
+
+	SnapshotHashmap crHashmap;
+
+	{
+		SnapshotHashmap::reader_type crReader(crHashmap);
+		crstl_check(crReader.lock().empty());
+		crReader.unlock();
+
+		SnapshotHashmap::table_type crTable;
+		crTable.insert(1, 10);
+		crHashmap.publish(crstl::move(crTable));
+
+		// A read in progress keeps the snapshot it started with, and keeps it from being freed
+		const SnapshotHashmap::table_type& crReadTable = crReader.lock();
+		crHashmap.update([](SnapshotHashmap::table_type& table) { table.insert(2, 20); });
+		crstl_check(crReadTable.size() == 1);
+		crstl_check(crHashmap.retired_count() >= 1);
+		crReader.unlock();
+
+		crHashmap.reclaim();
+		crstl_check(crHashmap.retired_count() == 0);
+
+		int value = 0;
+		crstl_check(crReader.find_and_visit(2, [&value](const crstl::pair<int, int>& key_value) { value = key_value.second; }));
+		crstl_check(value == 20);
+
+		// An acquired snapshot outlives its replacement
+		crstl::intrusive_ptr<SnapshotHashmap::snapshot_type> crSnapshot = crReader.acquire();
+		crHashmap.update([](SnapshotHashmap::table_type& table) { table.clear(); });
+		crstl_check(crHashmap.retired_count() == 0);
+		crstl_check(crSnapshot->table().size() == 2);
+		crstl_check(!crReader.find_and_visit(2, [](const crstl::pair<int, int>&) {}));
+	}
+
+	// Readers past MaxReaders get no slot and read under the writer lock
+	{
+		typedef crstl::snapshot_hashmap<int, int, crstl::hash<int>, crstl::allocator, 2> SmallSnapshotHashmap;
+		SmallSnapshotHashmap crSmallHashmap;
+		crSmallHashmap.update([](SmallSnapshotHashmap::table_type& table) { table.insert(1, 10); });
+
+		SmallSnapshotHashmap::reader_type crReader0(crSmallHashmap);
+		SmallSnapshotHashmap::reader_type crReader1(crSmallHashmap);
+		SmallSnapshotHashmap::reader_type crReader2(crSmallHashmap);
+		crstl_check(crReader0.is_lock_free() && crReader1.is_lock_free());
+		crstl_check(!crReader2.is_lock_free());
+
+		int value = 0;
+		crstl_check(crReader2.find_and_visit(1, [&value](const crstl::pair<int, int>& key_value) { value = key_value.second; }));
+		crstl_check(value == 10);
+
+		crstl::intrusive_ptr<SmallSnapshotHashmap::snapshot_type> crSnapshot = crReader2.acquire();
+		crSmallHashmap.update([](SmallSnapshotHashmap::table_type& table) { table.insert(2, 20); });
+		crstl_check(crSnapshot->table().size() == 1);
+		crstl_check(crReader2.lock().size() == 2);
+		crReader2.unlock();
+	}
+
+	// Readers check that every snapshot they see is complete while a writer keeps replacing it
+	const int kReaderCount = 4;
+	const int kVersionCount = 200;
+	crstl::thread_parameters params;
+	crstl::thread readers[kReaderCount];
+	crstl::atomic<int32_t> errorCount;
+
+	for (int t = 0; t < kReaderCount; ++t)
+	{
+		readers[t] = crstl::thread(params, [&crHashmap, &errorCount]()
+		{
+			SnapshotHashmap::reader_type crReader(crHashmap);
+			int lastVersion = 0;
+
+			while (lastVersion < kVersionCount)
+			{
+				const SnapshotHashmap::table_type& table = crReader.lock();
+
+				int version = table.empty() ? 0 : table.find(0)->second;
+
+				for (int i = 1; i < 64; ++i)
+				{
+					if (version != 0 && (table.find(i) == table.end() || table.find(i)->second != version))
+					{
+						++errorCount;
+					}
+				}
+
+				if (version < lastVersion)
+				{
+					++errorCount;
+				}
+
+				lastVersion = version;
+				crReader.unlock();
+			}
+		});
+	}
+
+	for (int version = 1; version <= kVersionCount; ++version)
+	{
+		SnapshotHashmap::table_type crTable;
+
+		for (int i = 0; i < 64; ++i)
+		{
+			crTable.insert(i, version);
+		}
+
+		crHashmap.publish(crstl::move(crTable));
+	}
+
+	for (int t = 0; t < kReaderCount; ++t)
+	{
+		readers[t].join();
+	}
+
+	crHashmap.reclaim();
+	crstl_check(errorCount.load() == 0);
+	crstl_check(crHashmap.retired_count() == 0);
+}
+
 void RunUnitTestsAssociative()
 {
 	printf("RunUnitTestsAssociative\n");
@@ -339,5 +1607,83 @@ void RunUnitTestsAssociative()
 	RunUnitTestHashmapT<crstl::open_hashmap<int, Example>>();
 	RunUnitTestHashmapT<crstl::fixed_open_hashmap<int, Example, 64>>();
 
+	RunUnitTestHashmapT<crstl::open_group_hashmap<int, Example>>();
+	RunUnitTestHashmapT<crstl::fixed_open_group_hashmap<int, Example, 64>>();
+
+	RunUnitTestHashmapT<crstl::open_robin_hashmap<int, Example>>();
+	RunUnitTestHashmapT<crstl::fixed_open_robin_hashmap<int, Example, 64>>();
+
 	RunUnitTestHashsetT<crstl::open_hashset<int>>();
+	RunUnitTestHashsetT<crstl::open_group_hashset<int>>();
+	RunUnitTestHashsetT<crstl::open_robin_hashset<int>>();
+
+	RunUnitTestHashmapRandomT<crstl::open_hashmap<int, int>>(2000, 20000);
+	RunUnitTestHashmapRandomT<crstl::open_group_hashmap<int, int>>(2000, 20000);
+	RunUnitTestHashmapRandomT<crstl::fixed_open_group_hashmap<int, int, 200>>(200, 20000);
+	RunUnitTestHashmapRandomT<crstl::open_robin_hashmap<int, int>>(2000, 20000);
+	RunUnitTestHashmapRandomT<crstl::fixed_open_robin_hashmap<int, int, 200>>(200, 20000);
+
+	RunUnitTestRobinHashmap();
+
+	RunUnitTestHashmapRandomT<crstl::open_dense_hashmap<int, int>>(2000, 20000);
+	RunUnitTestDenseHashmap();
+
+	RunUnitTestHashmapHighBitKeys();
+
+	RunUnitTestHashmapLoadFactor();
+
+	RunUnitTestHashmapAllocatorT<crstl::open_hashmap<int, int, crstl::hash<int>, BasicAllocator>>();
+	RunUnitTestHashmapAllocatorT<crstl::open_group_hashmap<int, int, crstl::hash<int>, BasicAllocator>>();
+	RunUnitTestHashmapAllocatorT<crstl::open_robin_hashmap<int, int, crstl::hash<int>, BasicAllocator>>();
+	RunUnitTestHashmapAllocatorT<crstl::open_dense_hashmap<int, int, crstl::hash<int>, BasicAllocator>>();
+
+	RunUnitTestHashmapEraseIfT<crstl::open_hashmap<int, int>>(5000);
+	RunUnitTestHashmapEraseIfT<crstl::fixed_open_hashmap<int, int, 256>>(200);
+	RunUnitTestHashmapEraseIf();
+
+	RunUnitTestHashmapBuildParallel();
+
+	{
+		crstl::fixed_lru_cache<int, crstl::string, 4> crFixedCache;
+		RunUnitTestLruCacheT(crFixedCache);
+
+		crstl::lru_cache<int, crstl::string> crCache(4);
+		RunUnitTestLruCacheT(crCache);
+
+		// The evict function can move the key out, it is already erased from the hashmap. The keys are long enough to
+		// live on the heap
+		crstl::fixed_lru_cache<crstl::string, int, 2> crStringCache;
+		crstl::vector<crstl::string> evictedKeys;
+		crStringCache.set_evict_function([&evictedKeys](crstl::pair<crstl::string, int>& keyValue) { evictedKeys.push_back(crstl_move(keyValue.first)); });
+
+		for (int i = 0; i < 10; ++i)
+		{
+			crStringCache.put(crstl::string("a key that does not fit inline ") + crstl::string(1, (char)('0' + i)), i);
+		}
+
+		crstl_check(crStringCache.size() == 2 && evictedKeys.size() == 8);
+		crstl_check(evictedKeys[7] == "a key that does not fit inline 7");
+		crstl_check(*crStringCache.get(crstl::string("a key that does not fit inline 8")) == 8);
+		crstl_check(*crStringCache.get(crstl::string("a key that does not fit inline 9")) == 9);
+		crstl_check(crStringCache.count(crstl::string("a key that does not fit inline 7")) == 0);
+	}
+
+	RunUnitTestFixedHashmapSave();
+
+	RunUnitTestConstexprHashmap();
+
+	RunUnitTestHashmapBatchT<crstl::open_hashmap<int, int>>();
+	RunUnitTestHashmapBatchT<crstl::fixed_open_hashmap<int, int, 64>>();
+
+	RunUnitTestHashmapHashed();
+
+	RunUnitTestHashmapTransparentT<crstl::open_hashmap<crstl::string, int>>();
+	RunUnitTestHashmapTransparentT<crstl::fixed_open_hashmap<crstl::fixed_string64, int, 16>>();
+
+	RunUnitTestHashmapRandomT<crstl::open_incremental_hashmap<int, int>>(2000, 20000);
+	RunUnitTestIncrementalHashmap();
+
+	RunUnitTestConcurrentHashmap();
+
+	RunUnitTestSnapshotHashmap();
 }
\ No newline at end of file
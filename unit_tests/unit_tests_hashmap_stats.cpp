@@ -0,0 +1,217 @@
+// Stats change the layout of the hashmaps, so they are enabled for this file only and every hashmap here uses a hasher
+// that no other file sees
+#define CRSTL_HASHMAP_STATS
+
+#include "unit_tests.h"
+
+#if !defined(CRSTL_UNIT_MODULES)
+
+#include "crstl/fixed_open_hashmap.h"
+#include "crstl/open_hashmap.h"
+#include "crstl/thread.h"
+
+#include <string.h>
+
+namespace
+{
+	// Every key lands in the same bucket, so probe lengths are easy to predict
+	struct SingleBucketHash
+	{
+		size_t operator()(int) const { return 0; }
+	};
+
+	struct StatsHash
+	{
+		size_t operator()(int key) const { return (size_t)key * 0x9e3779b97f4a7c15ull; }
+	};
+
+	struct StatsMemoryFile
+	{
+		StatsMemoryFile(char* data, size_t capacity) : data(data), capacity(capacity), size(0) {}
+
+		size_t write(const void* source, size_t bytes)
+		{
+			size_t written = bytes < capacity - size ? bytes : capacity - size;
+			memcpy(data + size, source, written);
+			size += written;
+			return written;
+		}
+
+		char* data;
+
+		size_t capacity;
+
+		size_t size;
+	};
+}
+
+void RunUnitTestsHashmapStats()
+{
+	using namespace crstl_unit;
+
+	// Probe lengths and clusters
+	{
+		crstl::fixed_open_hashmap<int, int, 16, SingleBucketHash> crHashmap;
+
+		for (int i = 0; i < 4; ++i)
+		{
+			crHashmap.insert(i, i);
+		}
+
+		crstl::hashmap_stats stats = crHashmap.get_stats();
+		crstl_check(stats.insert_count == 4);
+		crstl_check(stats.insert_probe_max == 3);
+		crstl_check(stats.insert_probe_total == 0 + 1 + 2 + 3);
+		crstl_check(stats.insert_probe_histogram[0] == 1 && stats.insert_probe_histogram[3] == 1);
+		crstl_check(stats.length == 4);
+		crstl_check(stats.bucket_count == 16);
+		crstl_check(stats.load_factor == 0.25f);
+		crstl_check(stats.cluster_count == 1);
+		crstl_check(stats.cluster_max == 4);
+		crstl_check(stats.cluster_mean == 4.0f);
+
+		// Inserting a key that exists walks up to it
+		crHashmap.insert(2, 2);
+		crstl_check(crHashmap.get_stats().insert_count == 5);
+		crstl_check(crHashmap.get_stats().insert_probe_histogram[2] == 2);
+
+		crHashmap.reset_stats();
+
+		crstl_check(crHashmap.find(0) != crHashmap.end());
+		crstl_check(crHashmap.find(3) != crHashmap.end());
+		crstl_check(crHashmap.find(10) == crHashmap.end());
+		crstl_check(crHashmap.count(1) == 1); // Counting walks to the end of the cluster
+
+		stats = crHashmap.get_stats();
+		crstl_check(stats.insert_count == 0);
+		crstl_check(stats.find_count == 4);
+		crstl_check(stats.find_miss_count == 1);
+		crstl_check(stats.find_probe_histogram[0] == 1);
+		crstl_check(stats.find_probe_histogram[3] == 1);
+		crstl_check(stats.find_probe_histogram[4] == 2);
+		crstl_check(stats.find_probe_max == 4);
+
+		// Erasing the first key shifts the other three back
+		crHashmap.erase(0);
+		stats = crHashmap.get_stats();
+		crstl_check(stats.erase_count == 1);
+		crstl_check(stats.erase_shift_count == 3);
+		crstl_check(stats.cluster_max == 3);
+
+		// The values can be listed without knowing their names
+		size_t value_count = 0;
+		double find_count = 0.0;
+
+		stats.for_each_value([&](const char* name, size_t index, double value)
+		{
+			value_count++;
+
+			if (name[0] == 'f' && name[5] == 'c' && index == 0)
+			{
+				find_count = value;
+			}
+		});
+
+		crstl_check(value_count == 17 + 2 * crstl::hashmap_stats::kProbeHistogramSize);
+		crstl_check(find_count == 4.0);
+	}
+
+	// Rehashing
+	{
+		crstl::open_hashmap<int, int, StatsHash> crHashmap;
+
+		for (int i = 0; i < 1000; ++i)
+		{
+			crHashmap.insert(i, i);
+		}
+
+		crstl::hashmap_stats stats = crHashmap.get_stats();
+		crstl_check(stats.insert_count == 1000);
+		crstl_check(stats.rehash_count > 0);
+		crstl_check(stats.rehash_bytes_moved > 0);
+		crstl_check(stats.rehash_bytes_moved < 1000 * stats.rehash_count * sizeof(crstl::pair<int, int>));
+		crstl_check(stats.length == 1000);
+		crstl_check(stats.load_factor > 0.0f && stats.load_factor <= 1.0f);
+		crstl_check(stats.cluster_count > 0);
+
+		uint64_t histogram_total = 0;
+
+		for (size_t i = 0; i < crstl::hashmap_stats::kProbeHistogramSize; ++i)
+		{
+			histogram_total += stats.insert_probe_histogram[i];
+		}
+
+		crstl_check(histogram_total == stats.insert_count);
+	}
+
+	// Lookups from several threads at once all get counted
+	{
+		crstl::open_hashmap<int, int, StatsHash> crHashmap;
+
+		for (int i = 0; i < 100; ++i)
+		{
+			crHashmap.insert(i, i);
+		}
+
+		crHashmap.reset_stats();
+
+		const crstl::open_hashmap<int, int, StatsHash>& crConstHashmap = crHashmap;
+		const int kThreadCount = 4;
+		const int kFindsPerThread = 10000;
+		crstl::thread_parameters params;
+		crstl::thread threads[kThreadCount];
+
+		for (int t = 0; t < kThreadCount; ++t)
+		{
+			threads[t] = crstl::thread(params, [&crConstHashmap]()
+			{
+				for (int i = 0; i < kFindsPerThread; ++i)
+				{
+					(void)crConstHashmap.find(i % 200);
+				}
+			});
+		}
+
+		for (int t = 0; t < kThreadCount; ++t)
+		{
+			threads[t].join();
+		}
+
+		crstl::hashmap_stats stats = crHashmap.get_stats();
+		crstl_check(stats.find_count == (uint64_t)(kThreadCount * kFindsPerThread));
+		crstl_check(stats.find_miss_count == (uint64_t)(kThreadCount * kFindsPerThread / 2));
+	}
+
+	// A table viewed from saved memory doesn't write its stats, the memory could be read only
+	{
+		typedef crstl::fixed_open_hashmap<int, int, 64, StatsHash> FixedHashmap;
+
+		FixedHashmap crHashmap;
+
+		for (int i = 0; i < 40; ++i)
+		{
+			crHashmap.insert(i, i);
+		}
+
+		(void)crHashmap.find(3);
+
+		crstl_alignas(64) char buffer[FixedHashmap::saved_size()];
+		crstl_alignas(64) char bufferCopy[FixedHashmap::saved_size()];
+		StatsMemoryFile memoryFile(buffer, sizeof(buffer));
+		crstl_check(crHashmap.save(memoryFile));
+		memcpy(bufferCopy, buffer, sizeof(buffer));
+
+		const FixedHashmap::fixed_open_hashtable* crView = FixedHashmap::view_from_memory(buffer, memoryFile.size);
+		crstl_check(crView != nullptr);
+		crstl_check(crView->find(7)->second == 7);
+		crstl_check(crView->count(100) == 0);
+		crstl_check(crView->get_stats().find_count == 0);
+		crstl_check(memcmp(buffer, bufferCopy, sizeof(buffer)) == 0);
+	}
+}
+
+#else
+
+void RunUnitTestsHashmapStats() {}
+
+#endif
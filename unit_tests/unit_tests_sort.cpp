@@ -0,0 +1,594 @@
+#include "unit_tests.h"
+
+#if defined(CRSTL_UNIT_MODULES)
+import crstl;
+#else
+#include "crstl/array.h"
+#include "crstl/fixed_vector.h"
+#include "crstl/parallel_sort.h"
+#include "crstl/sort.h"
+#include "crstl/string_sort.h"
+#endif
+
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+
+namespace
+{
+	enum SortPattern
+	{
+		SortPatternRandom,
+		SortPatternSorted,
+		SortPatternReversed,
+		SortPatternFewUnique,
+		SortPatternOrganPipe,
+		SortPatternSawtooth,
+		SortPatternCount
+	};
+
+	void FillSortPattern(std::vector<int>& values, size_t size, SortPattern pattern)
+	{
+		values.resize(size);
+
+		uint32_t seed = 12345;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+
+			switch (pattern)
+			{
+				case SortPatternRandom:    values[i] = (int)(seed >> 1); break;
+				case SortPatternSorted:    values[i] = (int)i; break;
+				case SortPatternReversed:  values[i] = (int)(size - i); break;
+				case SortPatternFewUnique: values[i] = (int)((seed >> 16) % 4); break;
+				case SortPatternOrganPipe: values[i] = (int)(i < size / 2 ? i : size - i); break;
+				case SortPatternSawtooth:  values[i] = (int)(i % 64); break;
+				default: break;
+			}
+		}
+	}
+
+	struct CountingLess
+	{
+		CountingLess(size_t* count) : count(count) {}
+
+		bool operator()(int a, int b) const
+		{
+			(*count)++;
+			return a < b;
+		}
+
+		size_t* count;
+	};
+
+	// McIlroy's adversary: values start out undecided, and are decided as the sort compares them in a way that makes
+	// its pivots as bad as possible
+	struct AdversaryLess
+	{
+		bool operator()(int x, int y) const
+		{
+			(*count)++;
+
+			if (values[x] == gas && values[y] == gas)
+			{
+				values[x == *candidate ? x : y] = (*solid_count)++;
+			}
+
+			if (values[x] == gas)
+			{
+				*candidate = x;
+			}
+			else if (values[y] == gas)
+			{
+				*candidate = y;
+			}
+
+			return values[x] < values[y];
+		}
+
+		int* values;
+		int gas;
+		int* solid_count;
+		int* candidate;
+		size_t* count;
+	};
+
+	struct SortRecord
+	{
+		uint64_t id;
+		int32_t score;
+		float weight;
+		char payload[48];
+	};
+
+	// Strings that share long prefixes, some short enough to be small strings and some on the heap. Characters above
+	// 127 check that the order matches comparing the strings, where char is usually signed
+	void FillSortStrings(std::vector<crstl::string>& strings, size_t size)
+	{
+		const char* prefixes[] = { "", "a", "ab", "common/prefix/", "common/prefix/that/is/long/enough/for/the/heap/" };
+
+		uint32_t seed = 777;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+
+			crstl::string string = prefixes[(seed >> 8) % 5];
+			const size_t suffix_length = (seed >> 16) % 6;
+
+			for (size_t c = 0; c < suffix_length; ++c)
+			{
+				seed = seed * 1664525u + 1013904223u;
+				const uint32_t r = (seed >> 24) % 8;
+				string += (char)(r == 7 ? 0xe9 : 'a' + r);
+			}
+
+			strings.push_back(string);
+		}
+	}
+
+	// Spread the pattern over the range of each type, with negative values for the signed ones
+	template<typename T> T SortSmallValue(int value);
+	template<> int32_t SortSmallValue<int32_t>(int value) { return value - 0x40000000; }
+	template<> uint32_t SortSmallValue<uint32_t>(int value) { return (uint32_t)value * 2u + 1u; }
+	template<> float SortSmallValue<float>(int value) { return (float)(value - 0x40000000) / 1024.0f; }
+	template<> int64_t SortSmallValue<int64_t>(int value) { return ((int64_t)value - 0x40000000) * 0x100000001ll; }
+	template<> double SortSmallValue<double>(int value) { return (double)value / 3.0; }
+
+	// Sorts the first size of 64 values, and checks that the ones after them were left alone
+	template<typename T>
+	bool SortSmallMatches(size_t size, SortPattern pattern)
+	{
+		std::vector<int> pattern_values;
+		FillSortPattern(pattern_values, 64, pattern);
+
+		std::vector<T> values;
+
+		for (int value : pattern_values)
+		{
+			values.push_back(SortSmallValue<T>(value));
+		}
+
+		std::vector<T> expected = values;
+		std::sort(expected.begin(), expected.begin() + size);
+
+		crstl::sort_small<64>(values.data(), values.data() + size);
+
+		return values == expected;
+	}
+
+	template<typename T>
+	bool QuickSortMatches(size_t size, SortPattern pattern)
+	{
+		std::vector<int> pattern_values;
+		FillSortPattern(pattern_values, size, pattern);
+
+		std::vector<T> values;
+
+		for (int value : pattern_values)
+		{
+			values.push_back(SortSmallValue<T>(value));
+		}
+
+		std::vector<T> expected = values;
+		std::sort(expected.begin(), expected.end());
+
+		crstl::quick_sort(values.data(), values.data() + size);
+
+		return values == expected;
+	}
+}
+
+void RunUnitTestsSort()
+{
+	using namespace crstl_unit;
+
+	begin_test("quick_sort");
+	{
+		const size_t sizes[] = { 0, 1, 2, 3, 8, 31, 32, 33, 100, 129, 1000, 100000 };
+
+		for (size_t size : sizes)
+		{
+			for (int pattern = 0; pattern < SortPatternCount; ++pattern)
+			{
+				std::vector<int> values;
+				FillSortPattern(values, size, (SortPattern)pattern);
+
+				std::vector<int> expected = values;
+				std::sort(expected.begin(), expected.end());
+
+				std::vector<int> quick_sorted = values;
+				crstl::quick_sort(quick_sorted.data(), quick_sorted.data() + size);
+				crstl_check(quick_sorted == expected);
+
+				std::vector<int> heap_sorted = values;
+				crstl::heap_sort(heap_sorted.data(), heap_sorted.data() + size);
+				crstl_check(heap_sorted == expected);
+
+				// Patterns that go quadratic with a fixed pivot stay close to n log n
+				size_t comparison_count = 0;
+				std::vector<int> counted_sorted = values;
+				crstl::quick_sort(counted_sorted.data(), counted_sorted.data() + size, CountingLess(&comparison_count));
+				crstl_check(counted_sorted == expected);
+				crstl_check(comparison_count <= 4 * size * 17 + 1024);
+			}
+		}
+	}
+
+	begin_test("quick_sort adversary");
+	{
+		const int size = 100000;
+
+		std::vector<int> values(size, size);
+		std::vector<int> indices(size);
+
+		for (int i = 0; i < size; ++i)
+		{
+			indices[i] = i;
+		}
+
+		int solid_count = 0;
+		int candidate = 0;
+		size_t comparison_count = 0;
+
+		AdversaryLess adversary = { values.data(), size, &solid_count, &candidate, &comparison_count };
+		crstl::quick_sort(indices.data(), indices.data() + size, adversary);
+
+		bool is_sorted = true;
+
+		for (int i = 1; i < size; ++i)
+		{
+			is_sorted &= values[indices[i - 1]] <= values[indices[i]];
+		}
+
+		crstl_check(is_sorted);
+		crstl_check(comparison_count < (size_t)size * 17 * 4);
+	}
+
+	// Moving from an element leaves it with a different value, which catches elements that are read after being moved
+	begin_test("quick_sort non-trivial");
+	{
+		const size_t sizes[] = { 10, 200, 5000 };
+
+		for (size_t size : sizes)
+		{
+			for (int pattern = 0; pattern < SortPatternCount; ++pattern)
+			{
+				std::vector<int> values;
+				FillSortPattern(values, size, (SortPattern)pattern);
+
+				std::vector<Example> examples;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					examples.push_back(Example(values[i] % 10000, (float)i));
+				}
+
+				crstl::quick_sort(examples.data(), examples.data() + size, [](const Example& a, const Example& b) { return a.a < b.a; });
+
+				std::sort(values.begin(), values.end(), [](int a, int b) { return a % 10000 < b % 10000; });
+
+				bool is_sorted = true;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					is_sorted &= examples[i].a == values[i] % 10000;
+				}
+
+				crstl_check(is_sorted);
+
+				std::vector<Example> inserted = examples;
+				std::reverse(inserted.begin(), inserted.end());
+				crstl::insertion_sort(inserted.data(), inserted.data() + size, [](const Example& a, const Example& b) { return a.a < b.a; });
+
+				bool is_insertion_sorted = true;
+
+				for (size_t i = 0; i < size; ++i)
+				{
+					is_insertion_sorted &= inserted[i].a == examples[i].a;
+				}
+
+				crstl_check(is_insertion_sorted);
+			}
+		}
+	}
+
+	// Sorting networks, for the platforms that have them
+	begin_test("sort_small");
+	{
+		for (size_t size = 0; size <= 64; ++size)
+		{
+			for (int pattern = 0; pattern < SortPatternCount; ++pattern)
+			{
+				crstl_check(SortSmallMatches<int32_t>(size, (SortPattern)pattern));
+				crstl_check(SortSmallMatches<uint32_t>(size, (SortPattern)pattern));
+				crstl_check(SortSmallMatches<float>(size, (SortPattern)pattern));
+				crstl_check(SortSmallMatches<int64_t>(size, (SortPattern)pattern));
+				crstl_check(SortSmallMatches<double>(size, (SortPattern)pattern));
+			}
+		}
+
+		const size_t sizes[] = { 33, 100, 1000 };
+
+		for (size_t size : sizes)
+		{
+			for (int pattern = 0; pattern < SortPatternCount; ++pattern)
+			{
+				crstl_check(QuickSortMatches<uint32_t>(size, (SortPattern)pattern));
+				crstl_check(QuickSortMatches<float>(size, (SortPattern)pattern));
+				crstl_check(QuickSortMatches<int64_t>(size, (SortPattern)pattern));
+			}
+		}
+
+		crstl::array<int32_t, 16> array_values = { 5, -3, 12, 0, 7, -3, 100, 42, -50, 8, 8, 1, 2, 99, -1, 6 };
+		crstl::sort_small(array_values);
+		crstl_check(std::is_sorted(array_values.begin(), array_values.end()));
+		crstl_check(array_values[0] == -50 && array_values[15] == 100);
+
+		crstl::array<int64_t, 12> array_values_12 = { 5, -3, 12, 0, 7, -3, 100, 42, -50, 8, 8, 1 };
+		crstl::sort_small(array_values_12);
+		crstl_check(std::is_sorted(array_values_12.begin(), array_values_12.end()));
+
+		crstl::fixed_vector<float, 40> vector_values;
+
+		for (int i = 0; i < 21; ++i)
+		{
+			vector_values.push_back((float)((i * 37) % 23) - 11.5f);
+		}
+
+		crstl::sort_small(vector_values);
+		crstl_check(vector_values.size() == 21);
+		crstl_check(std::is_sorted(vector_values.begin(), vector_values.end()));
+		crstl_check(vector_values[0] == -11.5f && vector_values[20] == 10.5f);
+	}
+
+	begin_test("parallel_sort");
+	{
+		const size_t size = 300000;
+
+		for (int pattern = 0; pattern < SortPatternCount; ++pattern)
+		{
+			std::vector<int> values;
+			FillSortPattern(values, size, (SortPattern)pattern);
+
+			std::vector<int> expected = values;
+			std::sort(expected.begin(), expected.end());
+
+			std::vector<int> temp_buffer(size);
+
+			std::vector<int> parallel_sorted = values;
+			crstl::parallel_sort(parallel_sorted.data(), parallel_sorted.data() + size, temp_buffer.data(), 4);
+			crstl_check(parallel_sorted == expected);
+
+			std::vector<int> greater_sorted = values;
+			crstl::parallel_sort(greater_sorted.data(), greater_sorted.data() + size, [](int a, int b) { return a > b; }, temp_buffer.data(), 3);
+			std::reverse(greater_sorted.begin(), greater_sorted.end());
+			crstl_check(greater_sorted == expected);
+
+			// Values are positive, so they sort the same as unsigned integers
+			std::vector<uint32_t> radix_values(values.begin(), values.end());
+			std::vector<uint32_t> radix_temp_buffer(size);
+			crstl::parallel_radix_sort(radix_values.data(), radix_values.data() + size, radix_temp_buffer.data(), 4);
+			crstl_check(radix_values == std::vector<uint32_t>(expected.begin(), expected.end()));
+		}
+
+		// Too small to use threads
+		std::vector<int> small_values;
+		FillSortPattern(small_values, 1000, SortPatternRandom);
+		std::vector<int> small_expected = small_values;
+		std::sort(small_expected.begin(), small_expected.end());
+		crstl::parallel_sort(small_values.data(), small_values.data() + small_values.size(), (int*)nullptr, 8);
+		crstl_check(small_values == small_expected);
+
+		std::vector<double> double_values(size);
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			double_values[i] = (double)((int)(i * 7919 % size) - (int)(size / 2)) * 0.25;
+		}
+
+		std::vector<double> double_expected = double_values;
+		std::sort(double_expected.begin(), double_expected.end());
+		std::vector<double> double_temp_buffer(size);
+		crstl::parallel_radix_sort(double_values.data(), double_values.data() + size, double_temp_buffer.data(), 8);
+		crstl_check(double_values == double_expected);
+
+		// Sorting from a thread with the default stack size, with the counts on its stack and with counts we pass in
+		{
+			std::vector<uint32_t> thread_values(size);
+			std::vector<uint32_t> thread_counted_values(size);
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				thread_values[i] = (uint32_t)(i * 7919 % size);
+				thread_counted_values[i] = thread_values[i];
+			}
+
+			std::vector<uint32_t> thread_temp_buffer(size);
+			std::vector<uint32_t> count_buffer(crstl::parallel_radix_sort_count_size(8));
+
+			crstl::thread_parameters params;
+			crstl::thread sort_thread(params, [&]()
+			{
+				crstl::parallel_radix_sort(thread_values.data(), thread_values.data() + size, thread_temp_buffer.data(), 8);
+				crstl::parallel_radix_sort(thread_counted_values.data(), thread_counted_values.data() + size, thread_temp_buffer.data(), count_buffer.data(), 8);
+			});
+			sort_thread.join();
+
+			bool is_sequence = true;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				is_sequence &= thread_values[i] == (uint32_t)i && thread_counted_values[i] == (uint32_t)i;
+			}
+
+			crstl_check(is_sequence);
+		}
+
+		std::vector<int> example_values;
+		FillSortPattern(example_values, size, SortPatternRandom);
+
+		std::vector<Example> examples;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			examples.push_back(Example(example_values[i] % 1000, (float)i));
+		}
+
+		std::vector<Example> example_temp_buffer(size);
+		crstl::parallel_sort(examples.data(), examples.data() + size, [](const Example& a, const Example& b) { return a.a < b.a; }, example_temp_buffer.data(), 4);
+
+		bool is_sorted = true;
+
+		for (size_t i = 1; i < size; ++i)
+		{
+			is_sorted &= examples[i - 1].a <= examples[i].a && examples[i].a != 10000;
+		}
+
+		crstl_check(is_sorted);
+	}
+
+	begin_test("radix_sort");
+	{
+		const size_t size = 20000;
+
+		std::vector<int> values;
+		FillSortPattern(values, size, SortPatternRandom);
+
+		std::vector<int32_t> signed_values(size);
+		std::vector<int8_t> byte_values(size);
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			signed_values[i] = values[i] - 0x40000000;
+			byte_values[i] = (int8_t)values[i];
+		}
+
+		std::vector<int32_t> signed_expected = signed_values;
+		std::sort(signed_expected.begin(), signed_expected.end());
+		crstl::radix_sort(signed_values.data(), signed_values.data() + size);
+		crstl_check(signed_values == signed_expected);
+
+		std::vector<int8_t> byte_expected = byte_values;
+		std::sort(byte_expected.begin(), byte_expected.end());
+		crstl::radix_sort(byte_values.data(), byte_values.data() + size);
+		crstl_check(byte_values == byte_expected);
+
+		// Few unique scores, so the records that share a score show whether the order was kept
+		std::vector<SortRecord> records(size);
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			records[i].id = i;
+			records[i].score = (values[i] % 64) - 32;
+			records[i].weight = (float)((values[i] % 1000) - 500) * 0.5f;
+			records[i].payload[0] = (char)i;
+		}
+
+		std::vector<SortRecord> by_score = records;
+		std::vector<SortRecord> record_temp_buffer(size);
+		crstl::radix_sort_by(by_score.data(), by_score.data() + size, [](const SortRecord& record) { return record.score; }, record_temp_buffer.data());
+
+		bool is_stable_sorted = true;
+
+		for (size_t i = 1; i < size; ++i)
+		{
+			const SortRecord& previous = by_score[i - 1];
+			const SortRecord& current = by_score[i];
+			is_stable_sorted &= previous.score < current.score || (previous.score == current.score && previous.id < current.id);
+			is_stable_sorted &= current.payload[0] == (char)current.id;
+		}
+
+		crstl_check(is_stable_sorted);
+
+		std::vector<SortRecord> by_weight = records;
+		crstl::radix_sort_by(by_weight.data(), by_weight.data() + size, [](const SortRecord& record) -> const float& { return record.weight; });
+
+		bool is_weight_sorted = true;
+
+		for (size_t i = 1; i < size; ++i)
+		{
+			is_weight_sorted &= by_weight[i - 1].weight <= by_weight[i].weight;
+		}
+
+		crstl_check(is_weight_sorted);
+
+		// Indices sort the same way, without moving the records
+		std::vector<uint32_t> indices(size);
+		std::vector<uint32_t> index_temp_buffer(size);
+		crstl::radix_sort_indices(records.data(), records.data() + size, [](const SortRecord& record) { return record.score; }, indices.data(), index_temp_buffer.data());
+
+		bool is_same_order = true;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			is_same_order &= records[indices[i]].id == by_score[i].id && records[i].id == i;
+		}
+
+		crstl_check(is_same_order);
+
+		crstl::radix_sort_indices(records.data(), records.data() + size, [](const SortRecord& record) { return record.id; }, indices.data());
+
+		bool is_identity = true;
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			is_identity &= indices[i] == i;
+		}
+
+		crstl_check(is_identity);
+	}
+
+	begin_test("string_sort");
+	{
+		const size_t sizes[] = { 0, 1, 16, 17, 5000 };
+
+		for (size_t size : sizes)
+		{
+			std::vector<crstl::string> strings;
+			FillSortStrings(strings, size);
+
+			std::vector<crstl::string> expected = strings;
+			crstl::quick_sort(expected.data(), expected.data() + size);
+
+			// Views point into strings that aren't sorted, as sorting moves small strings
+			const std::vector<crstl::string> view_strings = strings;
+
+			std::vector<crstl::fixed_string64> fixed_strings;
+			std::vector<crstl::string_view> string_views;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				fixed_strings.push_back(crstl::fixed_string64(strings[i].data(), strings[i].length()));
+				string_views.push_back(crstl::string_view(view_strings[i].data(), view_strings[i].length()));
+			}
+
+			crstl::string_sort(strings.data(), strings.data() + size);
+			crstl::string_sort(fixed_strings.data(), fixed_strings.data() + size);
+			crstl::string_sort(string_views.data(), string_views.data() + size);
+
+			bool is_sorted = true;
+
+			for (size_t i = 0; i < size; ++i)
+			{
+				is_sorted &= strings[i] == expected[i];
+				is_sorted &= strings[i].compare(fixed_strings[i].c_str()) == 0;
+				is_sorted &= crstl::string(string_views[i].data(), string_views[i].length()) == expected[i];
+			}
+
+			crstl_check(is_sorted);
+		}
+
+		std::vector<crstl::wstring> wide_strings;
+		wide_strings.push_back(L"zeta");
+		wide_strings.push_back(L"alpha");
+		wide_strings.push_back(L"alphabet");
+		wide_strings.push_back(L"");
+		wide_strings.push_back(L"alp");
+		crstl::string_sort(wide_strings.data(), wide_strings.data() + wide_strings.size());
+		crstl_check(wide_strings[0].empty() && wide_strings[1] == L"alp" && wide_strings[2] == L"alpha" && wide_strings[3] == L"alphabet" && wide_strings[4] == L"zeta");
+	}
+	end_test();
+}
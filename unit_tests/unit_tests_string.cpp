@@ -496,6 +496,57 @@ void RunUnitTestsString()
 	}
 	end_test();
 
+	//-----
+	// hash
+	//-----
+
+	begin_test("hash");
+	{
+		// Every length goes through a different path: short reads, 16 byte steps and 48 byte steps
+		const char* HashString = "A string long enough to exercise every length the hash handles separately, including the wide loop";
+		crstl::string crHashString = HashString;
+
+		for (size_t i = 0; i <= crHashString.length(); ++i)
+		{
+			crstl::string_view crHashStringView(HashString, i);
+			crstl::fixed_string128 crHashFixedString(HashString, i);
+			crstl::string crHashSubstring(HashString, i);
+
+			size_t hashValue = crstl::hash<crstl::string_view>()(crHashStringView);
+			crstl_check(hashValue == crstl::hash<crstl::fixed_string128>()(crHashFixedString));
+			crstl_check(hashValue == crstl::hash<crstl::string>()(crHashSubstring));
+
+			// Changing the last character changes the hash
+			if (i > 0)
+			{
+				crHashSubstring[i - 1] = '#';
+				crstl_check(hashValue != crstl::hash<crstl::string>()(crHashSubstring));
+			}
+		}
+
+		// Known answers from the reference wyhash with a seed of 0 and the default secrets, for prefixes of the same
+		// string. Each length is a boundary between two of the paths
+		const char* ReferenceString = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ!@#$%^&*()-_=+[]{};:,.<>/?|~`0123456789abcdefghijklmnopqrstuvwxyz";
+		crstl_check(crstl::string_hash(ReferenceString, 0) == (size_t)0x93228a4de0eec5a2ull);
+		crstl_check(crstl::string_hash(ReferenceString, 1) == (size_t)0x670cb892bc405352ull);
+		crstl_check(crstl::string_hash(ReferenceString, 3) == (size_t)0xe4e8c2883f22092dull);
+		crstl_check(crstl::string_hash(ReferenceString, 4) == (size_t)0x85d746649d40bdc8ull);
+		crstl_check(crstl::string_hash(ReferenceString, 8) == (size_t)0xeb99787ced7aee4bull);
+		crstl_check(crstl::string_hash(ReferenceString, 16) == (size_t)0x88de385a856cfb95ull);
+		crstl_check(crstl::string_hash(ReferenceString, 17) == (size_t)0x14f37288a5f8073aull);
+		crstl_check(crstl::string_hash(ReferenceString, 32) == (size_t)0x9411320aae4a7975ull);
+		crstl_check(crstl::string_hash(ReferenceString, 48) == (size_t)0x29b3b1a2cd889e34ull);
+		crstl_check(crstl::string_hash(ReferenceString, 49) == (size_t)0xf254bb65043d4692ull);
+		crstl_check(crstl::string_hash(ReferenceString, 96) == (size_t)0x749b27f593207c94ull);
+		crstl_check(crstl::string_hash(ReferenceString, 97) == (size_t)0xbba6a65a482b59ebull);
+		crstl_check(crstl::string_hash(ReferenceString, 100) == (size_t)0xb2990eb72a48ea18ull);
+
+#if CRSTL_CPPVERSION >= CRSTL_CPP14
+		static_assert(crstl::string_hash("constexpr hash", 14) == (size_t)0x005c7c90e1f22417ull, "");
+#endif
+	}
+	end_test();
+
 	// Unicode decoding
 
 #if defined(CRSTL_UNIT_UNICODE_LITERALS)